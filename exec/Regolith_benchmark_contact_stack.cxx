@@ -0,0 +1,199 @@
+#include "Regolith.h"
+#include "Regolith/Links/LinkCollisionManager.h"
+#include "Regolith/Collisions/SpriteCollision.h"
+#include "Regolith/Handlers/CollisionHandler.h"
+
+#include "logtastic.h"
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cmath>
+
+
+using namespace Regolith;
+
+/*
+ * Stability benchmark for resting contacts.
+ * Four 20 pixel boxes are dropped on to a fixed floor and stepped at 16 ms for 600 frames. Once the stack has had 300
+ * frames to settle, the largest vertical speed of any box and the deepest penetration of the bottom box into the floor
+ * are recorded for each collision handler configuration. A stable stack has both close to zero.
+ * The sequential impulse configurations use 8 iterations.
+ */
+
+const unsigned int number_boxes = 4;
+const unsigned int number_frames = 600;
+const unsigned int settle_frames = 300;
+const float time_step = 16.0;
+const float gravity = 0.001;
+const float floor_height = 100.0;
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Rectangular box that moves out of its contacts
+class BenchmarkBox : public CollidableObject
+{
+  private:
+    SpriteCollision _collision;
+
+  public:
+    BenchmarkBox( float x, float y, float width, float height, bool moveable )
+    {
+      Json::Value json_data;
+      json_data["hit_boxes"][0][0]["position"][0] = 0.0;
+      json_data["hit_boxes"][0][0]["position"][1] = 0.0;
+      json_data["hit_boxes"][0][0]["width"] = width;
+      json_data["hit_boxes"][0][0]["height"] = height;
+      json_data["hit_boxes"][0][0]["type"] = "box";
+      _collision.configure( json_data );
+
+      setWidth( width );
+      setHeight( height );
+      setPosition( Vector( x, y ) );
+      setMass( moveable ? 1.0 : 0.0 );
+      setTranslatable( moveable );
+    }
+
+    virtual PhysicalObject* clone() const override { return new BenchmarkBox( *this ); }
+
+    virtual const Collision& getCollision() override { return _collision; }
+
+    virtual void onCollision( Contact& contact, CollidableObject* ) override
+    {
+      if ( ! hasTranslation() ) return;
+      move( contact.massRatio * contact.overlap * contact.normal );
+      kick( contact.impulse );
+    }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Configuration under test
+struct StackConfiguration
+{
+  std::string name;
+  bool warmStarting;
+
+  // Position correction for the sequential impulse solver. Empty for direct resolution
+  std::string positionCorrection;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Simulate the stack and print one row of results
+void runStack( const StackConfiguration& configuration )
+{
+  Json::Value config;
+  config["team_collision"] = Json::Value( Json::arrayValue );
+  config["collision_rules"] = Json::Value( Json::arrayValue );
+  config["container_rules"] = Json::Value( Json::arrayValue );
+  config["warm_starting"] = configuration.warmStarting;
+
+  if ( ! configuration.positionCorrection.empty() )
+  {
+    config["solver"]["type"] = "sequential_impulse";
+    config["solver"]["iterations"] = 8;
+    config["solver"]["position_correction"] = configuration.positionCorrection;
+  }
+
+  CollisionHandler handler;
+  handler.configure( config );
+
+  BenchmarkBox floor( 0.0, floor_height, 400.0, 20.0, false );
+  floor.updateWorldHitBoxes();
+
+  // Stacked with a small gap so the boxes fall into contact
+  std::vector< BenchmarkBox* > boxes;
+  for ( unsigned int i = 0; i < number_boxes; ++i )
+  {
+    boxes.push_back( new BenchmarkBox( 100.0, floor_height - 20.5 - 21.0*i, 20.0, 20.0, true ) );
+  }
+
+  BroadPhase::PairList pairs;
+  for ( unsigned int i = 0; i < number_boxes; ++i )
+  {
+    pairs.push_back( std::make_pair( &floor, boxes[i] ) );
+    for ( unsigned int j = i+1; j < number_boxes; ++j )
+    {
+      pairs.push_back( std::make_pair( boxes[i], boxes[j] ) );
+    }
+  }
+
+  float max_velocity = 0.0;
+  float max_penetration = 0.0;
+
+  std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+  for ( unsigned int frame = 0; frame < number_frames; ++frame )
+  {
+    handler.warmStart();
+
+    for ( std::vector< BenchmarkBox* >::iterator it = boxes.begin(); it != boxes.end(); ++it )
+    {
+      (*it)->addForce( Vector( 0.0, gravity ) );
+      (*it)->step( time_step );
+      (*it)->updateWorldHitBoxes();
+    }
+
+    handler.narrowPhase( pairs );
+    handler.resolveContacts( time_step );
+
+    if ( frame < settle_frames ) continue;
+
+    for ( std::vector< BenchmarkBox* >::iterator it = boxes.begin(); it != boxes.end(); ++it )
+    {
+      max_velocity = std::max( max_velocity, std::fabs( (*it)->getVelocity().y() ) );
+    }
+    max_penetration = std::max( max_penetration, boxes[0]->getPosition().y() + 20.0f - floor_height );
+  }
+  std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+  double frame_time = std::chrono::duration< double, std::micro >( end - start ).count() / number_frames;
+
+  std::cout << std::setw( 36 ) << configuration.name
+            << std::setw( 16 ) << std::fixed << std::setprecision( 5 ) << max_velocity
+            << std::setw( 18 ) << std::setprecision( 4 ) << max_penetration
+            << std::setw( 18 ) << std::setprecision( 2 ) << frame_time << "\n";
+
+  for ( std::vector< BenchmarkBox* >::iterator it = boxes.begin(); it != boxes.end(); ++it )
+  {
+    delete (*it);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main( int, char** )
+{
+  logtastic::init();
+  logtastic::setLogFileDirectory( "./test_data/logs/" );
+  logtastic::setLogFile( "benchmark_contact_stack.log" );
+  logtastic::setPrintToScreenLimit( logtastic::off );
+
+  Manager::createInstance();
+  Link<CollisionManager, TestType> link_manager = Manager::getInstance()->getCollisionManager< TestType >();
+  link_manager.addCollisionType( "box", 0 );
+
+  logtastic::start( "Regolith - Contact Stack Benchmark", REGOLITH_VERSION_NUMBER );
+
+  std::vector< StackConfiguration > configurations;
+  configurations.push_back( { "Direct", false, "" } );
+  configurations.push_back( { "Direct, warm started", true, "" } );
+  configurations.push_back( { "Split impulse", false, "split_impulse" } );
+  configurations.push_back( { "Split impulse, warm started", true, "split_impulse" } );
+  configurations.push_back( { "Baumgarte, warm started", true, "baumgarte" } );
+
+  std::cout << "Boxes : " << number_boxes << ", frames : " << number_frames << ", measured after frame " << settle_frames << "\n";
+  std::cout << std::setw( 36 ) << "Configuration" << std::setw( 16 ) << "Max |v|" << std::setw( 18 ) << "Penetration (px)" << std::setw( 18 ) << "Time (us/frame)" << "\n";
+
+  for ( std::vector< StackConfiguration >::iterator it = configurations.begin(); it != configurations.end(); ++it )
+  {
+    runStack( *it );
+  }
+
+  Manager::killInstance();
+  logtastic::stop();
+  return 0;
+}
+
@@ -0,0 +1,138 @@
+#include "Regolith.h"
+#include "Regolith/GamePlay/FramePacer.h"
+
+#include "logtastic.h"
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <cmath>
+#include <ctime>
+
+
+using namespace Regolith;
+
+/*
+ * Microbenchmark for the frame pacing of the engine thread.
+ * Compares spinning until each frame is due, sleeping until it is due, and the frame pacer's sleep with a spin tail.
+ * Reports how late each frame starts and the processor time used, which is what a laptop battery sees.
+ */
+
+typedef std::chrono::steady_clock ClockType;
+
+const float target_fps = 60.0;
+const unsigned int number_frames = 120;
+const ClockType::duration period = std::chrono::duration_cast< ClockType::duration >( std::chrono::duration< float >( 1.0 / target_fps ) );
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Results for one method
+struct PacingResult
+{
+  double meanLateness;
+  double deviation;
+  double worstLateness;
+  double cpuTime;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Run the frames with a given wait function and measure when each one starts
+template < class WAIT >
+PacingResult measure( WAIT wait )
+{
+  double sum = 0.0;
+  double sum_squares = 0.0;
+  double worst = 0.0;
+
+  std::clock_t cpu_start = std::clock();
+  ClockType::time_point deadline = ClockType::now() + period;
+
+  for ( unsigned int frame = 0; frame < number_frames; ++frame )
+  {
+    wait( deadline );
+
+    double lateness = std::chrono::duration< double, std::milli >( ClockType::now() - deadline ).count();
+    sum += lateness;
+    sum_squares += lateness*lateness;
+    worst = std::max( worst, lateness );
+
+    deadline += period;
+  }
+
+  std::clock_t cpu_end = std::clock();
+
+  PacingResult result;
+  result.meanLateness = sum / number_frames;
+  result.deviation = std::sqrt( std::max( 0.0, sum_squares / number_frames - result.meanLateness*result.meanLateness ) );
+  result.worstLateness = worst;
+  result.cpuTime = 1000.0 * ( cpu_end - cpu_start ) / CLOCKS_PER_SEC;
+  return result;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Print a row of the table
+void print( const char* name, const PacingResult& result )
+{
+  std::cout << std::setw( 16 ) << name
+            << std::setw( 16 ) << std::fixed << std::setprecision( 3 ) << result.meanLateness
+            << std::setw( 16 ) << result.deviation
+            << std::setw( 16 ) << result.worstLateness
+            << std::setw( 16 ) << std::setprecision( 1 ) << result.cpuTime << "\n";
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main( int, char** )
+{
+  logtastic::init();
+  logtastic::setLogFileDirectory( "./test_data/logs/" );
+  logtastic::setLogFile( "benchmark_frame_pacer.log" );
+  logtastic::setPrintToScreenLimit( logtastic::off );
+  logtastic::start( "Regolith - Frame Pacer Benchmark", REGOLITH_VERSION_NUMBER );
+
+  PacingResult spin = measure( []( ClockType::time_point deadline )
+  {
+    while ( ClockType::now() < deadline );
+  } );
+
+  PacingResult sleep = measure( []( ClockType::time_point deadline )
+  {
+    std::this_thread::sleep_until( deadline );
+  } );
+
+  // The pacer keeps its own deadline, so it is started at the same moment as the measurement
+  FramePacer pacer;
+  pacer.configure( target_fps, 1.0 );
+  pacer.setVSync( false );
+  bool started = false;
+  PacingResult paced = measure( [&]( ClockType::time_point )
+  {
+    if ( ! started )
+    {
+      pacer.start();
+      started = true;
+    }
+    pacer.waitForFrame();
+  } );
+
+  std::cout << "Frames : " << number_frames << ", target : " << target_fps << " fps\n";
+  std::cout << std::setw( 16 ) << "Method" << std::setw( 16 ) << "Late (ms)" << std::setw( 16 ) << "Std dev (ms)"
+            << std::setw( 16 ) << "Worst (ms)" << std::setw( 16 ) << "CPU (ms)" << "\n";
+  print( "Spin", spin );
+  print( "Sleep", sleep );
+  print( "Frame pacer", paced );
+
+  if ( pacer.getMissedFrames() != 0 )
+  {
+    std::cerr << "Frame pacer missed " << pacer.getMissedFrames() << " deadlines with no work to do" << std::endl;
+    return 1;
+  }
+
+  logtastic::stop();
+  return 0;
+}
+
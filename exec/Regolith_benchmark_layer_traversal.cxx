@@ -0,0 +1,183 @@
+#include "Regolith.h"
+#include "Regolith/Contexts/ContextLayer.h"
+
+#include "logtastic.h"
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <list>
+#include <map>
+
+
+using namespace Regolith;
+
+/*
+ * Microbenchmark for the per-frame traversal of the objects in a context layer.
+ * Compares the previous map of linked lists with the contiguous per-team vectors now used by ContextLayer.
+ * Each frame steps every object, destroys a small fraction of them and respawns the same number, as the update loop
+ * and the spawners do.
+ */
+
+const unsigned int number_objects = 10000;
+const unsigned int number_teams = 4;
+const unsigned int number_frames = 500;
+const unsigned int churn = 50;
+
+typedef std::map< CollisionTeam, std::list< PhysicalObject* > > ListGraph;
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Minimal moving object
+class BenchmarkObject : public PhysicalObject
+{
+  public:
+    BenchmarkObject()
+    {
+      setMass( 1.0 );
+      setTranslatable( true );
+      setVelocity( Vector( 1.0, 0.5 ) );
+    }
+
+    virtual PhysicalObject* clone() const override { return new BenchmarkObject( *this ); }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // The previous update loop. Erases destroyed objects while iterating
+void traverseLists( ListGraph& graph, float time )
+{
+  for ( ListGraph::iterator team_it = graph.begin(); team_it != graph.end(); ++team_it )
+  {
+    for ( std::list< PhysicalObject* >::iterator obj_it = team_it->second.begin(); obj_it != team_it->second.end(); )
+    {
+      if ( (*obj_it)->isDestroyed() )
+      {
+        obj_it = team_it->second.erase( obj_it );
+        continue;
+      }
+
+      if ( (*obj_it)->hasMovement() ) (*obj_it)->step( time );
+      ++obj_it;
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // The current update loop. Compacts once, then iterates the vectors
+void traverseLayer( ContextLayer& layer, float time )
+{
+  layer.removeDestroyed();
+
+  for ( LayerGraph::iterator team_it = layer.layerGraph.begin(); team_it != layer.layerGraph.end(); ++team_it )
+  {
+    for ( PhysicalObjectVector::iterator obj_it = team_it->begin(); obj_it != team_it->end(); ++obj_it )
+    {
+      if ( (*obj_it)->hasMovement() ) (*obj_it)->step( time );
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Destroy a few objects and respawn the ones destroyed in the previous frame
+template < class INSERT >
+void spawnAndDestroy( std::vector< BenchmarkObject* >& objects, unsigned int frame, INSERT insert )
+{
+  unsigned int first = ( frame * churn ) % number_objects;
+  for ( unsigned int i = 0; i < churn; ++i )
+  {
+    BenchmarkObject* object = objects[ ( first + i ) % number_objects ];
+    if ( object->isDestroyed() )
+    {
+      object->reset();
+      insert( object, ( first + i ) % number_teams );
+    }
+  }
+
+  unsigned int next = ( ( frame + 1 ) * churn ) % number_objects;
+  for ( unsigned int i = 0; i < churn; ++i )
+  {
+    objects[ ( next + i ) % number_objects ]->destroy();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main( int, char** )
+{
+  logtastic::init();
+  logtastic::setLogFileDirectory( "./test_data/logs/" );
+  logtastic::setLogFile( "benchmark_layer_traversal.log" );
+  logtastic::setPrintToScreenLimit( logtastic::off );
+  logtastic::start( "Regolith - Layer Traversal Benchmark", REGOLITH_VERSION_NUMBER );
+
+  float time = 1.0;
+
+  // Separate object sets so that both layouts see the same work
+  std::vector< BenchmarkObject* > list_objects;
+  std::vector< BenchmarkObject* > layer_objects;
+  ListGraph list_graph;
+  ContextLayer layer;
+  layer.layerGraph.resize( number_teams );
+
+  for ( unsigned int i = 0; i < number_objects; ++i )
+  {
+    list_objects.push_back( new BenchmarkObject() );
+    list_graph[ i % number_teams ].push_back( list_objects.back() );
+
+    layer_objects.push_back( new BenchmarkObject() );
+    layer.layerGraph[ i % number_teams ].push_back( layer_objects.back() );
+  }
+
+
+  std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+  for ( unsigned int frame = 0; frame < number_frames; ++frame )
+  {
+    traverseLists( list_graph, time );
+    spawnAndDestroy( list_objects, frame, [&]( PhysicalObject* object, CollisionTeam team ) { list_graph[ team ].push_back( object ); } );
+  }
+  std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+  double list_time = std::chrono::duration< double, std::micro >( end - start ).count() / number_frames;
+
+
+  start = std::chrono::high_resolution_clock::now();
+  for ( unsigned int frame = 0; frame < number_frames; ++frame )
+  {
+    traverseLayer( layer, time );
+    spawnAndDestroy( layer_objects, frame, [&]( PhysicalObject* object, CollisionTeam team ) { layer.layerGraph[ team ].push_back( object ); } );
+  }
+  end = std::chrono::high_resolution_clock::now();
+  double layer_time = std::chrono::duration< double, std::micro >( end - start ).count() / number_frames;
+
+
+  // Both layouts must hold the same objects at the end
+  size_t list_size = 0;
+  for ( ListGraph::iterator it = list_graph.begin(); it != list_graph.end(); ++it ) list_size += it->second.size();
+
+  if ( list_size != layer.getNumberObjects() )
+  {
+    std::cerr << "Layouts disagree on the number of objects: " << list_size << " vs " << layer.getNumberObjects() << std::endl;
+    return 1;
+  }
+
+  std::cout << "Objects : " << number_objects << ", teams : " << number_teams << ", frames : " << number_frames << "\n";
+  std::cout << std::setw( 24 ) << "Map of lists (us/frame)" << std::setw( 24 ) << "Vectors (us/frame)" << std::setw( 12 ) << "Speed up" << "\n";
+  std::cout << std::setw( 24 ) << std::fixed << std::setprecision( 2 ) << list_time
+            << std::setw( 24 ) << layer_time
+            << std::setw( 11 ) << list_time / layer_time << "x\n";
+
+  layer.layerGraph.clear();
+  for ( unsigned int i = 0; i < number_objects; ++i )
+  {
+    delete list_objects[i];
+    delete layer_objects[i];
+  }
+
+  logtastic::stop();
+  return 0;
+}
+
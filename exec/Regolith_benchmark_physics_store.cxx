@@ -0,0 +1,149 @@
+#include "Regolith.h"
+#include "Regolith/Architecture/PhysicsStore.h"
+
+#include "logtastic.h"
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <cmath>
+
+
+using namespace Regolith;
+
+/*
+ * Microbenchmark for the time integration of the moving objects in a context.
+ * Compares calling the virtual step() on every object with the single vectorised pass of the structure-of-arrays
+ * physics store. A constant force and torque is applied to every object each frame, as gravity would be, and a fraction
+ * of the objects are fixed so that the masks are exercised. Both paths must finish with the same state.
+ */
+
+const unsigned int number_objects = 10000;
+const unsigned int number_frames = 500;
+const unsigned int fixed_fraction = 8;
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Minimal moving object
+class BenchmarkObject : public PhysicalObject
+{
+  public:
+    BenchmarkObject( unsigned int i )
+    {
+      setMass( 1.0 + 0.001*i );
+      setInertiaDensity( 50.0 );
+      setTranslatable( i % fixed_fraction != 0 );
+      setRotatable( i % fixed_fraction != 0 );
+      setPosition( Vector( i, 0.5*i ) );
+      setVelocity( Vector( 1.0, 0.5 ) );
+    }
+
+    virtual PhysicalObject* clone() const override { return new BenchmarkObject( *this ); }
+
+    virtual bool usesPhysicsStore() const override { return true; }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Apply the external forces for a frame
+void applyForces( std::vector< BenchmarkObject* >& objects )
+{
+  for ( std::vector< BenchmarkObject* >::iterator it = objects.begin(); it != objects.end(); ++it )
+  {
+    (*it)->addForce( Vector( 0.0, 0.2 ) );
+    (*it)->addTorque( 0.1 );
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main( int, char** )
+{
+  logtastic::init();
+  logtastic::setLogFileDirectory( "./test_data/logs/" );
+  logtastic::setLogFile( "benchmark_physics_store.log" );
+  logtastic::setPrintToScreenLimit( logtastic::off );
+  logtastic::start( "Regolith - Physics Store Benchmark", REGOLITH_VERSION_NUMBER );
+
+  float time = 0.1;
+
+  // Separate object sets so that both paths see the same work
+  std::vector< BenchmarkObject* > step_objects;
+  std::vector< BenchmarkObject* > store_objects;
+  PhysicsStore store;
+
+  for ( unsigned int i = 0; i < number_objects; ++i )
+  {
+    step_objects.push_back( new BenchmarkObject( i ) );
+    store_objects.push_back( new BenchmarkObject( i ) );
+    store.attach( store_objects.back() );
+  }
+
+
+  std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+  for ( unsigned int frame = 0; frame < number_frames; ++frame )
+  {
+    applyForces( step_objects );
+    for ( std::vector< BenchmarkObject* >::iterator it = step_objects.begin(); it != step_objects.end(); ++it )
+    {
+      if ( (*it)->hasMovement() ) (*it)->step( time );
+    }
+  }
+  std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+  double step_time = std::chrono::duration< double, std::micro >( end - start ).count() / number_frames;
+
+
+  start = std::chrono::high_resolution_clock::now();
+  for ( unsigned int frame = 0; frame < number_frames; ++frame )
+  {
+    applyForces( store_objects );
+    store.integrate( time );
+  }
+  end = std::chrono::high_resolution_clock::now();
+  double store_time = std::chrono::duration< double, std::micro >( end - start ).count() / number_frames;
+
+
+  // Both paths must agree. The state is read through the slot for one set and the members for the other.
+  float max_difference = 0.0;
+  for ( unsigned int i = 0; i < number_objects; ++i )
+  {
+    max_difference = std::max( max_difference, (float)( step_objects[i]->getPosition() - store_objects[i]->getPosition() ).mod() );
+    max_difference = std::max( max_difference, (float)( step_objects[i]->previousPosition() - store_objects[i]->previousPosition() ).mod() );
+    max_difference = std::max( max_difference, (float)( step_objects[i]->getVelocity() - store_objects[i]->getVelocity() ).mod() );
+    max_difference = std::max( max_difference, std::fabs( step_objects[i]->getRotation() - store_objects[i]->getRotation() ) );
+    max_difference = std::max( max_difference, std::fabs( step_objects[i]->getAngularVelocity() - store_objects[i]->getAngularVelocity() ) );
+  }
+
+  if ( max_difference > epsilon )
+  {
+    std::cerr << "Integrators disagree. Maximum difference : " << max_difference << std::endl;
+    return 1;
+  }
+
+  // Detaching must hand the state back unchanged
+  Vector position = store_objects[1]->getPosition();
+  store.clear();
+  if ( store_objects[1]->hasPhysicsSlot() || ( store_objects[1]->getPosition() - position ).mod() > 0.0 )
+  {
+    std::cerr << "State was not restored when detaching from the store" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Objects : " << number_objects << ", frames : " << number_frames << ", SIMD width : " << REGOLITH_SIMD_WIDTH << "\n";
+  std::cout << std::setw( 24 ) << "step() (us/frame)" << std::setw( 24 ) << "Store (us/frame)" << std::setw( 12 ) << "Speed up" << "\n";
+  std::cout << std::setw( 24 ) << std::fixed << std::setprecision( 2 ) << step_time
+            << std::setw( 24 ) << store_time
+            << std::setw( 11 ) << step_time / store_time << "x\n";
+
+  for ( unsigned int i = 0; i < number_objects; ++i )
+  {
+    delete step_objects[i];
+    delete store_objects[i];
+  }
+
+  logtastic::stop();
+  return 0;
+}
+
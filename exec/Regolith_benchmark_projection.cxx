@@ -0,0 +1,145 @@
+
+#include "Regolith.h"
+#include "Regolith/Collisions/Collision.h"
+
+#include "logtastic.h"
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <limits>
+#include <cmath>
+
+
+using namespace Regolith;
+
+/*
+ * Microbenchmark for the hitbox projection used by the separating axis tests.
+ * Compares the array-of-structs loop over HitBox::points with the scalar and vectorised structure-of-arrays kernels,
+ * for convex hulls with 4, 8 and 16 vertices.
+ */
+
+const unsigned int number_axes = 1024;
+const unsigned int number_repeats = 2000;
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Build a regular polygon with the requested number of vertices
+HitBox buildHull( unsigned int number )
+{
+  HitBox box;
+  box.number = number;
+  box.collisionType = 0;
+  box.shape = HitBoxType::Polygon;
+  box.radius = 0.0;
+
+  for ( unsigned int i = 0; i < number; ++i )
+  {
+    float angle = 2.0*pi*i / number;
+    box.points.push_back( Vector( 50.0*std::cos( angle ), 50.0*std::sin( angle ) ) );
+    box.normals.push_back( Vector( std::cos( angle + pi/number ), std::sin( angle + pi/number ) ) );
+  }
+
+  return box;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // The per-vertex loop previously used in CollisionHandler::collides
+void projectAoS( const HitBox& box, const Vector& axis, float& min, float& max )
+{
+  min = std::numeric_limits<float>::max();
+  max = std::numeric_limits<float>::lowest();
+
+  for ( unsigned int i = 0; i < box.number; ++i )
+  {
+    float projection = box.points[i] * axis;
+    if ( projection < min ) min = projection;
+    if ( projection > max ) max = projection;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Time a projection function over all the axes. Returns nanoseconds per projection
+template < class BOX, class FUNCTION >
+double timeProjection( const BOX& box, const std::vector< Vector >& axes, FUNCTION function, float& sink )
+{
+  float min;
+  float max;
+
+  std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+  for ( unsigned int r = 0; r < number_repeats; ++r )
+  {
+    for ( std::vector< Vector >::const_iterator it = axes.begin(); it != axes.end(); ++it )
+    {
+      function( box, *it, min, max );
+      sink += min - max;
+    }
+  }
+
+  std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+
+  return std::chrono::duration< double, std::nano >( end - start ).count() / ( number_repeats * axes.size() );
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main( int, char** )
+{
+  logtastic::init();
+  logtastic::setLogFileDirectory( "./test_data/logs/" );
+  logtastic::setLogFile( "benchmark_projection.log" );
+  logtastic::setPrintToScreenLimit( logtastic::off );
+  logtastic::start( "Regolith - Projection Benchmark", REGOLITH_VERSION_NUMBER );
+
+  std::vector< Vector > axes;
+  axes.reserve( number_axes );
+  for ( unsigned int i = 0; i < number_axes; ++i )
+  {
+    float angle = 2.0*pi*i / number_axes;
+    axes.push_back( Vector( std::cos( angle ), std::sin( angle ) ) );
+  }
+
+  std::cout << "SIMD width : " << REGOLITH_SIMD_WIDTH << "\n";
+  std::cout << std::setw( 10 ) << "Vertices" << std::setw( 16 ) << "AoS (ns)" << std::setw( 16 ) << "SoA (ns)" << std::setw( 16 ) << "Kernel (ns)" << std::setw( 12 ) << "Speed up" << "\n";
+
+  float sink = 0.0;
+  const unsigned int sizes[3] = { 4, 8, 16 };
+
+  for ( unsigned int s = 0; s < 3; ++s )
+  {
+    HitBox box = buildHull( sizes[s] );
+    HitBoxSoA packed;
+    packed.set( box );
+
+    // Check the kernels agree before timing them
+    float min_aos, max_aos, min_kernel, max_kernel;
+    projectAoS( box, axes[1], min_aos, max_aos );
+    projectHitBox( packed, axes[1], min_kernel, max_kernel );
+    if ( std::fabs( min_aos - min_kernel ) > 1.0E-3 || std::fabs( max_aos - max_kernel ) > 1.0E-3 )
+    {
+      std::cerr << "Projection kernel disagrees with the reference for " << sizes[s] << " vertices" << std::endl;
+      return 1;
+    }
+
+    double aos = timeProjection( box, axes, projectAoS, sink );
+    double scalar = timeProjection( packed, axes, projectHitBoxScalar, sink );
+    double kernel = timeProjection( packed, axes, projectHitBox, sink );
+
+    std::cout << std::setw( 10 ) << sizes[s]
+              << std::setw( 16 ) << std::fixed << std::setprecision( 2 ) << aos
+              << std::setw( 16 ) << scalar
+              << std::setw( 16 ) << kernel
+              << std::setw( 11 ) << aos / kernel << "x\n";
+  }
+
+  std::cout << "(Ignore: " << sink << ")" << std::endl;
+
+  logtastic::stop();
+  return 0;
+}
+
@@ -0,0 +1,400 @@
+#include "Regolith.h"
+#include "Regolith/Assets/CookedImage.h"
+#include "Regolith/Assets/AssetArchive.h"
+#include "Regolith/Utilities/AtlasPacker.h"
+
+#include "logtastic.h"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cstdlib>
+
+
+using namespace Regolith;
+
+/*
+ * Offline asset cooker.
+ * Reads a resource index file and writes a cooked copy of every image next to a new index that refers to them.
+ * Cooked images are decoded, colour keyed and converted to the renderer's pixel format ahead of time, then stored
+ * as LZ4 compressed raw pixels so that loading them at run time is a single decompression.
+ * Small images are packed into shared atlas pages and the index records where each one is placed.
+ * Text, audio and font assets are left as they are. Everything can optionally be packed into an asset archive.
+ */
+
+const char* usage = "Usage: Regolith_cook_assets <index_file> <output_directory> [options]\n"
+                    "  --index <file>        Name of the cooked index file. Default: index.json\n"
+                    "  --archive <file>      Also pack every asset into an archive file\n"
+                    "  --format <format>     Pixel format of the cooked images: RGBA32, ARGB32, ABGR32 or BGRA32. Default: RGBA32\n"
+                    "  --max-sprite <pixels> Largest image dimension that is packed into an atlas. 0 disables atlases. Default: 256\n"
+                    "  --atlas-size <pixels> Width and maximum height of the atlas pages. Default: 2048\n"
+                    "  --padding <pixels>    Gap between images in an atlas. Default: 1\n";
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // An image being cooked
+struct CookingImage
+{
+  std::string name;
+  Json::Value details;
+  SDL_Surface* surface;
+  int page;
+  SDL_Point position;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Load an image and bake the colour key into the alpha channel
+SDL_Surface* loadImage( std::string path, Json::Value& details )
+{
+  SDL_Surface* loaded = IMG_Load( path.c_str() );
+  if ( loaded == nullptr )
+  {
+    Exception ex( "loadImage()", "Could not load image" );
+    ex.addDetail( "Path", path );
+    ex.addDetail( "SDL IMG error", IMG_GetError() );
+    throw ex;
+  }
+
+  SDL_Surface* surface = SDL_ConvertSurfaceFormat( loaded, SDL_PIXELFORMAT_RGBA32, 0 );
+  SDL_FreeSurface( loaded );
+  if ( surface == nullptr )
+  {
+    Exception ex( "loadImage()", "Could not convert image" );
+    ex.addDetail( "Path", path );
+    ex.addDetail( "SDL error", SDL_GetError() );
+    throw ex;
+  }
+
+  if ( details.isMember( "colour_key" ) )
+  {
+    Uint8 key[3] = { (Uint8)details["colour_key"][0].asInt(), (Uint8)details["colour_key"][1].asInt(), (Uint8)details["colour_key"][2].asInt() };
+
+    // RGBA32 is always stored as R, G, B, A bytes
+    if ( SDL_MUSTLOCK( surface ) ) SDL_LockSurface( surface );
+    for ( int row = 0; row < surface->h; ++row )
+    {
+      Uint8* pixel = (Uint8*)surface->pixels + row * surface->pitch;
+      for ( int col = 0; col < surface->w; ++col, pixel += 4 )
+      {
+        if ( pixel[0] == key[0] && pixel[1] == key[1] && pixel[2] == key[2] )
+        {
+          pixel[3] = 0;
+        }
+      }
+    }
+    if ( SDL_MUSTLOCK( surface ) ) SDL_UnlockSurface( surface );
+  }
+
+  return surface;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Convert to the output format and write the cooked image file
+void writeImage( SDL_Surface* surface, Uint32 format, std::string path )
+{
+  SDL_Surface* converted = SDL_ConvertSurfaceFormat( surface, format, 0 );
+  if ( converted == nullptr )
+  {
+    Exception ex( "writeImage()", "Could not convert image" );
+    ex.addDetail( "Path", path );
+    ex.addDetail( "SDL error", SDL_GetError() );
+    throw ex;
+  }
+
+  std::vector< unsigned char > contents;
+  cookImage( converted, contents );
+  SDL_FreeSurface( converted );
+
+  std::ofstream output( path, std::ios::binary );
+  output.write( (const char*)contents.data(), contents.size() );
+  if ( ! output )
+  {
+    Exception ex( "writeImage()", "Could not write cooked image" );
+    ex.addDetail( "Path", path );
+    throw ex;
+  }
+}
+
+
+int main( int argc, char** argv )
+{
+  std::vector< std::string > arguments;
+  std::string index_name = "index.json";
+  std::string archive_file;
+  std::string format_name = "RGBA32";
+  int max_sprite = 256;
+  int atlas_size = 2048;
+  int padding = 1;
+
+  for ( int i = 1; i < argc; ++i )
+  {
+    std::string arg( argv[i] );
+    if ( arg.compare( 0, 2, "--" ) != 0 )
+    {
+      arguments.push_back( arg );
+    }
+    else if ( i + 1 >= argc )
+    {
+      std::cerr << usage;
+      return 1;
+    }
+    else if ( arg == "--index" ) index_name = argv[++i];
+    else if ( arg == "--archive" ) archive_file = argv[++i];
+    else if ( arg == "--format" ) format_name = argv[++i];
+    else if ( arg == "--max-sprite" ) max_sprite = std::atoi( argv[++i] );
+    else if ( arg == "--atlas-size" ) atlas_size = std::atoi( argv[++i] );
+    else if ( arg == "--padding" ) padding = std::atoi( argv[++i] );
+    else
+    {
+      std::cerr << "Unknown option: " << arg << "\n" << usage;
+      return 1;
+    }
+  }
+
+  if ( arguments.size() != 2 || atlas_size <= 0 || padding < 0 )
+  {
+    std::cerr << usage;
+    return 1;
+  }
+
+  std::map< std::string, Uint32 > formats = { { "RGBA32", SDL_PIXELFORMAT_RGBA32 }, { "ARGB32", SDL_PIXELFORMAT_ARGB32 },
+                                              { "ABGR32", SDL_PIXELFORMAT_ABGR32 }, { "BGRA32", SDL_PIXELFORMAT_BGRA32 } };
+  if ( formats.find( format_name ) == formats.end() )
+  {
+    std::cerr << "Unknown pixel format: " << format_name << "\n" << usage;
+    return 1;
+  }
+  Uint32 format = formats[ format_name ];
+
+  std::string index_file = arguments[0];
+  std::string output_dir = arguments[1] + "/";
+
+  logtastic::init();
+  logtastic::setLogFileDirectory( output_dir.c_str() );
+  logtastic::setLogFile( "cook_assets.log" );
+  logtastic::setPrintToScreenLimit( logtastic::error );
+  logtastic::start( "Regolith - Asset Cooker", REGOLITH_VERSION_NUMBER );
+
+  IMG_Init( IMG_INIT_PNG );
+
+  std::vector< CookingImage > images;
+  std::vector< SDL_Surface* > page_surfaces;
+  int exit_code = 0;
+
+  try
+  {
+    Json::Value index_data;
+    loadJsonData( index_data, index_file );
+    validateJson( index_data, "fonts", JsonType::OBJECT );
+    validateJson( index_data, "images", JsonType::OBJECT );
+    validateJson( index_data, "text", JsonType::OBJECT );
+    validateJson( index_data, "audio", JsonType::OBJECT );
+
+    // Decode everything first so the atlases can be packed tallest first
+    Json::Value& image_data = index_data["images"];
+    for ( Json::Value::iterator it = image_data.begin(); it != image_data.end(); ++it )
+    {
+      CookingImage image;
+      image.name = it.key().asString();
+      image.details = *it;
+      image.surface = nullptr;
+      image.page = -1;
+      image.position = { 0, 0 };
+      images.push_back( image );
+
+      images.back().surface = loadImage( image.details["path"].asString(), image.details );
+    }
+
+    std::vector< size_t > order;
+    for ( size_t i = 0; i < images.size(); ++i )
+    {
+      if ( images[i].surface->w <= max_sprite && images[i].surface->h <= max_sprite )
+      {
+        order.push_back( i );
+      }
+    }
+    std::sort( order.begin(), order.end(), [&]( size_t a, size_t b )
+    {
+      if ( images[a].surface->h != images[b].surface->h ) return images[a].surface->h > images[b].surface->h;
+      return images[a].surface->w > images[b].surface->w;
+    } );
+
+    // Place each image on the first page with room for it
+    std::vector< AtlasPacker > pages;
+    for ( std::vector< size_t >::iterator it = order.begin(); it != order.end(); ++it )
+    {
+      CookingImage& image = images[*it];
+      for ( size_t page = 0; page < pages.size() && image.page < 0; ++page )
+      {
+        if ( pages[page].insert( image.surface->w, image.surface->h, image.position ) ) image.page = page;
+      }
+
+      if ( image.page < 0 )
+      {
+        pages.push_back( AtlasPacker( atlas_size, atlas_size, padding ) );
+        if ( ! pages.back().insert( image.surface->w, image.surface->h, image.position ) )
+        {
+          Exception ex( "main()", "Image does not fit in an empty atlas" );
+          ex.addDetail( "Image", image.name );
+          ex.addDetail( "Atlas size", atlas_size );
+          throw ex;
+        }
+        image.page = pages.size() - 1;
+      }
+    }
+
+    // A page holding a single image saves nothing
+    std::vector< int > page_counts( pages.size(), 0 );
+    for ( size_t i = 0; i < images.size(); ++i )
+    {
+      if ( images[i].page >= 0 ) ++page_counts[ images[i].page ];
+    }
+
+    page_surfaces.resize( pages.size(), nullptr );
+    std::vector< std::string > page_names( pages.size() );
+    for ( size_t page = 0; page < pages.size(); ++page )
+    {
+      if ( page_counts[page] < 2 ) continue;
+
+      page_names[page] = "cooked_atlas_" + std::to_string( page );
+      if ( image_data.isMember( page_names[page] ) )
+      {
+        Exception ex( "main()", "Atlas name is already used by an image" );
+        ex.addDetail( "Name", page_names[page] );
+        throw ex;
+      }
+
+      // Only the packed part of the page is kept
+      page_surfaces[page] = SDL_CreateRGBSurfaceWithFormat( 0, pages[page].getWidth(), pages[page].getUsedHeight(), 32, SDL_PIXELFORMAT_RGBA32 );
+      if ( page_surfaces[page] == nullptr )
+      {
+        Exception ex( "main()", "Could not create atlas surface" );
+        ex.addDetail( "SDL error", SDL_GetError() );
+        throw ex;
+      }
+      SDL_FillRect( page_surfaces[page], nullptr, 0 );
+    }
+
+    // Write the cooked images and update the index
+    Json::Value cooked_images( Json::objectValue );
+    std::vector< std::string > cooked_files;
+    for ( std::vector< CookingImage >::iterator it = images.begin(); it != images.end(); ++it )
+    {
+      Json::Value details = it->details;
+      details.removeMember( "colour_key" );
+      details["cooked"] = true;
+
+      if ( it->page >= 0 && page_surfaces[ it->page ] != nullptr )
+      {
+        // Copy the pixels exactly, including the alpha channel
+        SDL_Rect destination = { it->position.x, it->position.y, it->surface->w, it->surface->h };
+        SDL_SetSurfaceBlendMode( it->surface, SDL_BLENDMODE_NONE );
+        SDL_BlitSurface( it->surface, nullptr, page_surfaces[ it->page ], &destination );
+
+        details["path"] = output_dir + page_names[ it->page ] + ".rgci";
+        details["atlas"] = page_names[ it->page ];
+        details["x"] = it->position.x;
+        details["y"] = it->position.y;
+        INFO_STREAM << "Packed " << it->name << " into " << page_names[ it->page ] << " at " << it->position.x << ", " << it->position.y;
+      }
+      else
+      {
+        std::string filename = it->name;
+        std::replace( filename.begin(), filename.end(), '/', '_' );
+        details["path"] = output_dir + filename + ".rgci";
+
+        writeImage( it->surface, format, details["path"].asString() );
+        cooked_files.push_back( details["path"].asString() );
+        INFO_STREAM << "Cooked " << it->name;
+      }
+
+      cooked_images[ it->name ] = details;
+    }
+
+    for ( size_t page = 0; page < pages.size(); ++page )
+    {
+      if ( page_surfaces[page] == nullptr ) continue;
+
+      std::string path = output_dir + page_names[page] + ".rgci";
+      writeImage( page_surfaces[page], format, path );
+      cooked_files.push_back( path );
+
+      Json::Value details;
+      details["path"] = path;
+      details["width"] = page_surfaces[page]->w;
+      details["height"] = page_surfaces[page]->h;
+      details["rows"] = 1;
+      details["columns"] = 1;
+      details["cooked"] = true;
+      cooked_images[ page_names[page] ] = details;
+
+      std::cout << page_names[page] << " : " << page_counts[page] << " images, " << page_surfaces[page]->w << "x" << page_surfaces[page]->h
+                << " pixels, " << (int)( pages[page].getOccupancy() * 100.0 * pages[page].getHeight() / page_surfaces[page]->h ) << "% used" << std::endl;
+    }
+
+    index_data["images"] = cooked_images;
+
+    Json::StreamWriterBuilder writer_builder;
+    writer_builder["indentation"] = "  ";
+    std::ofstream index_output( output_dir + index_name );
+    index_output << Json::writeString( writer_builder, index_data ) << std::endl;
+    if ( ! index_output )
+    {
+      Exception ex( "main()", "Could not write index file" );
+      ex.addDetail( "Path", output_dir + index_name );
+      throw ex;
+    }
+
+    std::cout << "Cooked " << images.size() << " images into " << cooked_files.size() << " files" << std::endl;
+
+    if ( ! archive_file.empty() )
+    {
+      AssetArchiveWriter archive;
+
+      // Cooked images are already compressed
+      for ( std::vector< std::string >::iterator it = cooked_files.begin(); it != cooked_files.end(); ++it )
+      {
+        archive.addFile( *it, *it, false );
+      }
+
+      const char* other_types[3] = { "fonts", "text", "audio" };
+      for ( unsigned int type = 0; type < 3; ++type )
+      {
+        Json::Value& other_data = index_data[ other_types[type] ];
+        for ( Json::Value::iterator it = other_data.begin(); it != other_data.end(); ++it )
+        {
+          std::string path = (*it)["path"].asString();
+          if ( ! archive.contains( path ) ) archive.addFile( path, path, true );
+        }
+      }
+
+      archive.write( archive_file );
+      std::cout << "Packed " << archive.size() << " files into " << archive_file << std::endl;
+    }
+  }
+  catch ( Exception& ex )
+  {
+    std::cerr << ex.elucidate() << std::endl;
+    exit_code = 1;
+  }
+
+  for ( std::vector< CookingImage >::iterator it = images.begin(); it != images.end(); ++it )
+  {
+    if ( it->surface != nullptr ) SDL_FreeSurface( it->surface );
+  }
+
+  for ( size_t page = 0; page < page_surfaces.size(); ++page )
+  {
+    if ( page_surfaces[page] != nullptr ) SDL_FreeSurface( page_surfaces[page] );
+  }
+
+  IMG_Quit();
+  logtastic::stop();
+  return exit_code;
+}
+
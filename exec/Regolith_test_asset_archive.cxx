@@ -0,0 +1,190 @@
+#include "Regolith.h"
+#include "Regolith/Assets/AssetArchive.h"
+#include "Regolith/Utilities/Compression.h"
+
+#include "logtastic.h"
+#include "testass.h"
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdio>
+
+
+using namespace Regolith;
+
+
+// Read the whole entry and close it
+std::vector< unsigned char > readEntry( SDL_RWops* file )
+{
+  std::vector< unsigned char > contents( SDL_RWsize( file ) );
+  if ( ! contents.empty() )
+  {
+    SDL_RWread( file, contents.data(), 1, contents.size() );
+  }
+  SDL_RWclose( file );
+  return contents;
+}
+
+
+int main( int, char** )
+{
+  logtastic::init();
+  logtastic::setLogFileDirectory( "./test_data/logs/" );
+  logtastic::setLogFile( "tests_asset_archive.log" );
+  logtastic::setPrintToScreenLimit( logtastic::error );
+  logtastic::start( "Regolith - Asset Archive Tests", REGOLITH_VERSION_NUMBER );
+
+  testass::control::init( "Regolith", "Asset Archive" );
+  testass::control::get()->setVerbosity( testass::control::verb_short );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  const char* archive_file = "./test_data/asset_archive_test.rgpk";
+  const char* invalid_file = "./test_data/asset_archive_invalid.rgpk";
+
+  std::string text = "Some text that is stored without compression\n";
+
+  std::vector< unsigned char > repeated( 100000 );
+  for ( size_t i = 0; i < repeated.size(); ++i ) repeated[i] = ( i / 3 ) % 17;
+
+  std::vector< unsigned char > noise( 5000 );
+  unsigned int seed = 12345;
+  for ( size_t i = 0; i < noise.size(); ++i )
+  {
+    seed = seed * 1103515245 + 12345;
+    noise[i] = seed >> 16;
+  }
+
+
+  SECTION( "LZ4 Compression" );
+  {
+    std::vector< unsigned char > compressed;
+    size_t size = compressLZ4( repeated.data(), repeated.size(), compressed );
+    ASSERT_EQUAL( size, compressed.size() );
+    ASSERT_TRUE( size < repeated.size() / 10 );
+
+    std::vector< unsigned char > decompressed( repeated.size() );
+    ASSERT_TRUE( decompressLZ4( compressed.data(), compressed.size(), decompressed.data(), decompressed.size() ) );
+    ASSERT_TRUE( decompressed == repeated );
+
+    // Wrong size or truncated data is rejected
+    ASSERT_FALSE( decompressLZ4( compressed.data(), compressed.size(), decompressed.data(), decompressed.size() - 1 ) );
+    ASSERT_FALSE( decompressLZ4( compressed.data(), compressed.size() / 2, decompressed.data(), decompressed.size() ) );
+
+    // Incompressible data still round trips
+    compressLZ4( noise.data(), noise.size(), compressed );
+    decompressed.resize( noise.size() );
+    ASSERT_TRUE( decompressLZ4( compressed.data(), compressed.size(), decompressed.data(), decompressed.size() ) );
+    ASSERT_TRUE( decompressed == noise );
+
+    // Empty blocks
+    compressLZ4( nullptr, 0, compressed );
+    ASSERT_EQUAL( compressed.size(), 1u );
+    ASSERT_TRUE( decompressLZ4( compressed.data(), compressed.size(), nullptr, 0 ) );
+  }
+
+
+  SECTION( "Write Archive" );
+  {
+    AssetArchiveWriter writer;
+    writer.addData( "data/text.txt", (const unsigned char*) text.data(), text.size() );
+    writer.addData( "data/repeated.bin", repeated.data(), repeated.size(), true );
+    writer.addData( "data/noise.bin", noise.data(), noise.size(), true );
+    ASSERT_EQUAL( writer.size(), 3u );
+    ASSERT_TRUE( writer.contains( "data/noise.bin" ) );
+
+    bool duplicate = false;
+    try
+    {
+      writer.addData( "data/text.txt", (const unsigned char*) text.data(), text.size() );
+    }
+    catch ( Exception& )
+    {
+      duplicate = true;
+    }
+    ASSERT_TRUE( duplicate );
+
+    writer.write( archive_file );
+  }
+
+
+  SECTION( "Read Archive" );
+  {
+    AssetArchive archive;
+    ASSERT_FALSE( archive.isOpen() );
+    ASSERT_TRUE( archive.openEntry( "data/text.txt" ) == nullptr );
+
+    archive.open( archive_file );
+    ASSERT_TRUE( archive.isOpen() );
+    ASSERT_EQUAL( archive.size(), 3u );
+
+    ASSERT_TRUE( archive.contains( "data/text.txt" ) );
+    ASSERT_TRUE( archive.contains( "data/repeated.bin" ) );
+    ASSERT_FALSE( archive.contains( "data/missing.bin" ) );
+    ASSERT_FALSE( archive.contains( "data/text.tx" ) );
+    ASSERT_TRUE( archive.openEntry( "data/missing.bin" ) == nullptr );
+
+    std::vector< unsigned char > contents = readEntry( archive.openEntry( "data/text.txt" ) );
+    ASSERT_EQUAL( std::string( contents.begin(), contents.end() ), text );
+
+    contents = readEntry( archive.openEntry( "data/repeated.bin" ) );
+    ASSERT_TRUE( contents == repeated );
+
+    contents = readEntry( archive.openEntry( "data/noise.bin" ) );
+    ASSERT_TRUE( contents == noise );
+
+    archive.close();
+    ASSERT_FALSE( archive.isOpen() );
+    ASSERT_EQUAL( archive.size(), 0u );
+  }
+
+
+  SECTION( "Invalid Archives" );
+  {
+    AssetArchive archive;
+
+    bool missing = false;
+    try
+    {
+      archive.open( "./test_data/asset_archive_missing.rgpk" );
+    }
+    catch ( Exception& )
+    {
+      missing = true;
+    }
+    ASSERT_TRUE( missing );
+
+    {
+      std::ofstream output( invalid_file );
+      output << "This is not an asset archive, but it is long enough to have a header";
+    }
+
+    bool invalid = false;
+    try
+    {
+      archive.open( invalid_file );
+    }
+    catch ( Exception& )
+    {
+      invalid = true;
+    }
+    ASSERT_TRUE( invalid );
+    ASSERT_FALSE( archive.isOpen() );
+  }
+
+  std::remove( archive_file );
+  std::remove( invalid_file );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  if ( ! testass::control::summarize() )
+  {
+    testass::control::printReport( std::cout );
+  }
+
+  testass::control::kill();
+  logtastic::stop();
+  return 0;
+}
+
@@ -0,0 +1,151 @@
+#include "Regolith.h"
+#include "Regolith/Assets/CookedImage.h"
+#include "Regolith/Utilities/AtlasPacker.h"
+
+#include "logtastic.h"
+#include "testass.h"
+
+#include <vector>
+#include <cstring>
+
+
+using namespace Regolith;
+
+
+// Return true if the two rectangles share any pixels
+bool overlaps( const SDL_Rect& a, const SDL_Rect& b )
+{
+  return ( a.x < b.x + b.w ) && ( b.x < a.x + a.w ) && ( a.y < b.y + b.h ) && ( b.y < a.y + a.h );
+}
+
+
+int main( int, char** )
+{
+  logtastic::init();
+  logtastic::setLogFileDirectory( "./test_data/logs/" );
+  logtastic::setLogFile( "tests_asset_cooking.log" );
+  logtastic::setPrintToScreenLimit( logtastic::error );
+  logtastic::start( "Regolith - Asset Cooking Tests", REGOLITH_VERSION_NUMBER );
+
+  testass::control::init( "Regolith", "Asset Cooking" );
+  testass::control::get()->setVerbosity( testass::control::verb_short );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  SECTION( "Atlas Packing" );
+  {
+    AtlasPacker packer( 256, 256, 1 );
+    ASSERT_EQUAL( packer.getWidth(), 256 );
+    ASSERT_EQUAL( packer.getHeight(), 256 );
+    ASSERT_EQUAL( packer.getUsedHeight(), 0 );
+
+    // Tallest first, as the cooker inserts them
+    int sizes[][2] = { { 64, 64 }, { 100, 48 }, { 32, 40 }, { 40, 32 }, { 16, 16 }, { 16, 16 }, { 200, 8 }, { 7, 3 } };
+    std::vector< SDL_Rect > placed;
+
+    for ( unsigned int i = 0; i < sizeof( sizes ) / sizeof( sizes[0] ); ++i )
+    {
+      SDL_Point position;
+      ASSERT_TRUE( packer.insert( sizes[i][0], sizes[i][1], position ) );
+
+      SDL_Rect rect = { position.x, position.y, sizes[i][0], sizes[i][1] };
+      ASSERT_TRUE( rect.x >= 0 && rect.y >= 0 );
+      ASSERT_TRUE( rect.x + rect.w <= 256 && rect.y + rect.h <= 256 );
+
+      // Padding keeps a gap between every pair
+      SDL_Rect padded = { rect.x, rect.y, rect.w + 1, rect.h + 1 };
+      for ( std::vector< SDL_Rect >::iterator it = placed.begin(); it != placed.end(); ++it )
+      {
+        ASSERT_FALSE( overlaps( padded, *it ) );
+      }
+      placed.push_back( rect );
+    }
+
+    // The first row is filled before starting a new one
+    ASSERT_EQUAL( placed[0].y, 0 );
+    ASSERT_EQUAL( placed[1].y, 0 );
+    ASSERT_EQUAL( placed[2].y, 0 );
+    ASSERT_TRUE( packer.getUsedHeight() <= 80 );
+    ASSERT_TRUE( packer.getOccupancy() > 0.0 && packer.getOccupancy() < 1.0 );
+
+    // Too big, or no room left
+    SDL_Point position;
+    ASSERT_FALSE( packer.insert( 257, 10, position ) );
+    ASSERT_FALSE( packer.insert( 10, 0, position ) );
+
+    unsigned int count = 0;
+    while ( packer.insert( 32, 32, position ) ) ++count;
+    ASSERT_TRUE( count > 30 );
+    ASSERT_FALSE( packer.insert( 32, 32, position ) );
+
+    packer.reset();
+    ASSERT_EQUAL( packer.getUsedHeight(), 0 );
+    ASSERT_TRUE( packer.insert( 256, 256, position ) );
+    ASSERT_EQUAL( position.x, 0 );
+    ASSERT_EQUAL( position.y, 0 );
+    ASSERT_FALSE( packer.insert( 1, 1, position ) );
+  }
+
+
+  SECTION( "Cooked Images" );
+  {
+    // Pitch is wider than the rows, which must be removed when cooking
+    int width = 37;
+    int height = 21;
+    int pitch = width * 4 + 12;
+    std::vector< unsigned char > pixels( pitch * height, 0xEE );
+    for ( int row = 0; row < height; ++row )
+    {
+      for ( int col = 0; col < width * 4; ++col )
+      {
+        pixels[ row * pitch + col ] = ( row * 7 + col / 8 ) % 251;
+      }
+    }
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom( pixels.data(), width, height, 32, pitch, REGOLITH_PIXEL_FORMAT );
+    ASSERT_TRUE( surface != nullptr );
+
+    std::vector< unsigned char > cooked;
+    cookImage( surface, cooked );
+    SDL_FreeSurface( surface );
+    ASSERT_TRUE( cooked.size() > sizeof( CookedImageHeader ) );
+    ASSERT_TRUE( cooked.size() < pixels.size() );
+
+    SDL_Surface* loaded = loadCookedImage( SDL_RWFromConstMem( cooked.data(), cooked.size() ) );
+    ASSERT_TRUE( loaded != nullptr );
+    ASSERT_EQUAL( loaded->w, width );
+    ASSERT_EQUAL( loaded->h, height );
+    ASSERT_EQUAL( loaded->format->format, (Uint32)REGOLITH_PIXEL_FORMAT );
+
+    bool matches = true;
+    for ( int row = 0; row < height; ++row )
+    {
+      if ( std::memcmp( (unsigned char*)loaded->pixels + row * loaded->pitch, pixels.data() + row * pitch, width * 4 ) != 0 ) matches = false;
+    }
+    ASSERT_TRUE( matches );
+    SDL_FreeSurface( loaded );
+
+    // Damaged files are rejected
+    std::vector< unsigned char > damaged( cooked );
+    damaged[0] = 'X';
+    ASSERT_TRUE( loadCookedImage( SDL_RWFromConstMem( damaged.data(), damaged.size() ) ) == nullptr );
+
+    damaged = cooked;
+    damaged.resize( damaged.size() - 5 );
+    ASSERT_TRUE( loadCookedImage( SDL_RWFromConstMem( damaged.data(), damaged.size() ) ) == nullptr );
+
+    ASSERT_TRUE( loadCookedImage( nullptr ) == nullptr );
+  }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  if ( ! testass::control::summarize() )
+  {
+    testass::control::printReport( std::cout );
+  }
+
+  testass::control::kill();
+  logtastic::stop();
+  return 0;
+}
+
@@ -0,0 +1,351 @@
+#define TESTASS_APPROX_LIMIT 1.0E-6
+
+#include "Regolith.h"
+#include "Regolith/Links/LinkCollisionManager.h"
+#include "Regolith/Collisions/SpriteCollision.h"
+#include "Regolith/Collisions/ContactCache.h"
+#include "Regolith/Collisions/ContactSolver.h"
+#include "Regolith/Handlers/CollisionHandler.h"
+
+#include "testass.h"
+#include "logtastic.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+
+
+using namespace Regolith;
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Rectangular box that moves out of its contacts
+class TestBox : public CollidableObject
+{
+  private:
+    SpriteCollision _collision;
+
+  public:
+    TestBox( float x, float y, float width, float height, bool moveable )
+    {
+      Json::Value json_data;
+      json_data["hit_boxes"][0][0]["position"][0] = 0.0;
+      json_data["hit_boxes"][0][0]["position"][1] = 0.0;
+      json_data["hit_boxes"][0][0]["width"] = width;
+      json_data["hit_boxes"][0][0]["height"] = height;
+      json_data["hit_boxes"][0][0]["type"] = "box";
+      _collision.configure( json_data );
+
+      setWidth( width );
+      setHeight( height );
+      setPosition( Vector( x, y ) );
+      setMass( moveable ? 1.0 : 0.0 );
+      setTranslatable( moveable );
+    }
+
+    virtual PhysicalObject* clone() const override { return new TestBox( *this ); }
+
+    virtual const Collision& getCollision() override { return _collision; }
+
+    virtual void onCollision( Contact& contact, CollidableObject* ) override
+    {
+      if ( ! hasTranslation() ) return;
+      move( contact.massRatio * contact.overlap * contact.normal );
+      kick( contact.impulse );
+    }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Drop a stack of four boxes on to a fixed floor. Returns the largest vertical speed and the deepest penetration of
+  // the bottom box into the floor, once the stack has had time to settle
+void simulateStack( Json::Value& config, float& max_velocity, float& max_penetration )
+{
+  const float floor_height = 100.0;
+  const float time_step = 16.0;
+
+  CollisionHandler handler;
+  handler.configure( config );
+
+  TestBox floor( 0.0, floor_height, 400.0, 20.0, false );
+  floor.updateWorldHitBoxes();
+
+  std::vector< TestBox* > boxes;
+  for ( unsigned int i = 0; i < 4; ++i )
+  {
+    boxes.push_back( new TestBox( 100.0, floor_height - 20.5 - 21.0*i, 20.0, 20.0, true ) );
+  }
+
+  BroadPhase::PairList pairs;
+  for ( unsigned int i = 0; i < boxes.size(); ++i )
+  {
+    pairs.push_back( std::make_pair( &floor, boxes[i] ) );
+    for ( unsigned int j = i+1; j < boxes.size(); ++j )
+    {
+      pairs.push_back( std::make_pair( boxes[i], boxes[j] ) );
+    }
+  }
+
+  max_velocity = 0.0;
+  max_penetration = 0.0;
+  for ( unsigned int frame = 0; frame < 600; ++frame )
+  {
+    handler.warmStart();
+
+    for ( std::vector< TestBox* >::iterator it = boxes.begin(); it != boxes.end(); ++it )
+    {
+      (*it)->addForce( Vector( 0.0, 0.001 ) );
+      (*it)->step( time_step );
+      (*it)->updateWorldHitBoxes();
+    }
+
+    handler.narrowPhase( pairs );
+    handler.resolveContacts( time_step );
+
+    if ( frame < 300 ) continue;
+
+    for ( std::vector< TestBox* >::iterator it = boxes.begin(); it != boxes.end(); ++it )
+    {
+      max_velocity = std::max( max_velocity, std::fabs( (*it)->getVelocity().y() ) );
+    }
+    max_penetration = std::max( max_penetration, boxes[0]->getPosition().y() + 20.0f - floor_height );
+  }
+
+  for ( std::vector< TestBox* >::iterator it = boxes.begin(); it != boxes.end(); ++it )
+  {
+    delete (*it);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Build a contact between the two boxes at the given point
+ContactPair makePair( TestBox* box1, TestBox* box2, Vector point, Vector normal )
+{
+  ContactPair pair;
+  pair.object1 = box1;
+  pair.object2 = box2;
+  pair.hitBox1 = 0;
+  pair.hitBox2 = 0;
+  pair.contact1.point = point;
+  pair.contact1.normal = normal;
+  pair.contact2.point = point;
+  pair.contact2.normal = -normal;
+  return pair;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main( int, char** )
+{
+  // Configure the logger first
+  logtastic::init();
+  logtastic::setLogFileDirectory( "./test_data/logs/" );
+  logtastic::setLogFile( "tests_contacts.log" );
+  logtastic::setPrintToScreenLimit( logtastic::off );
+
+  // Get link to the manager
+  Manager::createInstance();
+  Regolith::Link<Regolith::CollisionManager, Regolith::TestType> link_manager = Manager::getInstance()->getCollisionManager< Regolith::TestType >();
+  link_manager.addCollisionType( "box", 0 );
+
+  // Tell logging to start
+  logtastic::start( "Regolith - Contact Tests", REGOLITH_VERSION_NUMBER );
+
+  // Configure Testass
+  testass::control::init( "Regolith", "Contacts" );
+  testass::control::get()->setVerbosity( testass::control::verb_short );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  SECTION( "Contact Manifolds" );
+  {
+    TestBox box1( 0.0, 0.0, 10.0, 10.0, true );
+    TestBox box2( 0.0, 10.0, 10.0, 10.0, true );
+    Vector up( 0.0, -1.0 );
+
+    ContactCache cache;
+    cache.setMergeDistance( 2.0 );
+    ASSERT_EQUAL( cache.size(), (size_t)0 );
+
+    // A new point starts with no impulse
+    ContactPoint& point = cache.findPoint( makePair( &box1, &box2, Vector( 5.0, 10.0 ), up ) );
+    ASSERT_EQUAL( cache.size(), (size_t)1 );
+    ASSERT_APPROX_EQUAL( point.normalImpulse, 0.0 );
+    point.normalImpulse = -5.0;
+
+    // A nearby point in the next frame inherits it
+    cache.startFrame();
+    ContactPoint& merged = cache.findPoint( makePair( &box1, &box2, Vector( 5.5, 10.0 ), up ) );
+    ASSERT_EQUAL( cache.size(), (size_t)1 );
+    ASSERT_APPROX_EQUAL( merged.normalImpulse, -5.0 );
+
+    // Distant points and opposite normals are separate contacts
+    cache.startFrame();
+    ContactPoint& distant = cache.findPoint( makePair( &box1, &box2, Vector( 9.0, 10.0 ), up ) );
+    ASSERT_APPROX_EQUAL( distant.normalImpulse, 0.0 );
+    distant.normalImpulse = -1.0;
+
+    cache.startFrame();
+    ContactPoint& opposite = cache.findPoint( makePair( &box1, &box2, Vector( 9.0, 10.0 ), -up ) );
+    ASSERT_APPROX_EQUAL( opposite.normalImpulse, 0.0 );
+
+    // Each pair of hitboxes has its own manifold
+    ContactPair other = makePair( &box2, &box1, Vector( 5.0, 10.0 ), -up );
+    cache.findPoint( other );
+    ASSERT_EQUAL( cache.size(), (size_t)2 );
+
+    // Points that aren't refreshed are dropped, followed by the empty manifolds
+    cache.startFrame();
+    cache.findPoint( other );
+    cache.startFrame();
+    ASSERT_EQUAL( cache.size(), (size_t)1 );
+    cache.startFrame();
+    ASSERT_EQUAL( cache.size(), (size_t)0 );
+
+    cache.findPoint( other );
+    cache.clear();
+    ASSERT_EQUAL( cache.size(), (size_t)0 );
+  }
+
+
+  SECTION( "Warm Starting" );
+  {
+    Json::Value config;
+    config["team_collision"] = Json::Value( Json::arrayValue );
+    config["collision_rules"] = Json::Value( Json::arrayValue );
+    config["container_rules"] = Json::Value( Json::arrayValue );
+
+    float cold_velocity;
+    float cold_penetration;
+    config["warm_starting"] = false;
+    simulateStack( config, cold_velocity, cold_penetration );
+
+    float warm_velocity;
+    float warm_penetration;
+    config["warm_starting"] = true;
+    simulateStack( config, warm_velocity, warm_penetration );
+
+    // Resting contacts keep last frame's impulse, so the stack sinks and bounces much less
+    ASSERT_TRUE( warm_velocity < 0.5*cold_velocity );
+    ASSERT_TRUE( warm_penetration < 0.5*cold_penetration );
+    ASSERT_TRUE( warm_penetration < 1.0 );
+  }
+
+
+  SECTION( "Solver Configuration" );
+  {
+    ContactSolver solver;
+    Json::Value solver_data;
+    solver.configure( solver_data );
+    ASSERT_EQUAL( solver.getIterations(), 8u );
+    ASSERT_TRUE( solver.getPositionCorrection() == PositionCorrection::SplitImpulse );
+
+    solver_data["iterations"] = 12;
+    solver_data["position_correction"] = "baumgarte";
+    solver.configure( solver_data );
+    ASSERT_EQUAL( solver.getIterations(), 12u );
+    ASSERT_TRUE( solver.getPositionCorrection() == PositionCorrection::Baumgarte );
+
+    solver_data["position_correction"] = "teleport";
+    bool rejected = false;
+    try
+    {
+      solver.configure( solver_data );
+    }
+    catch ( Exception& )
+    {
+      rejected = true;
+    }
+    ASSERT_TRUE( rejected );
+  }
+
+
+  SECTION( "Sequential Impulse Solver" );
+  {
+    Json::Value config;
+    config["team_collision"] = Json::Value( Json::arrayValue );
+    config["collision_rules"] = Json::Value( Json::arrayValue );
+    config["container_rules"] = Json::Value( Json::arrayValue );
+    config["warm_starting"] = true;
+    config["solver"]["type"] = "sequential_impulse";
+    config["solver"]["iterations"] = 8;
+
+    float velocity;
+    float penetration;
+
+    // Split impulse only moves the objects, so the stack comes to a complete rest
+    config["solver"]["position_correction"] = "split_impulse";
+    simulateStack( config, velocity, penetration );
+    ASSERT_TRUE( velocity < 1.0E-4 );
+    ASSERT_TRUE( penetration < 0.2 );
+
+    // Baumgarte feeds the correction through the velocities, which leaves a little motion
+    config["solver"]["position_correction"] = "baumgarte";
+    simulateStack( config, velocity, penetration );
+    ASSERT_TRUE( velocity < 0.01 );
+    ASSERT_TRUE( penetration < 1.0 );
+
+    // Without warm starting the solver still beats resolving one contact at a time
+    float direct_velocity;
+    float direct_penetration;
+    Json::Value direct_config( config );
+    direct_config.removeMember( "solver" );
+    direct_config["warm_starting"] = false;
+    simulateStack( direct_config, direct_velocity, direct_penetration );
+
+    config["warm_starting"] = false;
+    config["solver"]["position_correction"] = "split_impulse";
+    simulateStack( config, velocity, penetration );
+    ASSERT_TRUE( velocity < direct_velocity );
+    ASSERT_TRUE( penetration < direct_penetration );
+  }
+
+
+  SECTION( "Immediate Resolution" );
+  {
+    Json::Value config;
+    config["team_collision"] = Json::Value( Json::arrayValue );
+    config["collision_rules"] = Json::Value( Json::arrayValue );
+    config["container_rules"] = Json::Value( Json::arrayValue );
+
+    CollisionHandler handler;
+    handler.configure( config );
+
+    TestBox box1( 0.0, 0.0, 10.0, 10.0, true );
+    TestBox box2( 0.0, 9.0, 10.0, 10.0, true );
+    box1.updateWorldHitBoxes();
+    box2.updateWorldHitBoxes();
+
+    BroadPhase::PairList pairs;
+    pairs.push_back( std::make_pair( &box1, &box2 ) );
+    handler.narrowPhase( pairs );
+    ASSERT_EQUAL( handler.contactCount(), (size_t)1 );
+
+    // Resolving another pair straight away keeps the contacts from the narrow phase
+    TestBox box3( 100.0, 0.0, 10.0, 10.0, true );
+    TestBox box4( 100.0, 9.0, 10.0, 10.0, true );
+    handler.collides( &box3, &box4 );
+    ASSERT_EQUAL( handler.contactCount(), (size_t)1 );
+    ASSERT_TRUE( box4.getPosition().y() - box3.getPosition().y() >= 10.0 - 1.0E-4 );
+
+    handler.resolveContacts( 16.0 );
+    ASSERT_EQUAL( handler.contactCount(), (size_t)0 );
+    ASSERT_TRUE( box2.getPosition().y() - box1.getPosition().y() >= 10.0 - 1.0E-4 );
+  }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  if ( ! testass::control::summarize() )
+  {
+    testass::control::printReport( std::cout );
+  }
+
+  testass::control::kill();
+  Manager::killInstance();
+  logtastic::stop();
+  return 0;
+}
+
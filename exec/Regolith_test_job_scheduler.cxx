@@ -0,0 +1,239 @@
+#include "Regolith.h"
+#include "Regolith/Utilities/JobScheduler.h"
+#include "Regolith/Managers/ThreadManager.h"
+
+#include "logtastic.h"
+#include "testass.h"
+
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <chrono>
+
+
+using namespace Regolith;
+
+
+// Sum the range recursively, waiting on nested jobs from inside a job
+long recursiveSum( JobScheduler& scheduler, const std::vector< long >& values, size_t start, size_t end )
+{
+  if ( end - start <= 1000 )
+  {
+    long sum = 0;
+    for ( size_t i = start; i < end; ++i ) sum += values[i];
+    return sum;
+  }
+
+  size_t middle = start + ( end - start ) / 2;
+  long left = 0;
+  long right = 0;
+
+  JobScheduler::Job* root = scheduler.create( [&](){ left = recursiveSum( scheduler, values, start, middle ); } );
+  scheduler.submit( root );
+  right = recursiveSum( scheduler, values, middle, end );
+  scheduler.wait( root );
+
+  return left + right;
+}
+
+
+int main( int, char** )
+{
+  logtastic::init();
+  logtastic::setLogFileDirectory( "./test_data/logs/" );
+  logtastic::setLogFile( "tests_job_scheduler.log" );
+  logtastic::setPrintToScreenLimit( logtastic::error );
+  logtastic::start( "Regolith - Job Scheduler Tests", REGOLITH_VERSION_NUMBER );
+
+  testass::control::init( "Regolith", "Job Scheduler" );
+  testass::control::get()->setVerbosity( testass::control::verb_short );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  const size_t number = 100000;
+  std::vector< long > values( number );
+  long expected = 0;
+  for ( size_t i = 0; i < number; ++i )
+  {
+    values[i] = i % 97;
+    expected += values[i];
+  }
+
+
+  SECTION( "No Workers" );
+  {
+    // Waiting threads execute the jobs themselves
+    JobScheduler scheduler;
+    ASSERT_EQUAL( scheduler.size(), 0u );
+
+    std::vector< int > visits( number, 0 );
+    scheduler.parallelFor( number, 1000, [&]( size_t start, size_t end )
+    {
+      for ( size_t i = start; i < end; ++i ) ++visits[i];
+    } );
+
+    bool all_once = true;
+    for ( size_t i = 0; i < number; ++i ) all_once = all_once && ( visits[i] == 1 );
+    ASSERT_TRUE( all_once );
+  }
+
+
+  SECTION( "Parallel For" );
+  {
+    JobScheduler scheduler;
+    scheduler.start( 4 );
+    ASSERT_EQUAL( scheduler.size(), 4u );
+
+    std::vector< std::atomic< int > > visits( number );
+    for ( size_t i = 0; i < number; ++i ) visits[i] = 0;
+
+    std::atomic< long > sum( 0 );
+    scheduler.parallelFor( number, 997, [&]( size_t start, size_t end )
+    {
+      long partial = 0;
+      for ( size_t i = start; i < end; ++i )
+      {
+        ++visits[i];
+        partial += values[i];
+      }
+      sum += partial;
+    } );
+
+    bool all_once = true;
+    for ( size_t i = 0; i < number; ++i ) all_once = all_once && ( visits[i] == 1 );
+    ASSERT_TRUE( all_once );
+    ASSERT_EQUAL( sum.load(), expected );
+
+    // Empty ranges do nothing
+    bool called = false;
+    scheduler.parallelFor( 0, 10, [&]( size_t, size_t ){ called = true; } );
+    ASSERT_FALSE( called );
+
+    scheduler.stop();
+    ASSERT_EQUAL( scheduler.size(), 0u );
+  }
+
+
+  SECTION( "Dependencies" );
+  {
+    JobScheduler scheduler;
+    scheduler.start( 3 );
+
+    // Children created inside the root's task must all finish before the root does
+    std::atomic< int > children_finished( 0 );
+    JobScheduler::Job* root = nullptr;
+    root = scheduler.create( [&]()
+    {
+      for ( unsigned int i = 0; i < 50; ++i )
+      {
+        JobScheduler::Job* child = scheduler.create( [&]()
+        {
+          // Grandchildren of the root
+          for ( unsigned int j = 0; j < 4; ++j )
+          {
+            scheduler.submit( scheduler.create( [&](){ ++children_finished; }, root ) );
+          }
+          ++children_finished;
+        }, root );
+        scheduler.submit( child );
+      }
+    } );
+    scheduler.submit( root );
+    scheduler.wait( root );
+
+    ASSERT_EQUAL( children_finished.load(), 250 );
+
+    // Nested waits from inside jobs
+    ASSERT_EQUAL( recursiveSum( scheduler, values, 0, number ), expected );
+  }
+
+
+  SECTION( "Exceptions" );
+  {
+    JobScheduler scheduler;
+    scheduler.start( 2 );
+
+    bool caught = false;
+    try
+    {
+      scheduler.parallelFor( 100, 10, []( size_t start, size_t )
+      {
+        if ( start == 50 ) throw std::runtime_error( "Job failure" );
+      } );
+    }
+    catch ( std::runtime_error& )
+    {
+      caught = true;
+    }
+    ASSERT_TRUE( caught );
+
+    // The scheduler is still usable
+    std::atomic< int > count( 0 );
+    scheduler.parallelFor( 100, 10, [&]( size_t start, size_t end ){ count += end - start; } );
+    ASSERT_EQUAL( count.load(), 100 );
+
+    // Children can't be waited on directly
+    JobScheduler::Job* root = scheduler.create( [](){} );
+    JobScheduler::Job* child = scheduler.create( [](){}, root );
+    bool rejected = false;
+    try
+    {
+      scheduler.wait( child );
+    }
+    catch ( Exception& )
+    {
+      rejected = true;
+    }
+    ASSERT_TRUE( rejected );
+
+    scheduler.submit( child );
+    scheduler.submit( root );
+    scheduler.wait( root );
+  }
+
+
+  SECTION( "Error Flag" );
+  {
+    JobScheduler scheduler;
+    scheduler.start( 3 );
+
+    // Raise the error part way through. The remaining blocks are discarded, but the wait must not return while any
+    // block is still executing, as they all use this stack frame
+    std::atomic< int > executing( 0 );
+    std::atomic< int > executed( 0 );
+
+    scheduler.parallelFor( 1000, 1, [&]( size_t start, size_t )
+    {
+      ++executing;
+      if ( start == 20 ) ThreadManager::ErrorFlag = true;
+      std::this_thread::sleep_for( std::chrono::microseconds( 200 ) );
+      ++executed;
+      --executing;
+    } );
+
+    ASSERT_EQUAL( executing.load(), 0 );
+    ASSERT_TRUE( executed.load() < 1000 );
+
+    ThreadManager::ErrorFlag = false;
+
+    // The scheduler recovers once the flag is cleared
+    std::atomic< int > count( 0 );
+    scheduler.parallelFor( 100, 10, [&]( size_t start, size_t end ){ count += end - start; } );
+    ASSERT_EQUAL( count.load(), 100 );
+
+    scheduler.stop();
+  }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  if ( ! testass::control::summarize() )
+  {
+    testass::control::printReport( std::cout );
+  }
+
+  testass::control::kill();
+  logtastic::stop();
+  return 0;
+}
+
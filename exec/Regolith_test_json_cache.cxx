@@ -0,0 +1,165 @@
+#include "Regolith.h"
+#include "Regolith/Utilities/JsonCache.h"
+#include "Regolith/Utilities/JsonValidation.h"
+
+#include "logtastic.h"
+#include "testass.h"
+
+#include <fstream>
+#include <cstdio>
+#include <thread>
+#include <chrono>
+
+
+using namespace Regolith;
+
+
+void writeFile( const char* filename, const char* contents )
+{
+  std::ofstream output( filename );
+  output << contents;
+}
+
+
+int main( int, char** )
+{
+  logtastic::init();
+  logtastic::setLogFileDirectory( "./test_data/logs/" );
+  logtastic::setLogFile( "tests_json_cache.log" );
+  logtastic::setPrintToScreenLimit( logtastic::error );
+  logtastic::start( "Regolith - Json Cache Tests", REGOLITH_VERSION_NUMBER );
+
+  testass::control::init( "Regolith", "Json Cache" );
+  testass::control::get()->setVerbosity( testass::control::verb_short );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  const char* file1 = "./test_data/json_cache_test_1.json";
+  const char* file2 = "./test_data/json_cache_test_2.json";
+  writeFile( file1, "{ \"value\" : 1 }" );
+  writeFile( file2, "{ \"value\" : 2, \"padding\" : \"xxxxxxxxxxxxxxxx\" }" );
+
+  JsonCache& cache = JsonCache::getInstance();
+  cache.clear();
+
+
+  SECTION( "Cache Hits" );
+  {
+    Json::Value data;
+    unsigned long misses = cache.getMisses();
+    unsigned long hits = cache.getHits();
+
+    loadJsonData( data, file1 );
+    ASSERT_EQUAL( data["value"].asInt(), 1 );
+    ASSERT_EQUAL( cache.getMisses(), misses + 1 );
+    ASSERT_EQUAL( cache.size(), 1u );
+
+    // Modifying the copy must not change the cached document
+    data["value"] = 10;
+
+    Json::Value data2;
+    loadJsonData( data2, file1 );
+    ASSERT_EQUAL( data2["value"].asInt(), 1 );
+    ASSERT_EQUAL( cache.getHits(), hits + 1 );
+    ASSERT_EQUAL( cache.getMisses(), misses + 1 );
+  }
+
+
+  SECTION( "Modified Files" );
+  {
+    // Different size, so the change is seen even within the same second
+    writeFile( file1, "{ \"value\" : 100 }" );
+
+    unsigned long misses = cache.getMisses();
+    Json::Value data;
+    loadJsonData( data, file1 );
+    ASSERT_EQUAL( data["value"].asInt(), 100 );
+    ASSERT_EQUAL( cache.getMisses(), misses + 1 );
+    ASSERT_EQUAL( cache.size(), 1u );
+
+#ifdef __linux__
+    // Same size within the same second. Only the sub-second modification time shows the change
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+    writeFile( file1, "{ \"value\" : 200 }" );
+    loadJsonData( data, file1 );
+    ASSERT_EQUAL( data["value"].asInt(), 200 );
+
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+    writeFile( file1, "{ \"value\" : 100 }" );
+    loadJsonData( data, file1 );
+    ASSERT_EQUAL( data["value"].asInt(), 100 );
+#endif
+  }
+
+
+  SECTION( "Invalidation" );
+  {
+    int owner1 = 0;
+    int owner2 = 0;
+    Json::Value data;
+
+    {
+      JsonCache::Scope scope( &owner1 );
+      loadJsonData( data, file1 );
+      loadJsonData( data, file2 );
+    }
+    {
+      JsonCache::Scope scope( &owner2 );
+      loadJsonData( data, file2 );
+    }
+    ASSERT_EQUAL( cache.size(), 2u );
+
+    // File 2 is still used by the second owner
+    cache.invalidate( &owner1 );
+    ASSERT_EQUAL( cache.size(), 1u );
+
+    cache.invalidate( &owner2 );
+    ASSERT_EQUAL( cache.size(), 0u );
+    ASSERT_EQUAL( cache.getFileSizeUsed(), 0u );
+  }
+
+
+  SECTION( "File Size Limit" );
+  {
+    Json::Value data;
+    loadJsonData( data, file1 );
+    size_t size1 = cache.getFileSizeUsed();
+    loadJsonData( data, file2 );
+    size_t size2 = cache.getFileSizeUsed() - size1;
+    ASSERT_EQUAL( cache.size(), 2u );
+
+    // Only room for the larger file. The least recently used is discarded
+    cache.setFileSizeLimit( size2 );
+    ASSERT_EQUAL( cache.size(), 1u );
+    ASSERT_EQUAL( cache.getFileSizeUsed(), size2 );
+
+    loadJsonData( data, file1 );
+    ASSERT_EQUAL( data["value"].asInt(), 100 );
+    ASSERT_EQUAL( cache.size(), 1u );
+    ASSERT_EQUAL( cache.getFileSizeUsed(), size1 );
+
+    // Too big to cache at all
+    cache.setFileSizeLimit( 1 );
+    loadJsonData( data, file2 );
+    ASSERT_EQUAL( data["value"].asInt(), 2 );
+    ASSERT_EQUAL( cache.size(), 0u );
+
+    cache.setFileSizeLimit( 32*1024*1024 );
+  }
+
+  cache.clear();
+  std::remove( file1 );
+  std::remove( file2 );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  if ( ! testass::control::summarize() )
+  {
+    testass::control::printReport( std::cout );
+  }
+
+  testass::control::kill();
+  logtastic::stop();
+  return 0;
+}
+
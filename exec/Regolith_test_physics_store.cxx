@@ -0,0 +1,157 @@
+#define TESTASS_APPROX_LIMIT 1.0E-6
+
+#include "Regolith.h"
+
+#include "testass.h"
+#include "logtastic.h"
+
+#include <iostream>
+
+
+using namespace Regolith;
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Object that moves at a constant velocity and opts in to the physics store
+class TestBall : public PhysicalObject
+{
+  public:
+    TestBall( Vector position, Vector velocity )
+    {
+      setPosition( position );
+      setMass( 1.0 );
+      setTranslatable( true );
+      setVelocity( velocity );
+    }
+
+    virtual PhysicalObject* clone() const override { return new TestBall( *this ); }
+
+    virtual bool usesPhysicsStore() const override { return true; }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Context with a single layer that does nothing but the physics update
+class SharedContext : public Context
+{
+  protected:
+    virtual void updateContext( float ) override {}
+
+    virtual Vector updateCamera( float ) const override { return Vector(); }
+
+    virtual void updatePhysics( PhysicalObject*, float ) const override {}
+
+    virtual void renderContext( RenderQueue& ) override {}
+
+  public:
+    virtual bool overridesPreviousContext() const override { return false; }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+  // Configuration for a context with the physics store enabled and an empty layer
+Json::Value buildContextData()
+{
+  Json::Value json_data;
+  json_data["physics_store"] = true;
+  json_data["collision_handling"]["team_collision"] = Json::Value( Json::arrayValue );
+  json_data["collision_handling"]["collision_rules"] = Json::Value( Json::arrayValue );
+  json_data["collision_handling"]["container_rules"] = Json::Value( Json::arrayValue );
+
+  Json::Value& layer = json_data["layers"]["main"];
+  layer["position"][0] = 0.0;
+  layer["position"][1] = 0.0;
+  layer["movement_scale"][0] = 1.0;
+  layer["movement_scale"][1] = 1.0;
+  layer["width"] = 1000.0;
+  layer["height"] = 1000.0;
+  layer["objects"] = Json::Value( Json::arrayValue );
+  layer["spawns"] = Json::Value( Json::arrayValue );
+
+  return json_data;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main( int, char** )
+{
+  // Configure the logger first
+  logtastic::init();
+  logtastic::setLogFileDirectory( "./test_data/logs/" );
+  logtastic::setLogFile( "tests_physics_store.log" );
+  logtastic::setPrintToScreenLimit( logtastic::off );
+
+  // Tell logging to start
+  logtastic::start( "Regolith - Physics Store Tests", REGOLITH_VERSION_NUMBER );
+
+  // Configure Testass
+  testass::control::init( "Regolith", "Physics Store" );
+  testass::control::get()->setVerbosity( testass::control::verb_short );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  SECTION( "Shared Objects" );
+  {
+    // The ball must outlive the stores that hold it
+    TestBall ball( Vector( 0.0, 0.0 ), Vector( 1.0, 0.0 ) );
+
+    ContextGroup group;
+    Json::Value context_data = buildContextData();
+
+    SharedContext first;
+    first.configure( context_data, group );
+    SharedContext second;
+    second.configure( context_data, group );
+
+    ASSERT_TRUE( first.getPhysicsStore() != nullptr );
+    ASSERT_TRUE( second.getPhysicsStore() != nullptr );
+
+    // Placing the ball in a second context takes it over from the first store
+    first.getLayer( "main" ).addObject( &ball );
+    ASSERT_TRUE( ball.getPhysicsStore() == first.getPhysicsStore() );
+    second.getLayer( "main" ).addObject( &ball );
+    ASSERT_TRUE( ball.getPhysicsStore() == second.getPhysicsStore() );
+    ASSERT_EQUAL( first.getPhysicsStore()->size(), (size_t)0 );
+    ASSERT_EQUAL( second.getPhysicsStore()->size(), (size_t)1 );
+
+    // Both contexts move the ball, whichever store holds it
+    first.update( 10.0 );
+    ASSERT_APPROX_EQUAL( ball.getPosition().x(), 10.0 );
+    second.update( 10.0 );
+    ASSERT_APPROX_EQUAL( ball.getPosition().x(), 20.0 );
+
+    // Stopping the owning context hands the ball back to the one that is still running
+    second.stopContext();
+    ASSERT_TRUE( ball.getPhysicsStore() == nullptr );
+    ASSERT_APPROX_EQUAL( ball.getPosition().x(), 20.0 );
+    ASSERT_APPROX_EQUAL( ball.getVelocity().x(), 1.0 );
+
+    first.update( 10.0 );
+    ASSERT_APPROX_EQUAL( ball.getPosition().x(), 30.0 );
+
+    // Starting a context reclaims its objects
+    first.startContext();
+    ASSERT_TRUE( ball.getPhysicsStore() == first.getPhysicsStore() );
+    first.update( 10.0 );
+    ASSERT_APPROX_EQUAL( ball.getPosition().x(), 40.0 );
+
+    second.startContext();
+    ASSERT_TRUE( ball.getPhysicsStore() == second.getPhysicsStore() );
+    first.update( 10.0 );
+    ASSERT_APPROX_EQUAL( ball.getPosition().x(), 50.0 );
+    ASSERT_APPROX_EQUAL( ball.previousPosition().x(), 40.0 );
+  }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  if ( ! testass::control::summarize() )
+  {
+    testass::control::printReport( std::cout );
+  }
+
+  testass::control::kill();
+  logtastic::stop();
+  return 0;
+}
+
@@ -4,6 +4,7 @@
 
 #include "Regolith/Global/Global.h"
 #include "Regolith/Architecture/GameObject.h"
+#include "Regolith/Architecture/PhysicsStore.h"
 #include "Regolith/Utilities/BoundingBox.h"
 
 
@@ -20,6 +21,8 @@ namespace Regolith
    */
   class PhysicalObject : virtual public GameObject
   {
+    friend class PhysicsStore;
+
     private:
       // Flag that this object is to be removed from the scene
       bool _destroyMe;
@@ -30,11 +33,18 @@ namespace Regolith
       bool _hasRotatable;
       // Flag to indicate this object responds to global physics
       bool _hasPhysics;
+      // Flag to indicate this object moves fast enough to require swept collision tests
+      bool _isBullet;
 
       // Position with respect to the parent object
       Vector _position;
+      // Position at the start of the last step
+      Vector _previousPosition;
       // Rotation with respect to the parent object
       float _rotation;
+      // Transform at the start of the last update. Rendering interpolates from here to the current transform
+      Vector _lastFramePosition;
+      float _lastFrameRotation;
       // Flip flag
       SDL_RendererFlip _flipFlag;
 
@@ -65,6 +75,25 @@ namespace Regolith
       CollisionTeam _collisionTeam;
 
 
+      // Flag that the object is at rest and is skipped by the physics and collision processes
+      bool _sleeping;
+      // Number of consecutive frames the object has been below the sleep thresholds
+      unsigned int _restFrames;
+
+      // Union-find parent used to group touching objects into islands that sleep and wake together
+      PhysicalObject* _island;
+      // Flag on the island root that at least one member is still moving
+      bool _islandAwake;
+
+      // Store holding the dynamic state while the object is attached to one. The members above are stale until then
+      PhysicsStore* _physicsStore;
+      size_t _physicsSlot;
+
+
+      // Push the mass properties and flags into the physics store slot, if there is one
+      void updatePhysicsSlot();
+
+
     protected :
       // Copy constructor - protected so only way to duplicate objects is through the "clone" function
       PhysicalObject( const PhysicalObject& );
@@ -89,10 +118,10 @@ namespace Regolith
       void setInertiaDensity( float );
 
       // For derived classes to set the moveable flag
-      void setTranslatable( bool t ) { _hasTranslatable = t; }
+      void setTranslatable( bool t ) { _hasTranslatable = t; updatePhysicsSlot(); }
 
       // For derived classes to set the moveable flag
-      void setRotatable( bool r ) { _hasRotatable = r; }
+      void setRotatable( bool r ) { _hasRotatable = r; updatePhysicsSlot(); }
 
       // For derived classes to set whether this object is affected by global physics effects
       void setPhysics( bool p ) { _hasPhysics = p; }
@@ -142,6 +171,10 @@ namespace Regolith
       // Tells the caller that the is animated for every frame
       virtual bool hasPhysics() const { return _hasPhysics; }
 
+      // Tells the caller that the motion of each step must be swept for collisions
+      bool isBullet() const { return _isBullet; }
+      void setBullet( bool b ) { _isBullet = b; }
+
 
 ////////////////////////////////////////////////////////////////////////////////
       // Controlling object permanence within the context
@@ -163,28 +196,85 @@ namespace Regolith
       // Perform the time integration for movement of this object
       virtual void step( float );
 
+      // Cut the last step short. Moves the object back to the given fraction of the way along it.
+      void clampStep( float );
+
+      // Record the current transform as the start of the next update
+      void storeTransform() { _lastFramePosition = getPosition(); _lastFrameRotation = getRotation(); }
+
+      // Transform at the given fraction of the way from the start of the last update to now
+      Vector interpolatePosition( float f ) const { return _lastFramePosition + f * ( getPosition() - _lastFramePosition ); }
+      float interpolateRotation( float f ) const { return _lastFrameRotation + f * ( getRotation() - _lastFrameRotation ); }
+
+      // Position before the last step
+      Vector previousPosition() const { return ( _physicsStore == nullptr ? _previousPosition : _physicsStore->getPreviousPosition( _physicsSlot ) ); }
+
+
+      // Return true if this type may be integrated by the context's physics store instead of step().
+      // Opt-in per type. Types that override step() must leave this false or their step will never be called.
+      virtual bool usesPhysicsStore() const { return false; }
+
+      // Return true if the object currently has a slot in a physics store
+      bool hasPhysicsSlot() const { return _physicsStore != nullptr; }
+
+      // Return the physics store that holds the object's state, or nullptr if it has no slot
+      PhysicsStore* getPhysicsStore() const { return _physicsStore; }
+
+
+////////////////////////////////////////////////////////////////////////////////
+      // Sleeping and islands
+
+      // Return true if the object is at rest and is being skipped
+      bool isSleeping() const { return _sleeping; }
+
+      // Wake the object and the island it fell asleep with. Does nothing if it is already awake
+      void wake();
+
+      // Put the object to sleep. Clears the velocities and any accumulated forces
+      void sleep();
+
+      // Count the frames the object has stayed below the linear and angular speed thresholds
+      void updateRest( float, float );
+
+      // Number of consecutive frames spent below the sleep thresholds
+      unsigned int getRestFrames() const { return _restFrames; }
+
+
+      // Make the object the only member of its own island
+      void resetIsland() { _island = this; _islandAwake = false; }
+
+      // Return the root object of the island
+      PhysicalObject* findIsland();
+
+      // Merge the island of the other object into this one
+      void joinIsland( PhysicalObject* );
+
+      // Flag the island as containing a moving object. Only meaningful on the root
+      void setIslandAwake() { _islandAwake = true; }
+      bool isIslandAwake() const { return _islandAwake; }
+
 
 
 ////////////////////////////////////////////////////////////////////////////////
       // Object property accessors and modifiers
 
       // Preferred methods for changing position/rotation
-      void move( Vector m ) { _position += m; }
-      void rotate( float r ) { _rotation += r; }
+      void move( Vector m ) { setPosition( getPosition() + m ); }
+      void rotate( float r ) { setRotation( getRotation() + r ); }
 
 
       // For derived classes to impose a force
-      void addForce( Vector f ) { _forces += f; }
+      void addForce( Vector f );
 
       // Forces an immediate acceleration of the object. Used mostly to apply impulses from collisions
-      void kick( Vector& k ) { _velocity += k; }
+      void kick( Vector& k ) { setVelocity( getVelocity() + k ); wake(); }
 
 
       // For derived classes to impose a torque
-      void addTorque( float t ) { _torques += t; }
+      void addTorque( float t );
 
       // Forces an immediate rotational acceleration of the object. Used mostly to apply angular impulses from collisions
-      void spin( float s ) { _angularVel += s; }
+      void spin( float s ) { setAngularVelocity( getAngularVelocity() + s ); wake(); }
 
 
 
@@ -208,25 +298,25 @@ namespace Regolith
       // Collision physics accessors
       float getElasticity() const { return _elasticity; }
 
-      // Position set/get
-      const Vector& position() const { return _position; }
-      Vector getPosition() const { return _position; }
-      void setPosition( Vector p ) { _position = p; }
+      // Position set/get. Forwarded to the physics store slot while attached, so returned by value
+      Vector position() const { return getPosition(); }
+      Vector getPosition() const { return ( _physicsStore == nullptr ? _position : _physicsStore->getPosition( _physicsSlot ) ); }
+      void setPosition( Vector p ) { if ( _physicsStore == nullptr ) _position = p; else _physicsStore->setPosition( _physicsSlot, p ); }
 
       // Velocity
-      const Vector& velocity() const { return _velocity; }
-      Vector getVelocity() const { return _velocity; }
-      void setVelocity( Vector v ) { _velocity = v; }
+      Vector velocity() const { return getVelocity(); }
+      Vector getVelocity() const { return ( _physicsStore == nullptr ? _velocity : _physicsStore->getVelocity( _physicsSlot ) ); }
+      void setVelocity( Vector v ) { if ( _physicsStore == nullptr ) _velocity = v; else _physicsStore->setVelocity( _physicsSlot, v ); }
 
       // Rotation set/get
-      const float& rotation() const { return _rotation; }
-      float getRotation() const { return _rotation; }
-      void setRotation( float r ) { _rotation = r; }
+      float rotation() const { return getRotation(); }
+      float getRotation() const { return ( _physicsStore == nullptr ? _rotation : _physicsStore->getRotation( _physicsSlot ) ); }
+      void setRotation( float r ) { if ( _physicsStore == nullptr ) _rotation = r; else _physicsStore->setRotation( _physicsSlot, r ); }
 
       // Velocity
-      const float& angularVelocity() const { return _angularVel; }
-      float getAngularVelocity() const { return _angularVel; }
-      void setAngularVelocity( float a ) { _angularVel = a; }
+      float angularVelocity() const { return getAngularVelocity(); }
+      float getAngularVelocity() const { return ( _physicsStore == nullptr ? _angularVel : _physicsStore->getAngularVelocity( _physicsSlot ) ); }
+      void setAngularVelocity( float a ) { if ( _physicsStore == nullptr ) _angularVel = a; else _physicsStore->setAngularVelocity( _physicsSlot, a ); }
 
       // Flip state
       SDL_RendererFlip getFlipFlag() const { return _flipFlag; }
@@ -0,0 +1,128 @@
+
+#ifndef REGOLITH_ARCHITECTURE_PHYSICS_STORE_H_
+#define REGOLITH_ARCHITECTURE_PHYSICS_STORE_H_
+
+#include "Regolith/Global/Global.h"
+
+#include <vector>
+
+
+namespace Regolith
+{
+  // Forward declarations
+  class PhysicalObject;
+
+  /*
+   * Structure-of-arrays store for the dynamic state of the physical objects in a context.
+   *
+   * Objects that opt in are given a slot when they are added to a context layer and their position, velocity, forces,
+   * rotation and angular state are moved into the store. While attached, the PhysicalObject accessors forward to the
+   * slot and the context integrates every slot in a single vectorised pass instead of calling step() on each object.
+   * Detaching an object copies its state back so that it can be reset, respawned or used outside of the context.
+   * An object that is placed in several contexts lives in one store at a time. The other contexts step it through
+   * PhysicalObject::step, which forwards to the slot.
+   *
+   * Slots are kept dense by moving the last slot into the gap left by a detached object. The arrays are padded to a
+   * multiple of the SIMD width. Padding slots and objects that are asleep or fixed have zero masks so the kernel never
+   * needs to branch.
+   */
+  class PhysicsStore
+  {
+    private:
+      // Object that owns each slot
+      std::vector< PhysicalObject* > _owners;
+
+      // Linear state
+      std::vector< float > _positionX;
+      std::vector< float > _positionY;
+      std::vector< float > _previousX;
+      std::vector< float > _previousY;
+      std::vector< float > _velocityX;
+      std::vector< float > _velocityY;
+      std::vector< float > _forceX;
+      std::vector< float > _forceY;
+      std::vector< float > _inverseMass;
+
+      // Angular state
+      std::vector< float > _rotation;
+      std::vector< float > _angularVel;
+      std::vector< float > _torque;
+      std::vector< float > _inverseInertiaDensity;
+
+      // Integration masks. One for awake objects that can translate/rotate/move at all, zero otherwise
+      std::vector< float > _translateMask;
+      std::vector< float > _rotateMask;
+      std::vector< float > _moveMask;
+
+
+      // Resize all the arrays to hold at least the given number of slots, padded to the SIMD width
+      void reserveSlots( size_t );
+
+      // Copy one slot into another
+      void copySlot( size_t, size_t );
+
+      // Zero a slot so that it has no effect on the kernel
+      void clearSlot( size_t );
+
+    public:
+      // Con/Destruction
+      PhysicsStore();
+      ~PhysicsStore();
+
+      // Slots are referenced by the objects, so the store can't be copied
+      PhysicsStore( const PhysicsStore& ) = delete;
+      PhysicsStore& operator=( const PhysicsStore& ) = delete;
+
+
+      // Move the object's state into a new slot. Does nothing if the object is already in this store, and takes it over
+      // from any other store that holds it
+      void attach( PhysicalObject* );
+
+      // Copy the state back into the object and release its slot
+      void detach( PhysicalObject* );
+
+      // Detach all the objects
+      void clear();
+
+      // Return the number of occupied slots
+      size_t size() const { return _owners.size(); }
+
+
+      // Integrate every slot by a single Euler step of the given length. Matches PhysicalObject::step
+      void integrate( float );
+
+      // Integrate a single slot. Used when an object is stepped by a context that doesn't own the store
+      void step( size_t, float );
+
+
+////////////////////////////////////////////////////////////////////////////////
+      // Slot accessors
+
+      Vector getPosition( size_t s ) const { return Vector( _positionX[s], _positionY[s] ); }
+      void setPosition( size_t s, const Vector& p ) { _positionX[s] = p.x(); _positionY[s] = p.y(); }
+
+      Vector getPreviousPosition( size_t s ) const { return Vector( _previousX[s], _previousY[s] ); }
+
+      Vector getVelocity( size_t s ) const { return Vector( _velocityX[s], _velocityY[s] ); }
+      void setVelocity( size_t s, const Vector& v ) { _velocityX[s] = v.x(); _velocityY[s] = v.y(); }
+
+      Vector getForces( size_t s ) const { return Vector( _forceX[s], _forceY[s] ); }
+      void setForces( size_t s, const Vector& f ) { _forceX[s] = f.x(); _forceY[s] = f.y(); }
+
+      float getRotation( size_t s ) const { return _rotation[s]; }
+      void setRotation( size_t s, float r ) { _rotation[s] = r; }
+
+      float getAngularVelocity( size_t s ) const { return _angularVel[s]; }
+      void setAngularVelocity( size_t s, float a ) { _angularVel[s] = a; }
+
+      float getTorque( size_t s ) const { return _torque[s]; }
+      void setTorque( size_t s, float t ) { _torque[s] = t; }
+
+      // Refresh the mass properties and integration flags of a slot from its owner
+      void updateSlot( size_t );
+  };
+
+}
+
+#endif // REGOLITH_ARCHITECTURE_PHYSICS_STORE_H_
+
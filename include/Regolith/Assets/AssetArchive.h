@@ -0,0 +1,162 @@
+
+#ifndef REGOLITH_ASSETS_ASSET_ARCHIVE_H_
+#define REGOLITH_ASSETS_ASSET_ARCHIVE_H_
+
+#include "Regolith/Global/Global.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+
+
+namespace Regolith
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Archive file layout
+  /*
+   * A packed asset archive is a single file containing:
+   *   - An ArchiveHeader
+   *   - A hash table of ArchiveEntry slots, using open addressing with linear probing
+   *   - The entry names, used to confirm a hash match
+   *   - The entry data, each blob starting on an archiveAlignment boundary
+   * All values are stored little-endian. Entries are looked up by the path of the asset in the index file, so an
+   * archive can replace the loose files without changing the index.
+   */
+
+  const char archiveMagic[4] = { 'R', 'G', 'P', 'K' };
+  const uint32_t archiveVersion = 1;
+  const uint64_t archiveAlignment = 64;
+
+  enum ArchiveEntryFlags : uint32_t
+  {
+    ARCHIVE_ENTRY_USED = 1,
+    ARCHIVE_ENTRY_LZ4 = 2
+  };
+
+
+  struct ArchiveHeader
+  {
+    char magic[4];
+    uint32_t version;
+    uint32_t numberEntries;
+    uint32_t tableSize;
+    uint64_t tableOffset;
+    uint64_t namesOffset;
+  };
+
+
+  struct ArchiveEntry
+  {
+    uint64_t hash;
+    uint64_t offset;
+    uint64_t size;
+    uint64_t rawSize;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t flags;
+    uint32_t padding;
+  };
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Archive reader
+
+  /*
+   * Memory maps an archive and serves its entries as SDL_RWops, so the SDL loaders read directly from the mapped
+   * pages. Compressed entries are decompressed into a buffer that is freed when the SDL_RWops is closed.
+   * The mapping must outlive every SDL_RWops that has been opened, including the streamed music and open fonts.
+   * All the const member functions are safe to call from multiple threads.
+   */
+  class AssetArchive
+  {
+    private:
+      std::string _fileName;
+
+      const unsigned char* _data;
+      size_t _size;
+
+      const ArchiveHeader* _header;
+      const ArchiveEntry* _table;
+      const char* _names;
+
+
+      // Return the entry with the given name, or nullptr
+      const ArchiveEntry* find( const std::string& ) const;
+
+    public:
+      AssetArchive();
+
+      ~AssetArchive();
+
+      AssetArchive( const AssetArchive& ) = delete;
+      AssetArchive& operator=( const AssetArchive& ) = delete;
+
+
+      // Map an archive file, replacing any open archive
+      void open( std::string );
+
+      // Unmap the archive
+      void close();
+
+      // Return true if an archive is mapped
+      bool isOpen() const { return _data != nullptr; }
+
+      // Return the number of entries
+      size_t size() const;
+
+
+      // Return true if the archive contains the named entry
+      bool contains( const std::string& ) const;
+
+      // Open the named entry for reading. Returns nullptr if it isn't in the archive. The caller must close it
+      SDL_RWops* openEntry( const std::string& ) const;
+
+
+      // Hash used for the entry names
+      static uint64_t hashName( const std::string& );
+  };
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Archive writer
+
+  // Collects entries in memory and writes them out as a single archive
+  class AssetArchiveWriter
+  {
+    private:
+      struct Blob
+      {
+        std::vector< unsigned char > data;
+        uint64_t rawSize;
+        bool compressed;
+      };
+
+      typedef std::map< std::string, Blob > BlobMap;
+
+      BlobMap _blobs;
+
+    public:
+      AssetArchiveWriter();
+
+      // Add a block of memory. Compressed data is only kept if it is smaller
+      void addData( std::string, const unsigned char*, size_t, bool compress = false );
+
+      // Add the contents of a file
+      void addFile( std::string, std::string, bool compress = false );
+
+      // Return true if an entry has been added with this name
+      bool contains( std::string ) const;
+
+      // Return the number of entries
+      size_t size() const { return _blobs.size(); }
+
+      // Write the archive file
+      void write( std::string ) const;
+  };
+
+}
+
+#endif // REGOLITH_ASSETS_ASSET_ARCHIVE_H_
+
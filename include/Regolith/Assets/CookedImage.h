@@ -0,0 +1,48 @@
+
+#ifndef REGOLITH_ASSETS_COOKED_IMAGE_H_
+#define REGOLITH_ASSETS_COOKED_IMAGE_H_
+
+#include "Regolith/Global/Global.h"
+
+#include <cstdint>
+#include <vector>
+
+
+namespace Regolith
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Cooked image file layout
+  /*
+   * Images prepared by the asset cooker are stored as a CookedImageHeader followed by the LZ4 compressed pixels.
+   * The pixels are tightly packed rows of a 32-bit SDL pixel format, normally the renderer's native format, so
+   * loading one is a single decompression straight into the surface with no image decoding or conversion.
+   * Colour keys are applied by the cooker, so the transparent pixels already have zero alpha.
+   */
+
+  const char cookedImageMagic[4] = { 'R', 'G', 'C', 'I' };
+  const uint32_t cookedImageVersion = 1;
+
+  struct CookedImageHeader
+  {
+    char magic[4];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;
+    uint32_t rawSize;
+    uint32_t compressedSize;
+    uint32_t padding;
+  };
+
+
+  // Decode a cooked image into a new surface and close the file. Returns nullptr and sets the SDL error on failure
+  SDL_Surface* loadCookedImage( SDL_RWops* );
+
+  // Cook a 32-bit surface into the contents of a cooked image file
+  void cookImage( SDL_Surface*, std::vector< unsigned char >& );
+
+}
+
+#endif // REGOLITH_ASSETS_COOKED_IMAGE_H_
+
@@ -16,8 +16,8 @@ namespace Regolith
   };
 
 
-  // Function to load the Mix_Music object from the music file
-  RawMusic loadRawMusic( AudioDetail );
+  // Function to load the Mix_Music object from the music file. Takes ownership of the file
+  RawMusic loadRawMusic( AudioDetail, SDL_RWops* );
 
 }
 
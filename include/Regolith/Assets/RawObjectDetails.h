@@ -28,6 +28,14 @@ namespace Regolith
     unsigned int rows;
     unsigned int columns;
     SDL_Color colourkey;
+
+    // Image has been pre-decoded by the asset cooker
+    bool cooked;
+
+    // Name of the atlas image this one is packed into and its position within it. Empty if it isn't packed
+    std::string atlas;
+    int x;
+    int y;
   };
 
 
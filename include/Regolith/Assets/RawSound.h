@@ -16,8 +16,8 @@ namespace Regolith
   };
 
 
-  // Function that loads the sound file into the RawSound proxy
-  RawSound loadRawSound( AudioDetail );
+  // Function that loads the sound file into the RawSound proxy. Takes ownership of the file
+  RawSound loadRawSound( AudioDetail, SDL_RWops* );
 
 }
 
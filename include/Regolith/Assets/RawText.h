@@ -16,8 +16,8 @@ namespace Regolith
   };
 
 
-  // Function that loads the text from the text file into the RawText proxy
-  RawText loadRawText( TextDetail );
+  // Function that loads the text from the text file into the RawText proxy. Takes ownership of the file
+  RawText loadRawText( TextDetail, SDL_RWops* );
 
 }
 
@@ -15,6 +15,9 @@ namespace Regolith
    * Stores details are specfic to the sdl_texture it points to.
    * Remember that multiple textures may use the same SDL_Texture during rendering.
    * Hence all modifications - e.g. rotations, etc must be applied to the Texture objects, not the RawTexture.
+   *
+   * Images packed into an atlas don't own a surface. They point to the atlas's RawTexture and give the position of
+   * the image within it.
    */
   struct RawTexture
   {
@@ -25,13 +28,17 @@ namespace Regolith
     unsigned short int rows;
     unsigned short int columns;
     unsigned short cells;
+    int x;
+    int y;
+    RawTexture* atlas;
   };
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
   // Surface creation functions
 
-  RawTexture loadRawTexture( ImageDetail );
+  // Decode the image file into a surface. Takes ownership of the file
+  RawTexture loadRawTexture( ImageDetail, SDL_RWops* );
 }
 
 #endif // REGOLITH_ASSETS_RAW_TEXTURE_H_
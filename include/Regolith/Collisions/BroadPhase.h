@@ -0,0 +1,78 @@
+
+#ifndef REGOLITH_COLLISIONS_BROAD_PHASE_H_
+#define REGOLITH_COLLISIONS_BROAD_PHASE_H_
+
+#include "Regolith/Global/Global.h"
+
+#include <vector>
+#include <utility>
+
+
+namespace Regolith
+{
+  // Forward declarations
+  class CollidableObject;
+  class CollisionHandler;
+
+  /*
+   * Base class for the broad phase collision algorithms.
+   *
+   * Each context layer owns one broad phase. Every frame the layer tells it which objects are present by calling
+   * startUpdate() followed by insert() for each collidable object. findPairs() then fills a list with all the pairs of
+   * objects whose world-space AABBs overlap and whose teams are permitted to collide. Only these pairs are passed to
+   * the narrow phase.
+   */
+
+  // Enumerate the available algorithms
+  enum class BroadPhaseType { Grid, SweepAndPrune };
+
+
+  class BroadPhase
+  {
+    public:
+      // World-space AABB of an object known to the broad phase
+      struct Proxy
+      {
+        CollidableObject* object;
+        CollisionTeam team;
+        Vector lower;
+        Vector upper;
+      };
+
+      typedef std::vector< Proxy > ProxyVector;
+      typedef std::vector< std::pair< CollidableObject*, CollidableObject* > > PairList;
+
+    protected:
+      // Calculate the world-space AABB of an object's bounding box
+      static void calculateBounds( CollidableObject*, Vector&, Vector& );
+
+      // Return true if two proxies overlap
+      static bool overlaps( const Proxy& p1, const Proxy& p2 )
+      {
+        return ! ( p1.upper.x() < p2.lower.x() || p2.upper.x() < p1.lower.x() || p1.upper.y() < p2.lower.y() || p2.upper.y() < p1.lower.y() );
+      }
+
+    public:
+      // Con/Destruction
+      BroadPhase() {}
+      virtual ~BroadPhase() {}
+
+
+      // Start the list of objects for the current frame
+      virtual void startUpdate() = 0;
+
+      // Add an object to the current frame
+      virtual void insert( CollidableObject* ) = 0;
+
+      // Fill the list with all the overlapping pairs whose teams are permitted to collide
+      virtual void findPairs( const CollisionHandler&, PairList& ) = 0;
+
+
+      // Return the number of objects in the broad phase
+      virtual size_t size() const = 0;
+  };
+
+}
+
+#endif // REGOLITH_COLLISIONS_BROAD_PHASE_H_
+
@@ -23,10 +23,13 @@ namespace Regolith
 ////////////////////////////////////////////////////////////////////////////////////////////////////
   // Structure for holding the description of a single bouding box
 
-//  // Enumarate the types of hit box for optimizations
-//  //  Polygon - Has a list of points and normals of the same number describing the number of vertices and edges in clockwise order
-//  //  Coming soon: Circle - Store center point. Radius is the x-value of the second point
-//  enum class HitBoxType { Circle, Polygon };
+  // Enumarate the types of hit box for optimizations
+  //  Polygon - Has a list of points and normals of the same number describing the number of vertices and edges in clockwise order
+  //  Circle  - Single point at the centre and a radius. No normals
+  //  Capsule - Two points at the ends of the central segment and a radius. One normal, perpendicular to the segment
+  // Circles and capsules are the core points swept out by the radius, so projecting them is the projection of the
+  // points extended by the radius on both sides.
+  enum class HitBoxType { Polygon, Circle, Capsule };
 
 
   // Struct holding the info required to perform collision detection using the separating axis theorem
@@ -38,17 +41,44 @@ namespace Regolith
     // Edge normals
     std::vector< Vector > normals;
 
-    // Number of points/edges
+    // Number of points
     unsigned int number;
 
     // The type of the collision
     CollisionType collisionType;
 
-//    // Type of hitbox to allow calculation optimization - NOT USED CURRENTLY. EVERYTHING IS A POLYGON!
-//    HitBoxType shape;
+    // Type of hitbox to allow calculation optimization
+    HitBoxType shape;
+
+    // Radius around the points. Zero for polygons
+    float radius;
+  };
+
+
+  // Structure-of-arrays copy of a hitbox's vertices for vectorised projections.
+  // Both arrays are padded to a multiple of REGOLITH_SIMD_WIDTH by repeating the last vertex, so the padding never
+  // changes the minimum or maximum projection.
+  struct HitBoxSoA
+  {
+    // Vertex coordinates
+    std::vector< float > x;
+    std::vector< float > y;
+
+    // Number of real vertices
+    unsigned int number;
+
+    // Copy and pad the vertices of a hitbox
+    void set( const HitBox& );
   };
 
 
+  // Find the minimum and maximum projections of all the vertices onto an axis in a single pass
+  void projectHitBox( const HitBoxSoA&, const Vector&, float&, float& );
+
+  // Scalar version of the projection. Always available for comparison and testing
+  void projectHitBoxScalar( const HitBoxSoA&, const Vector&, float&, float& );
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
   // Base class for all collision models
 
@@ -83,6 +113,14 @@ namespace Regolith
       // Return the end of the collision vector
       virtual iterator end() const = 0;
 
+
+      // Return true if the hitboxes are spatially indexed and can be queried by region
+      virtual bool isIndexed() const { return false; }
+
+      // Append the indices of the hitboxes that may overlap the axis-aligned region between the lower and upper
+      // corners, given in the object's frame. Only used if isIndexed() is true.
+      virtual void findHitBoxes( const Vector&, const Vector&, std::vector< size_t >& ) const {}
+
   };
 
 }
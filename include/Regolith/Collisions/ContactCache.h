@@ -0,0 +1,111 @@
+
+#ifndef REGOLITH_COLLISIONS_CONTACT_CACHE_H_
+#define REGOLITH_COLLISIONS_CONTACT_CACHE_H_
+
+#include "Regolith/Global/Global.h"
+#include "Regolith/ObjectInterfaces/CollidableObject.h"
+
+#include <map>
+
+
+namespace Regolith
+{
+
+  /*
+   * Persistent store of the contacts between pairs of objects.
+   *
+   * Contacts are grouped into manifolds, keyed by the two objects and the hitboxes that touched. Each contact point
+   * remembers the impulse accumulated while resolving it. When the same pair touches again in the next frame a new
+   * point that lies close to a cached one is merged with it and inherits its impulse. Applying those impulses at the
+   * start of a frame (warm starting) lets resting contacts hold still instead of sinking and bouncing every frame.
+   * Points that are not refreshed during a frame are dropped, along with any manifold left empty.
+   */
+
+  // Maximum number of points held in a single manifold
+  const unsigned int max_manifold_points = 2;
+
+
+  // A single cached contact point
+  struct ContactPoint
+  {
+    // World-space point and the normal seen from the first object
+    Vector point;
+    Vector normal;
+
+    // Accumulated impulse along the normal. Negative values push the objects apart
+    float normalImpulse;
+
+    // Frame the point was last refreshed
+    unsigned long frame;
+  };
+
+
+  // All the cached points between one pair of hitboxes
+  struct ContactManifold
+  {
+    ContactPoint points[max_manifold_points];
+    unsigned int number;
+  };
+
+
+  class ContactCache
+  {
+    private:
+      // Identifies the two objects and the hitboxes that touched
+      struct Key
+      {
+        CollidableObject* object1;
+        CollidableObject* object2;
+        unsigned int hitBox1;
+        unsigned int hitBox2;
+
+        bool operator<( const Key& ) const;
+      };
+
+      typedef std::map< Key, ContactManifold > ManifoldMap;
+
+      ManifoldMap _manifolds;
+
+      // Frame counter used to age the points
+      unsigned long _frame;
+
+      // Points closer than this are treated as the same contact
+      float _mergeDistance;
+
+    public:
+      typedef ManifoldMap::const_iterator ManifoldIterator;
+
+      // Con/Destruction
+      ContactCache();
+      ~ContactCache();
+
+      // Set the distance within which contact points are merged
+      void setMergeDistance( float d ) { _mergeDistance = d; }
+      float getMergeDistance() const { return _mergeDistance; }
+
+
+      // Drop everything that was not refreshed during the last frame and start a new one
+      void startFrame();
+
+      // Return the cached point matching the contact, creating it if required. The point is flagged as refreshed.
+      ContactPoint& findPoint( const ContactPair& );
+
+      // Remove all the manifolds
+      void clear();
+
+
+      // Number of object/hitbox pairs currently in contact
+      size_t size() const { return _manifolds.size(); }
+
+      // Basic iterator interface. Keys are not exposed, use the object accessors.
+      ManifoldIterator begin() const { return _manifolds.begin(); }
+      ManifoldIterator end() const { return _manifolds.end(); }
+
+      static CollidableObject* object1( ManifoldIterator it ) { return it->first.object1; }
+      static CollidableObject* object2( ManifoldIterator it ) { return it->first.object2; }
+  };
+
+}
+
+#endif // REGOLITH_COLLISIONS_CONTACT_CACHE_H_
+
@@ -0,0 +1,132 @@
+
+#ifndef REGOLITH_COLLISIONS_CONTACT_SOLVER_H_
+#define REGOLITH_COLLISIONS_CONTACT_SOLVER_H_
+
+#include "Regolith/Global/Global.h"
+#include "Regolith/ObjectInterfaces/CollidableObject.h"
+
+#include <vector>
+#include <map>
+
+
+namespace Regolith
+{
+  // Forward declarations
+  class ContactCache;
+  struct ContactPoint;
+
+  /*
+   * Iterative sequential-impulse solver for all the contacts found in a frame.
+   *
+   * Each contact is a non-penetration constraint on the relative normal velocity of its two objects. The solver
+   * sweeps over all the constraints a configurable number of times, working on a private copy of the object velocities,
+   * so that contacts sharing an object converge together rather than depending on the order they were found in.
+   * The impulse accumulated by each contact is clamped to be repulsive, not the individual corrections.
+   *
+   * Overlaps are removed either by biasing the target velocity (Baumgarte stabilisation) or by solving a second set of
+   * pseudo-velocities that only move the objects and never add energy (split impulse).
+   *
+   * The objects themselves are not changed. The final impulse and position correction of each contact are written into
+   * the Contact passed to onCollision, exactly as the direct resolution does. Applying them reproduces the solver result.
+   */
+
+  // Enumerate the available solvers
+  enum class SolverType { Direct, SequentialImpulse };
+
+  // Enumerate the position correction methods
+  enum class PositionCorrection { Baumgarte, SplitImpulse };
+
+
+  class ContactSolver
+  {
+    private:
+      // Scratch copy of the dynamic state of an object
+      struct SolverBody
+      {
+        Vector velocity;
+        float angularVelocity;
+        Vector pseudoVelocity;
+        float inverseMass;
+        float inverseInertia;
+      };
+
+      // A single non-penetration constraint
+      struct SolverContact
+      {
+        ContactPair* pair;
+        ContactPoint* cached;
+        unsigned int body1;
+        unsigned int body2;
+
+        float lever1;
+        float lever2;
+        float inverseEffectiveMass;
+
+        float targetVelocity;
+        float correctionVelocity;
+
+        float initialImpulse;
+        float impulse;
+        float pseudoImpulse; // Baumgarte bias impulse or split impulse
+      };
+
+      typedef std::map< CollidableObject*, unsigned int > BodyMap;
+
+      // Number of passes over the velocity constraints
+      unsigned int _iterations;
+
+      // Position correction method
+      PositionCorrection _positionCorrection;
+
+      // Fraction of the overlap removed each frame
+      float _baumgarte;
+
+      // Overlap that is allowed without correction. Stops resting contacts from jittering
+      float _slop;
+
+      // Approach speed below which restitution is ignored
+      float _restitutionThreshold;
+
+      // Scratch space, kept to avoid reallocating every frame
+      std::vector< SolverBody > _bodies;
+      std::vector< SolverContact > _constraints;
+      BodyMap _bodyMap;
+
+
+      // Return the index of the solver body for an object, creating it if required
+      unsigned int findBody( CollidableObject* );
+
+      // Relative normal velocity of the contact
+      float relativeVelocity( const SolverContact& ) const;
+
+      // Relative normal pseudo-velocity of the contact
+      float relativePseudoVelocity( const SolverContact& ) const;
+
+      // Apply a change of impulse to both bodies of the contact
+      void applyImpulse( const SolverContact&, float );
+
+      // Apply a change of pseudo-impulse to both bodies of the contact
+      void applyPseudoImpulse( const SolverContact&, float );
+
+    public:
+      // Con/Destruction
+      ContactSolver();
+      ~ContactSolver();
+
+      // Configure from the "solver" block of the collision json
+      void configure( Json::Value& );
+
+      // Solve all the contacts for a frame of the given length and fill in their impulses.
+      // If a cache is given the impulses are warm started from it and the totals are stored back.
+      void solve( ContactBuffer&, ContactCache*, float );
+
+
+      // Accessors
+      unsigned int getIterations() const { return _iterations; }
+      PositionCorrection getPositionCorrection() const { return _positionCorrection; }
+  };
+
+}
+
+#endif // REGOLITH_COLLISIONS_CONTACT_SOLVER_H_
+
@@ -0,0 +1,42 @@
+
+#ifndef REGOLITH_COLLISIONS_CONTINUOUS_COLLISION_H_
+#define REGOLITH_COLLISIONS_CONTINUOUS_COLLISION_H_
+
+#include "Regolith/Global/Global.h"
+#include "Regolith/Collisions/Collision.h"
+
+
+namespace Regolith
+{
+  // Forward declarations
+  class CollidableObject;
+
+  /*
+   * Swept collision tests for fast moving objects.
+   *
+   * Objects flagged as bullets can move further than the thickness of a wall in a single step, so the discrete tests
+   * would never see them overlap. Instead the motion over the last step is swept against the static objects in the
+   * layer using the separating axis theorem. For each axis the time interval during which the projections overlap
+   * is found. The hitboxes touch first at the latest entry time, provided it comes before the earliest exit time.
+   * Rotation during the step is ignored: the moving hitboxes keep their final orientation over the whole sweep.
+   *
+   * Times are fractions of the displacement, from 0 (start of the step) to 1 (end of the step).
+   */
+
+  // Distance a clamped bullet is allowed to penetrate, so the discrete narrow phase sees the contact
+  const float sweep_skin = 0.1;
+
+
+  // Find the time at which a hitbox moving by the displacement first touches a fixed one. Both hitboxes are given at
+  // their final world positions. Returns false if they don't touch during the step, or if they already overlap at the
+  // start of it.
+  bool sweepHitBox( const HitBox&, const HitBoxSoA&, const Vector&, const HitBox&, const HitBoxSoA&, float& );
+
+  // Earliest time of impact between an object that moved by the displacement and a fixed object.
+  // The world-space hitboxes of both objects must be up to date.
+  bool timeOfImpact( const CollidableObject*, const Vector&, const CollidableObject*, float& );
+
+}
+
+#endif // REGOLITH_COLLISIONS_CONTINUOUS_COLLISION_H_
+
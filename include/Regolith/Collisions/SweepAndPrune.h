@@ -0,0 +1,95 @@
+
+#ifndef REGOLITH_COLLISIONS_SWEEP_AND_PRUNE_H_
+#define REGOLITH_COLLISIONS_SWEEP_AND_PRUNE_H_
+
+#include "Regolith/Global/Global.h"
+#include "Regolith/Collisions/BroadPhase.h"
+#include "Regolith/Utilities/BoundingBox.h"
+
+#include <vector>
+#include <map>
+
+
+namespace Regolith
+{
+
+  /*
+   * Sweep and prune broad phase for a single context layer.
+   *
+   * The proxies and the sorted list of their AABB endpoints along one axis persist between frames. Each frame the
+   * endpoint values are refreshed and the list is re-sorted with an insertion sort. As objects only move a little
+   * between frames the list is almost sorted already, so this is close to O(n).
+   * The sweep axis is the longest dimension of the layer, e.g. the x-axis for a side-scroller.
+   * Objects that are not inserted during a frame are assumed to have left the layer and are removed.
+   */
+
+  class SweepAndPrune : public BroadPhase
+  {
+    private:
+      // One end of a proxy's interval along the sweep axis
+      struct EndPoint
+      {
+        float value;
+        unsigned int proxy;
+        bool isLower;
+      };
+
+      typedef std::vector< EndPoint > EndPointVector;
+      typedef std::map< CollidableObject*, unsigned int > ProxyMap;
+
+      // True if the sweep axis is x
+      bool _sweepX;
+
+      // Proxies of all the objects in the layer
+      ProxyVector _proxies;
+
+      // Flag for each proxy that it was inserted this frame
+      std::vector< bool > _present;
+
+      // Lookup of proxy index for each object
+      ProxyMap _proxyMap;
+
+      // Endpoints sorted along the sweep axis
+      EndPointVector _endPoints;
+
+      // Proxies whose intervals contain the current sweep position
+      std::vector< unsigned int > _active;
+
+
+      // Remove all proxies that were not inserted this frame
+      void removeAbsent();
+
+      // Copy the current proxy bounds into the endpoints and re-sort them
+      void sortEndPoints();
+
+    public:
+      // Con/Destruction
+      SweepAndPrune();
+      virtual ~SweepAndPrune();
+
+      // Choose the sweep axis from the dimensions of the layer
+      void configure( const BoundingBox& );
+
+
+      // Flag all the proxies as absent until they are inserted again
+      virtual void startUpdate() override;
+
+      // Update the bounds of an existing proxy, or create a new one
+      virtual void insert( CollidableObject* ) override;
+
+
+      // Sort the endpoints and sweep to find the overlapping pairs
+      virtual void findPairs( const CollisionHandler&, PairList& ) override;
+
+
+      // Return the number of objects being tracked
+      virtual size_t size() const override { return _proxies.size(); }
+
+      // Return true if the sweep axis is the x-axis
+      bool sweepX() const { return _sweepX; }
+  };
+
+}
+
+#endif // REGOLITH_COLLISIONS_SWEEP_AND_PRUNE_H_
+
@@ -21,6 +21,22 @@ namespace Regolith
       // Store a vector of vector of hit boxes. Only one set is active at time.
       Collision::HitBoxVector _hitboxes;
 
+      // Grid of the tile set. Each cell holds the index of its hitbox, or -1 if the tile is empty. Row-major order.
+      std::vector< int > _grid;
+
+      // Grid dimensions
+      size_t _numRows;
+      size_t _numCols;
+      float _tileWidth;
+      float _tileHeight;
+
+      // Flag to indicate that neighbouring tiles share hitboxes
+      bool _merged;
+
+
+      // Replace the tile hitboxes with the fewest rectangles that cover the same tiles
+      void mergeTiles( CollisionType );
+
     public:
       TilesheetCollision();
       virtual ~TilesheetCollision() {}
@@ -39,6 +55,21 @@ namespace Regolith
       // Return the end of the active collision vector
       virtual iterator end() const override { return _hitboxes.end(); }
 
+
+      // The hitboxes are indexed by the tile grid
+      virtual bool isIndexed() const override { return true; }
+
+      // Append the indices of the hitboxes for the tiles under the region
+      virtual void findHitBoxes( const Vector&, const Vector&, std::vector< size_t >& ) const override;
+
+
+      // Return the hitbox index for a tile, or -1 if it is empty
+      int getCell( size_t row, size_t col ) const { return _grid[ row*_numCols + col ]; }
+
+      // Grid dimensions
+      size_t getNumberRows() const { return _numRows; }
+      size_t getNumberColumns() const { return _numCols; }
+
   };
 
 }
@@ -0,0 +1,91 @@
+
+#ifndef REGOLITH_COLLISIONS_UNIFORM_GRID_H_
+#define REGOLITH_COLLISIONS_UNIFORM_GRID_H_
+
+#include "Regolith/Global/Global.h"
+#include "Regolith/Collisions/BroadPhase.h"
+#include "Regolith/Utilities/BoundingBox.h"
+
+#include <vector>
+
+
+namespace Regolith
+{
+
+  /*
+   * Uniform grid broad phase for a single context layer.
+   *
+   * The grid covers the layer's bounding box with square cells of a configurable size. Every frame the grid is cleared
+   * and each collidable object is inserted into all the cells its world-space AABB touches. Objects that leave the
+   * layer are clamped into the border cells so they are never lost.
+   * Candidate pairs are only emitted for objects that share a cell, whose AABBs overlap and whose teams are allowed to
+   * collide by the collision handler. Each pair is reported once, from the cell containing the lower corner of the
+   * intersection of the two AABBs.
+   */
+
+  class UniformGrid : public BroadPhase
+  {
+    private:
+      typedef std::vector< unsigned int > Cell;
+      typedef std::vector< Cell > CellVector;
+
+      // Location of the top-left corner of the grid
+      Vector _origin;
+
+      // Cell dimensions
+      float _cellSize;
+      float _inverseCellSize;
+
+      // Grid dimensions
+      unsigned int _columns;
+      unsigned int _rows;
+
+      // Proxies of all the objects inserted this frame
+      ProxyVector _proxies;
+
+      // Indices into the proxy vector for each cell, row-major
+      CellVector _cells;
+
+      // Indices of the cells that are not empty. Means clearing the grid is not O(cells)
+      std::vector< unsigned int > _occupied;
+
+
+      // Return the clamped column/row of a position
+      unsigned int column( float ) const;
+      unsigned int row( float ) const;
+
+    public:
+      // Con/Destruction
+      UniformGrid();
+      virtual ~UniformGrid();
+
+      // Size the grid to cover the bounding box with cells of the given size
+      void configure( const BoundingBox&, float );
+
+
+      // Remove all the objects from the grid
+      virtual void startUpdate() override;
+
+      // Calculate the world-space AABB of the object and insert it into every cell it touches
+      virtual void insert( CollidableObject* ) override;
+
+
+      // Fill the list with all the overlapping pairs whose teams are permitted to collide
+      virtual void findPairs( const CollisionHandler&, PairList& ) override;
+
+
+      // Return the number of objects in the grid
+      virtual size_t size() const override { return _proxies.size(); }
+
+      // Return the cell size
+      float getCellSize() const { return _cellSize; }
+
+      // Return the grid dimensions
+      unsigned int getNumberColumns() const { return _columns; }
+      unsigned int getNumberRows() const { return _rows; }
+  };
+
+}
+
+#endif // REGOLITH_COLLISIONS_UNIFORM_GRID_H_
+
@@ -11,6 +11,7 @@
 #include "Regolith/Handlers/CollisionHandler.h"
 #include "Regolith/Handlers/ContextGroup.h"
 #include "Regolith/Contexts/ContextLayer.h"
+#include "Regolith/Architecture/PhysicsStore.h"
 
 #include <map>
 
@@ -22,7 +23,7 @@ namespace Regolith
   // Forward declarations
   class PhysicalObject;
   class ContextGroup;
-  class Camera;
+  class RenderQueue;
 
   /*
    * Defines a context interface.
@@ -53,6 +54,8 @@ namespace Regolith
       // Details for using the camera
       Vector _cameraPosition;
       Vector _cameraOffset;
+      // Camera position at the start of the last update
+      Vector _lastCameraPosition;
 
       // Flag to indicate that this context is now closed and may be popped from the context stack.
       bool _closed;
@@ -66,6 +69,37 @@ namespace Regolith
       // Named vector of all the layers owned by the current context
       ContextLayerList _layers;
 
+      // Scratch space for the broad phase. Stored here to avoid reallocating every frame
+      BroadPhase::PairList _candidatePairs;
+
+      // Pairs of objects that touched this frame. Used to build the sleeping islands
+      BroadPhase::PairList _islandPairs;
+
+      // Bullets that moved in the current layer this frame
+      std::vector< CollidableObject* > _bullets;
+
+      // Flag to integrate the objects that opt in with the structure-of-arrays physics store
+      bool _usePhysicsStore;
+
+      // Dynamic state of all the objects that opted in to batched integration
+      PhysicsStore _physicsStore;
+
+
+      // Sweep the bullets against the static objects in the layer and stop them at the first impact
+      void sweepBullets( ContextLayer& );
+
+
+      // Group touching objects into islands and put the islands that have come to rest to sleep
+      void updateIslands( ContextLayer& );
+
+
+      // Record the current transforms of the camera and every object as the start of the next update
+      void storeTransforms();
+
+
+      // Give every object that opts in a slot in the physics store, taking over any that another context holds
+      void attachPhysicsObjects();
+
 
 //////////////////////////////////////////////////////////////////////////////// 
     protected:
@@ -93,7 +127,7 @@ namespace Regolith
       virtual void updatePhysics( PhysicalObject*, float ) const = 0;
 
       // Called at the end of the render loop to do any context-specific rendering (e.g. transitions)
-      virtual void renderContext( Camera& ) = 0;
+      virtual void renderContext( RenderQueue& ) = 0;
 
 //////////////////////////////////////////////////////////////////////////////// 
     public:
@@ -113,6 +147,9 @@ namespace Regolith
       // Return a reference to a specific context layer
       ContextLayer& getLayer( std::string );
 
+      // Return the physics store, or nullptr if every object is stepped individually
+      PhysicsStore* getPhysicsStore() { return ( _usePhysicsStore ? &_physicsStore : nullptr ); }
+
 //////////////////////////////////////////////////////////////////////////////// 
       // Context Stack functions
 
@@ -141,8 +178,8 @@ namespace Regolith
       void update( float );
 
 
-      // Render all the objects
-      void render( Camera& );
+      // Record the draw commands for all the objects
+      void render( RenderQueue& );
 
 
 //////////////////////////////////////////////////
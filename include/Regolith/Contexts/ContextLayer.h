@@ -5,6 +5,7 @@
 #include "Regolith/Global/Global.h"
 #include "Regolith/Architecture/PhysicalObject.h"
 #include "Regolith/Utilities/BoundingBox.h"
+#include "Regolith/Collisions/BroadPhase.h"
 
 #include <list>
 #include <set>
@@ -25,6 +26,7 @@ namespace Regolith
       Vector _position; // Can be considered as the offset wrt to the camera
       Vector _movementScale; // Movement wrt the camera position
       BoundingBox _boundingBox;
+      BroadPhase* _broadPhase; // Spatial partitioning of the collidable objects
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -34,6 +36,10 @@ namespace Regolith
       // Clear all the caches
       ~ContextLayer();
 
+      // Layers own their broad phase, so they can't be copied
+      ContextLayer( const ContextLayer& ) = delete;
+      ContextLayer& operator=( const ContextLayer& ) = delete;
+
       // Configure with position, movement scale, width and height
       void configure( Context*, std::string, Vector, Vector, float, float );
 
@@ -42,10 +48,34 @@ namespace Regolith
       std::string getName() const { return _name; }
 
 
-      // Map all objects organised by collision team
+      // All objects organised by collision team. Each team is stored contiguously.
       LayerGraph layerGraph;
 
 
+////////////////////////////////////////////////////////////////////////////////
+      // Object storage
+
+      // Add an object to the end of its team
+      void addObject( PhysicalObject* );
+
+      // Remove all the objects that have been destroyed. The remaining objects keep their order.
+      void removeDestroyed();
+
+      // Return the number of teams
+      size_t getNumberTeams() const { return layerGraph.size(); }
+
+      // Return all the objects in a team
+      PhysicalObjectVector& getTeam( CollisionTeam team ) { return layerGraph[ team ]; }
+      const PhysicalObjectVector& getTeam( CollisionTeam team ) const { return layerGraph[ team ]; }
+
+      // Return the total number of objects in the layer
+      size_t getNumberObjects() const;
+
+      // Call the function for every object in the layer, team by team
+      template < class FUNCTION >
+      void forEachObject( FUNCTION );
+
+
 ////////////////////////////////////////////////////////////////////////////////
       // Layer details
 
@@ -60,8 +90,34 @@ namespace Regolith
       const float& getHeight() const { return _boundingBox.height; }
 
       const BoundingBox& getBoundingBox() const { return _boundingBox; }
+
+
+////////////////////////////////////////////////////////////////////////////////
+      // Collision details
+
+      // Set the broad phase used to find candidate collision pairs. Takes ownership of the pointer
+      void setBroadPhase( BroadPhase* );
+
+      // Return the broad phase used to find candidate collision pairs
+      BroadPhase& getBroadPhase() { return *_broadPhase; }
   };
 
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Template member function definitions
+
+  template < class FUNCTION >
+  void ContextLayer::forEachObject( FUNCTION function )
+  {
+    for ( LayerGraph::iterator team_it = layerGraph.begin(); team_it != layerGraph.end(); ++team_it )
+    {
+      for ( PhysicalObjectVector::iterator obj_it = team_it->begin(); obj_it != team_it->end(); ++obj_it )
+      {
+        function( *obj_it );
+      }
+    }
+  }
+
 }
 
 #endif // REGOLITH_CONTEXTS_CONTEXT_LAYER_H_
@@ -3,11 +3,11 @@
 #define REGOLITH_MANAGERS_CAMERA_H_
 
 #include "Regolith/Global/Global.h"
+#include "Regolith/GamePlay/RenderQueue.h"
 
 
 namespace Regolith
 {
-  class DrawableObject;
   class WindowManager;
   class Texture;
 
@@ -68,8 +68,8 @@ namespace Regolith
       void renderTexture( Texture& );
 
 
-      // Render a physical object
-      void renderDrawableObject( DrawableObject*, Vector& );
+      // Draw all the commands recorded for a frame. Pending textures must already have been uploaded
+      void replay( const RenderCommandList& );
 
 
       // Destroys the sdl texture object
@@ -0,0 +1,128 @@
+
+#ifndef REGOLITH_GAMEPLAY_FRAME_PACER_H_
+#define REGOLITH_GAMEPLAY_FRAME_PACER_H_
+
+#include "Regolith/Global/Global.h"
+
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+
+
+namespace Regolith
+{
+
+  /*
+   * Paces the engine and rendering threads so that neither spins while there is nothing to do.
+   *
+   * With a target frame rate the engine thread sleeps until the start of each frame. Most of the wait is a normal
+   * sleep and the last part yields in a loop, so the frame starts on time even though the scheduler wakes the thread
+   * late. The length of that spin tail adapts to how late the sleeps actually wake up. Frames that are still running
+   * at their deadline are counted as missed.
+   *
+   * Without a target and with v-sync on, the engine thread waits for the rendering thread to present each frame, so
+   * the updates follow the display refresh. Without either the engine runs uncapped.
+   *
+   * The rendering thread waits until a new frame is published or it is woken for some other work, such as a context
+   * group that needs its textures rendered.
+   */
+  class FramePacer
+  {
+    public:
+      typedef std::chrono::steady_clock ClockType;
+
+    private:
+      // Time between frames. Zero when there is no target frame rate
+      ClockType::duration _period;
+
+      // Presenting a frame blocks until the display refreshes
+      bool _vsync;
+
+      // Longest time the rendering thread waits without being woken. Keeps the window refreshed while idle
+      ClockType::duration _idleTime;
+
+
+      // Engine thread only
+      // Start of the next frame
+      ClockType::time_point _deadline;
+
+      // Current and maximum length of the spin tail
+      ClockType::duration _spinTime;
+      ClockType::duration _maxSpinTime;
+
+      // Last present seen by the engine thread
+      unsigned long _lastPresent;
+
+      // Statistics for the report
+      unsigned long _frameCount;
+      unsigned long _missedCount;
+      float _worstLateness;
+
+
+      // Rendering thread only
+      // Last wake seen by the rendering thread
+      unsigned long _lastWake;
+
+
+      // Shared between the threads
+      mutable std::mutex _mutex;
+      std::condition_variable _condition;
+      unsigned long _presentCount;
+      unsigned long _wakeCount;
+
+
+      // Sleep until the given time, finishing with the spin tail
+      void sleepUntil( ClockType::time_point );
+
+    public:
+      // Con/Destruction
+      FramePacer();
+      ~FramePacer();
+
+      // Set the target frame rate and the maximum spin tail in milliseconds. A rate of zero removes the target
+      void configure( float, float );
+
+      // Set whether presents are synchronised to the display
+      void setVSync( bool v ) { _vsync = v; }
+
+      // Return the condition variable so that it can be triggered when the threads stop
+      std::condition_variable* getCondition() { return &_condition; }
+
+
+////////////////////////////////////////////////////////////////////////////////
+      // Engine thread
+
+      // Start pacing from now. Used when the engine starts and after it has been paused
+      void start();
+
+      // Wait for the start of the next frame
+      void waitForFrame();
+
+      // Log the missed deadlines since the last report and reset the count
+      void report();
+
+      // Return the number of missed deadlines since the last report
+      unsigned long getMissedFrames() const { return _missedCount; }
+
+
+////////////////////////////////////////////////////////////////////////////////
+      // Rendering thread
+
+      // Signal that a frame has been presented
+      void framePresented();
+
+      // Wait until woken or the idle time has passed
+      void waitForWork();
+
+
+////////////////////////////////////////////////////////////////////////////////
+      // Any thread
+
+      // Wake the rendering thread. Called when a frame is published or other rendering work arrives
+      void wake();
+  };
+
+}
+
+#endif // REGOLITH_GAMEPLAY_FRAME_PACER_H_
+
@@ -0,0 +1,143 @@
+
+#ifndef REGOLITH_GAMEPLAY_RENDER_QUEUE_H_
+#define REGOLITH_GAMEPLAY_RENDER_QUEUE_H_
+
+#include "Regolith/Global/Global.h"
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+
+namespace Regolith
+{
+  // Forward declarations
+  class DrawableObject;
+  class Texture;
+
+  /*
+   * Triple-buffered list of draw commands passed from the engine thread to the rendering thread.
+   *
+   * At the end of each update the engine records everything the visible contexts want drawn into the recording buffer
+   * and publishes it. The rendering thread replays the most recently published buffer without touching the contexts,
+   * so the next update can run while the previous one is drawn. If the engine is slower than the display the last
+   * buffer is simply drawn again. If it is faster, unreplayed buffers are overwritten.
+   *
+   * Textures with a new surface can only be uploaded by the rendering thread. They are recorded by pointer and listed
+   * in the buffer so the rendering thread can upload them, with the contexts locked, before the buffer is replayed.
+   */
+
+  // Enumerate the draw operations
+  enum class RenderCommandType { Copy, Fill };
+
+
+  // Everything required to draw one texture or fill, copied at the time it is recorded
+  struct RenderCommand
+  {
+    RenderCommandType type;
+
+    // Texture with a pending upload, or nullptr when the SDL texture was already known
+    Texture* texture;
+    SDL_Texture* sdlTexture;
+
+    SDL_Rect clip;
+    bool clipped;
+
+    // Destination in window coordinates, before the window scaling is applied
+    float x;
+    float y;
+    float width;
+    float height;
+
+    // Rotation in degrees about the center point
+    double angle;
+    SDL_Point center;
+    SDL_RendererFlip flip;
+
+    // Blend mode, colour and alpha modulation. The fill colour for fills
+    SDL_BlendMode blendMode;
+    SDL_Color colour;
+  };
+
+  typedef std::vector< RenderCommand > RenderCommandList;
+
+
+  // A complete frame of commands
+  struct RenderFrame
+  {
+    RenderCommandList commands;
+    std::vector< Texture* > uploads;
+  };
+
+
+  class RenderQueue
+  {
+    private:
+      RenderFrame _frames[3];
+
+      // Engine thread only
+      RenderFrame* _recording;
+      // Shared. Most recently published frame
+      RenderFrame* _ready;
+      // Rendering thread only
+      RenderFrame* _replaying;
+
+      // Flag that the ready frame is newer than the one being replayed
+      bool _fresh;
+      // Flag that the rendering thread is using the replaying frame
+      bool _replayActive;
+
+      // Interpolation fraction for the frame being recorded
+      float _interpolation;
+
+      // Protects the frame pointers and flags
+      std::mutex _swapMutex;
+      std::condition_variable _released;
+
+    public:
+      // Con/Destruction
+      RenderQueue();
+      ~RenderQueue();
+
+      // Frames hold pointers into the shared buffers
+      RenderQueue( const RenderQueue& ) = delete;
+      RenderQueue& operator=( const RenderQueue& ) = delete;
+
+
+////////////////////////////////////////////////////////////////////////////////
+      // Recording. Engine thread only
+
+      // Start a new frame. Objects are drawn the given fraction of the way through their last update
+      void startRecording( float );
+
+      // Return the interpolation fraction for the current frame
+      float getInterpolation() const { return _interpolation; }
+
+      // Draw an object relative to the camera position
+      void drawObject( DrawableObject*, const Vector& );
+
+      // Fill the displayable area with a colour
+      void fillWindow( const SDL_Color& );
+
+      // Make the recorded frame available to the rendering thread
+      void publish();
+
+      // Discard all the frames and wait for the rendering thread to stop using them.
+      // Must be called before anything that was recorded can be destroyed.
+      void flush();
+
+
+////////////////////////////////////////////////////////////////////////////////
+      // Replaying. Rendering thread only
+
+      // Return the newest published frame. Must be followed by release()
+      RenderFrame& acquire();
+
+      // Signal that the rendering thread has finished with the frame
+      void release();
+  };
+
+}
+
+#endif // REGOLITH_GAMEPLAY_RENDER_QUEUE_H_
+
@@ -4,6 +4,8 @@
 
 #include "Regolith/Global/Global.h"
 
+#include <chrono>
+
 
 namespace Regolith
 {
@@ -45,12 +47,15 @@ namespace Regolith
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-  // Minimal timer class - Mostly for timing frames
+  // Minimal timer class - Mostly for timing frames.
+  // Uses a steady high-resolution clock so that frame times are not rounded to whole milliseconds
 
   class FrameTimer
   {
+    typedef std::chrono::steady_clock ClockType;
+
     private:
-      Uint32 _startTime;
+      ClockType::time_point _startTime;
 
       float _frameCount;
       float _frameSum;
@@ -64,6 +69,7 @@ namespace Regolith
     public:
       FrameTimer( unsigned int n = 100 );
 
+      // Return the time since the last lap in milliseconds
       float lap();
 
       void resetFPSCount();
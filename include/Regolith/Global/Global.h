@@ -26,6 +26,20 @@
 #endif
 
 
+// Select the vector instruction set for the collision kernels. Define REGOLITH_NO_SIMD to force the scalar versions.
+#if defined REGOLITH_NO_SIMD
+#define REGOLITH_SIMD_WIDTH 1
+#elif defined __AVX2__
+#define REGOLITH_SIMD_AVX2 1
+#define REGOLITH_SIMD_WIDTH 8
+#elif defined __SSE2__
+#define REGOLITH_SIMD_SSE2 1
+#define REGOLITH_SIMD_WIDTH 4
+#else
+#define REGOLITH_SIMD_WIDTH 1
+#endif
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Logtastic configuration
 #ifdef LOGTASTIC_FUNCTION_NAME
@@ -22,6 +22,9 @@
 
 #define REGOLITH_PIXEL_DEPTH 32
 
+// Pixel format matching the masks above
+#define REGOLITH_PIXEL_FORMAT SDL_PIXELFORMAT_RGBA32
+
 
 
 #endif // REGOLITH_GLOBAL_SDL_H_
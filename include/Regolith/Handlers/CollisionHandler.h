@@ -4,6 +4,9 @@
 
 #include "Regolith/Global/Global.h"
 #include "Regolith/ObjectInterfaces/CollidableObject.h"
+#include "Regolith/Collisions/BroadPhase.h"
+#include "Regolith/Collisions/ContactCache.h"
+#include "Regolith/Collisions/ContactSolver.h"
 
 #include <vector>
 #include <utility>
@@ -38,53 +41,85 @@ namespace Regolith
   // Collision handler definition
   class CollisionHandler
   {
-    typedef std::vector< std::pair< CollisionTeam, CollisionTeam > > CollisionPairList;
-    typedef std::set< CollisionTeam > CollisionSet;
+    typedef std::vector< bool > TeamMatrix;
 
     private:
-      CollisionSet _teamCollision;
-      CollisionPairList _pairings;
-      CollisionPairList _containers;
+      // Number of teams the rules are stored for. Teams are dense indices starting from zero.
+      size_t _numberTeams;
 
-      // These variables are stored as class memebers to reduce the size of the stack frame.
-      // Should (slightly!) speed up the collision detection process
-      Vector _object_pos1;
-      Vector _object_pos2;
+      // Bit matrix of the teams that may collide, indexed by [ team1*_numberTeams + team2 ]. Symmetric.
+      // The diagonal holds the team collision rules.
+      TeamMatrix _collisionMatrix;
 
-      Vector _point1;
-      Vector _point2;
+      // Bit matrix of the containment rules, indexed by [ container*_numberTeams + contained ]
+      TeamMatrix _containerMatrix;
 
-      Vector _normal1;
-      Vector _normal2;
+      // All the teams that appear in a team or pair collision rule
+      TeamMatrix _collidingTeams;
 
-      float _projection1;
-      float _projection2;
+      // Algorithm used to build the broad phase for each layer
+      BroadPhaseType _broadPhaseType;
 
-      Vector _overlapping_point;
+      // Cell size used to build the broad phase grid for each layer
+      float _cellSize;
 
-      float _largest_overlap;
-      float _diff;
+      // Minimum number of candidate pairs before the narrow phase is split across the job workers
+      unsigned int _parallelThreshold;
 
-      float _lever_len_1;
-      float _lever_len_2;
+      // Contacts found by the last narrow phase, waiting to be resolved
+      ContactBuffer _contacts;
 
-      float _total_M;
-      float _total_L;
-      float _coef_restitution;
+      // Scratch buffer for each block of the parallel narrow phase
+      std::vector< ContactBuffer > _workerContacts;
 
-      float _total_impulse;
+      // Sleep thresholds for objects that have come to rest
+      bool _sleepEnabled;
+      float _sleepVelocity;
+      float _sleepAngularVelocity;
+      unsigned int _sleepFrames;
 
-      Contact _contact1;
-      Contact _contact2;
+      // Flag to persist contacts between frames and warm start them
+      bool _warmStarting;
+
+      // Contacts from the previous frames, with their accumulated impulses
+      ContactCache _contactCache;
+
+      // Method used to resolve the contacts found each frame
+      SolverType _solverType;
+      ContactSolver _solver;
 
     protected:
-      // Used to handle the function calls the two objects that have collided.
-      inline void callback( CollidableObject*, CollidableObject* );
+      // Test two objects for collision and append any contact to the buffer. Reads the world-space caches only.
+      void detectCollision( CollidableObject*, CollidableObject*, ContactBuffer& ) const;
+
+      // Test if the first object contains the second and append any contact to the buffer
+      void detectContainment( CollidableObject*, CollidableObject*, ContactBuffer& ) const;
+
+      // Calculate the impulses for a contact and call the objects' collision handlers
+      void resolve( ContactPair& );
+
+      // Add the impulse to the cached contact, keeping the total repulsive. Returns the change in the total.
+      float accumulateImpulse( ContactPair&, float, float, float );
+
+      // Find the hitboxes of an indexed object (e.g. a tile map) that lie under the other object's bounding box
+      void findIndexedHitBoxes( const CollidableObject*, const CollidableObject*, std::vector< size_t >& ) const;
+
+      // Return the vertex of the hitbox with the smallest projection onto the axis
+      const Vector& supportPoint( const HitBox&, const Vector& ) const;
+
+      // Specialised tests for circle and capsule hitboxes, chosen by detectCollision. Each returns true if the hitboxes
+      // overlap and fills in the normal pointing from the first to the second, the (negative) overlap and the deepest
+      // point of the second hitbox.
+      bool collideCircles( const HitBox&, const HitBox&, Vector&, float&, Vector& ) const;
+      bool collideCapsules( const HitBox&, const HitBox&, Vector&, float&, Vector& ) const;
+      bool collidePolygonRounded( const HitBox&, const HitBoxSoA&, const HitBox&, const HitBoxSoA&, Vector&, float&, Vector& ) const;
+
+      // Make room in the rule matrices for the team index
+      void addTeam( CollisionTeam );
 
     public:
       // Const iterators - no changing!
-      typedef CollisionSet::const_iterator SetIterator;
-      typedef CollisionPairList::const_iterator PairIterator;
+      typedef ContactBuffer::const_iterator ContactIterator;
 
       // Con/De-structors
       CollisionHandler();
@@ -112,23 +147,67 @@ namespace Regolith
       // Configures an empty layer
       void setupEmptyLayer( ContextLayer& ) const;
 
-      // Basic iterator interface
-      SetIterator teamCollisionBegin() const { return _teamCollision.begin(); }
-      SetIterator teamCollisionEnd() const { return _teamCollision.end(); }
+      // Return the broad phase algorithm
+      BroadPhaseType getBroadPhaseType() const { return _broadPhaseType; }
+
+      // Return the broad phase cell size
+      float getCellSize() const { return _cellSize; }
+
+      // Sleep configuration
+      bool isSleepEnabled() const { return _sleepEnabled; }
+      float getSleepVelocity() const { return _sleepVelocity; }
+      float getSleepAngularVelocity() const { return _sleepAngularVelocity; }
+      unsigned int getSleepFrames() const { return _sleepFrames; }
+
+      // Return the number of teams covered by the rules
+      size_t getNumberTeams() const { return _numberTeams; }
 
-      // Basic iterator interface
-      PairIterator collisionBegin() const { return _pairings.begin(); }
-      PairIterator collisionEnd() const { return _pairings.end(); }
+      // Return true if the team appears in any collision rule
+      bool isColliding( CollisionTeam team ) const { return team < _numberTeams && _collidingTeams[ team ]; }
 
-      // Basic iterator interface
-      PairIterator containerBegin() const { return _containers.begin(); }
-      PairIterator containerEnd() const { return _containers.end(); }
+      // Return true if objects in the two teams are allowed to collide
+      bool canCollide( CollisionTeam team1, CollisionTeam team2 ) const
+      { return team1 < _numberTeams && team2 < _numberTeams && _collisionMatrix[ team1*_numberTeams + team2 ]; }
 
-      // Do two object collide
+      // Return true if objects in the first team contain objects in the second
+      bool canContain( CollisionTeam team1, CollisionTeam team2 ) const
+      { return team1 < _numberTeams && team2 < _numberTeams && _containerMatrix[ team1*_numberTeams + team2 ]; }
+
+      // Do two object collide. Detects and resolves immediately, leaving the contacts waiting to be resolved alone.
       void collides( CollidableObject*, CollidableObject* );
-      // Does the first object contain the second
+      // Does the first object contain the second. Detects and resolves immediately, leaving the contacts waiting to be resolved alone.
       void contains( CollidableObject*, CollidableObject* );
 
+
+      // Test all the candidate pairs, in parallel if there are enough of them. World-space caches must be up to date.
+      void narrowPhase( const BroadPhase::PairList& );
+
+      // Test if the first object contains the second and add any contact to those waiting to be resolved
+      void addContainment( CollidableObject*, CollidableObject* );
+
+      // Resolve all the waiting contacts for a frame of the given length. Either directly, in the order they were found,
+      // or together with the configured solver.
+      void resolveContacts( float );
+
+      // Drop stale contacts and re-apply the impulses of the persistent ones. Call once at the start of a frame.
+      void warmStart();
+
+      // Return the method used to resolve the contacts
+      SolverType getSolverType() const { return _solverType; }
+
+      // Return true if contacts persist between frames
+      bool isWarmStarting() const { return _warmStarting; }
+
+      // Return the persistent contacts
+      const ContactCache& getContactCache() const { return _contactCache; }
+
+      // Number of contacts waiting to be resolved
+      size_t contactCount() const { return _contacts.size(); }
+
+      // Basic iterator interface for the contacts waiting to be resolved
+      ContactIterator contactBegin() const { return _contacts.begin(); }
+      ContactIterator contactEnd() const { return _contacts.end(); }
+
   };
 
 
@@ -38,6 +38,9 @@ namespace Regolith
       // Configures null pointers for all the game objects, spawn buffers, contexts and playlists
       void _configureData( Json::Value& );
 
+      // Adds the textures and sounds used by the game objects to the data handler's load plan
+      void _planAssets( Json::Value& );
+
       // Loads the data for all the game objects, spawn buffers, contexts and playlists
       void _loadPlaylists( Json::Value& );
       void _loadObjects( Json::Value& );
@@ -88,6 +91,7 @@ namespace Regolith
       bool _loadingState;
       unsigned int _loadProgress;
       unsigned int _loadTotal;
+      unsigned int _loadAssets;
       std::string _loadStatus;
       mutable std::mutex _mutexProgress;
 
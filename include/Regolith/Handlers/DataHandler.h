@@ -13,6 +13,9 @@
 #include <string>
 #include <queue>
 #include <mutex>
+#include <set>
+#include <list>
+#include <functional>
 
 
 namespace Regolith
@@ -26,13 +29,18 @@ namespace Regolith
 
   class DataHandler
   {
+    typedef std::map< std::string, RawTexture* > RawTexturePointerMap;
+    typedef std::map< std::string, RawSound* > RawSoundPointerMap;
 
     private:
-      // List of all the textures
-      RawTextureMap _rawTextures;
+      // List of all the textures. Most are held in the data manager's shared cache
+      RawTexturePointerMap _rawTextures;
 
-      // List of all the sounds
-      RawSoundMap _rawSounds;
+      // Textures this handler owns, because they have been packed into its atlases
+      RawTextureMap _privateTextures;
+
+      // List of all the sounds, held in the data manager's shared cache
+      RawSoundPointerMap _rawSounds;
 
       // List of all the music
       RawMusicMap _rawMusic;
@@ -43,6 +51,16 @@ namespace Regolith
       // List of all the fonts
       RawTextMap _rawTexts;
 
+      // Textures and sounds to decode together before they are requested
+      std::set< std::string > _plannedTextures;
+      std::set< std::string > _plannedSounds;
+
+      // Atlases built from the small textures at load time. Zero maximum size disables packing
+      std::list< RawTexture > _atlases;
+      int _atlasMaxSprite;
+      int _atlasSize;
+      int _atlasPadding;
+
 
     public:
       DataHandler();
@@ -56,7 +74,7 @@ namespace Regolith
       DataHandler& operator=( DataHandler&& ) = delete;
 
 
-      // Deletes all the loaded data
+      // Releases all the loaded data
       void clear();
 
 
@@ -78,6 +96,35 @@ namespace Regolith
       // Get a font with a given name
       RawText* getRawText( std::string );
 
+
+////////////////////////////////////////////////////////////////////////////////
+      // Load planning
+
+      // Add a texture to the load plan, unless it is already loaded
+      void planRawTexture( std::string );
+
+      // Add a sound to the load plan, unless it is already loaded
+      void planRawSound( std::string );
+
+      // Return the number of assets in the load plan
+      unsigned int getPlanSize() const;
+
+      // Decode every planned asset on the job scheduler. The function is called from the decoding thread as each one finishes
+      void loadPlan( std::function< void() > );
+
+
+////////////////////////////////////////////////////////////////////////////////
+      // Runtime atlases
+
+      // Set the largest texture dimension that is packed, the atlas size and the padding between textures
+      void configureAtlases( int, int, int );
+
+      // Pack the loaded textures that haven't been rendered yet into shared atlases. Must be called before they are used
+      void packAtlases();
+
+      // Return the number of runtime atlases
+      size_t getNumberAtlases() const { return _atlases.size(); }
+
   };
 
 }
@@ -32,7 +32,7 @@ namespace Regolith
 
       Link( ContextManager& m ) : _manager( m ) {}
 
-      void renderContextGroup( Camera& c ) { _manager.renderContextGroup( c ); }
+      bool renderContextGroup( Camera& c ) { return _manager.renderContextGroup( c ); }
   };
 
 
@@ -39,6 +39,18 @@ namespace Regolith
       RawSound buildRawSound( std::string s ) const { return _manager.buildRawSound( s ); }
       RawFont buildRawFont( std::string s ) const { return _manager.buildRawFont( s ); }
       RawText buildRawText( std::string s ) const { return _manager.buildRawText( s ); }
+      const Asset& getAsset( std::string s ) const { return _manager.getAsset( s ); }
+
+      bool hasRawTexture( std::string s ) const { return _manager.hasRawTexture( s ); }
+      RawTexture* acquireRawTexture( std::string s ) { return _manager.acquireRawTexture( s ); }
+      RawTexture* acquireRawTexture( std::string s, RawTexture t ) { return _manager.acquireRawTexture( s, t ); }
+      void releaseRawTexture( std::string s ) { _manager.releaseRawTexture( s ); }
+      bool detachRawTexture( std::string s, RawTexture& t ) { return _manager.detachRawTexture( s, t ); }
+
+      bool hasRawSound( std::string s ) const { return _manager.hasRawSound( s ); }
+      RawSound* acquireRawSound( std::string s ) { return _manager.acquireRawSound( s ); }
+      RawSound* acquireRawSound( std::string s, RawSound r ) { return _manager.acquireRawSound( s, r ); }
+      void releaseRawSound( std::string s ) { _manager.releaseRawSound( s ); }
   };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -56,6 +68,7 @@ namespace Regolith
       Link( DataManager& m ) : _manager( m ) {}
 
       RawFont buildRawFont( std::string s ) const { return _manager.buildRawFont( s ); }
+      SDL_RWops* openFile( const std::string& s ) const { return _manager.openFile( s ); }
   };
 
 }
@@ -38,6 +38,27 @@ namespace Regolith
 
       std::mutex& renderMutex() { return _engine._renderMutex; }
       std::atomic<bool>& pause() { return _engine._pause; }
+      RenderQueue& renderQueue() { return _engine._renderQueue; }
+      FramePacer& framePacer() { return _engine._framePacer; }
+  };
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Context manager access
+  class ContextManager;
+
+  template <>
+  class Link< EngineManager, ContextManager >
+  {
+    private:
+
+      EngineManager& _engine;
+
+    public:
+
+      Link( EngineManager& m ) : _engine( m ) {}
+
+      void wakeRenderingThread() { _engine._framePacer.wake(); }
   };
 
 
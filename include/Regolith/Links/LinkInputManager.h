@@ -77,6 +77,7 @@ namespace Regolith
       Link( InputManager& m ) : _manager( m ) {}
 
       void handleEvents( InputHandler* h ) { _manager.handleEvents( h ); }
+      void waitEvents( Uint32 t ) { _manager.waitEvents( t ); }
   };
 
 }
@@ -55,6 +55,65 @@ namespace Regolith
       Link( ThreadManager& m ) : _manager( m ) {}
 
       void registerCondition( std::condition_variable* cv ) { _manager.registerCondition( cv ); }
+      JobScheduler& jobScheduler() { return _manager.jobScheduler(); }
+  };
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Engine Manager access
+  class EngineManager;
+
+  template <>
+  class Link< ThreadManager, EngineManager >
+  {
+    private:
+
+      ThreadManager& _manager;
+
+    public:
+
+      Link( ThreadManager& m ) : _manager( m ) {}
+
+      void registerCondition( std::condition_variable* cv ) { _manager.registerCondition( cv ); }
+      JobScheduler& jobScheduler() { return _manager.jobScheduler(); }
+  };
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Data Handler access
+  class DataHandler;
+
+  template <>
+  class Link< ThreadManager, DataHandler >
+  {
+    private:
+
+      ThreadManager& _manager;
+
+    public:
+
+      Link( ThreadManager& m ) : _manager( m ) {}
+
+      JobScheduler& jobScheduler() { return _manager.jobScheduler(); }
+  };
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Collision Handler access
+  class CollisionHandler;
+
+  template <>
+  class Link< ThreadManager, CollisionHandler >
+  {
+    private:
+
+      ThreadManager& _manager;
+
+    public:
+
+      Link( ThreadManager& m ) : _manager( m ) {}
+
+      JobScheduler& jobScheduler() { return _manager.jobScheduler(); }
   };
 
 }
@@ -19,6 +19,13 @@ namespace Regolith
       TeamNameMap _teamNames;
       TypeNameMap _typeNames;
 
+      // Map the team ids in the configuration to dense indices
+      std::map< int, CollisionTeam > _teamIndices;
+
+
+      // Return the dense index for a team id, adding it if required
+      CollisionTeam findTeamIndex( int );
+
     protected:
 
     public:
@@ -36,10 +43,10 @@ namespace Regolith
       // Teams and types accessors and modifiers
 
       // Forcibly add a collision team
-      void addCollisionTeam( std::string name, CollisionTeam id ) { _teamNames[ name ] = id; }
+      void addCollisionTeam( std::string name, CollisionTeam id ) { _teamNames[ name ] = findTeamIndex( id ); }
 
-      // Return the number of teams
-      size_t getNumberTeams() const { return _teamNames.size(); }
+      // Return the number of teams. Teams are dense indices from zero to one less than this.
+      size_t getNumberTeams() const { return _teamIndices.size(); }
 
       // Return the team ID for a given name
       CollisionTeam getCollisionTeam( std::string name );
@@ -56,7 +56,8 @@ namespace Regolith
       // Rendering thread accessible functions
 
       // Performs rendering operations on a context group. For the engine to use.
-      void renderContextGroup( Camera& );
+      // Returns true if the group still has objects waiting to be rendered.
+      bool renderContextGroup( Camera& );
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -6,11 +6,15 @@
 #include "Regolith/Architecture/Component.h"
 #include "Regolith/Utilities/MutexedBuffer.h"
 #include "Regolith/Assets/RawObjectDetails.h"
+#include "Regolith/Assets/AssetArchive.h"
+#include "Regolith/Assets/RawTexture.h"
+#include "Regolith/Assets/RawSound.h"
 
 #include <thread>
 #include <mutex>
 #include <vector>
 #include <map>
+#include <set>
 
 
 namespace Regolith
@@ -31,6 +35,10 @@ namespace Regolith
    *
    * The Data Loading Thread loads the assets requested by the data handlers into memory for the
    * current context groups to use.
+   *
+   * Decoded textures and sounds are owned by a shared cache with a reference count for every data
+   * handler that holds them. A group acquires its assets as it loads and releases them as it unloads,
+   * so anything still used by the global group or the group loading next is never decoded twice.
    */
   class DataManager : public Component
   {
@@ -43,6 +51,17 @@ namespace Regolith
     DataManager operator=( const DataManager& ) = delete;
     DataManager operator=( DataManager&& ) = delete;
 
+    // A decoded asset and the number of handlers using it
+    template < class RAW >
+    struct SharedAsset
+    {
+      RAW raw;
+      unsigned int references;
+    };
+
+    typedef std::map< std::string, SharedAsset< RawTexture > > SharedTextureMap;
+    typedef std::map< std::string, SharedAsset< RawSound > > SharedSoundMap;
+
     private:
       // Path to the list of all texture files and their modifiers
       std::string _indexFile;
@@ -50,9 +69,23 @@ namespace Regolith
       // Map of all the assets that can be used
       AssetMap _assets;
 
+      // Optional packed archive of the asset files
+      AssetArchive _archive;
+
+      // Names of the images that other images are packed into
+      std::set< std::string > _atlasNames;
+
+      // Decoded assets shared by all the data handlers
+      SharedTextureMap _sharedTextures;
+      SharedSoundMap _sharedSounds;
+      mutable std::mutex _cacheMutex;
+
 
     protected:
 
+      // Open an asset file for reading, from the archive if it contains it, otherwise from the disk
+      SDL_RWops* openFile( const std::string& ) const;
+
       // Only data handlers can own data
 
       // Build a raw texture object with null pointer for a data handler
@@ -71,6 +104,36 @@ namespace Regolith
       RawText buildRawText( std::string ) const;
 
 
+      // Shared cache. Every acquire must be matched by a release
+
+      // Return true if the texture is already decoded
+      bool hasRawTexture( std::string ) const;
+
+      // Return the shared texture, decoding it if required
+      RawTexture* acquireRawTexture( std::string );
+
+      // Return the shared texture, using the decoded one provided if it isn't already cached
+      RawTexture* acquireRawTexture( std::string, RawTexture );
+
+      // Release a texture. It is freed when no handler uses it
+      void releaseRawTexture( std::string );
+
+      // Move a texture out of the cache if only one handler uses it, so that handler can modify it. Returns false otherwise
+      bool detachRawTexture( std::string, RawTexture& );
+
+      // Return true if the sound is already decoded
+      bool hasRawSound( std::string ) const;
+
+      // Return the shared sound, decoding it if required
+      RawSound* acquireRawSound( std::string );
+
+      // Return the shared sound, using the decoded one provided if it isn't already cached
+      RawSound* acquireRawSound( std::string, RawSound );
+
+      // Release a sound. It is freed when no handler uses it
+      void releaseRawSound( std::string );
+
+
     public:
       // Con/de-struction
       DataManager();
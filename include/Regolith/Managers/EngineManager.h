@@ -6,6 +6,8 @@
 #include "Regolith/Architecture/Component.h"
 #include "Regolith/Managers/InputManager.h"
 #include "Regolith/GamePlay/Timers.h"
+#include "Regolith/GamePlay/RenderQueue.h"
+#include "Regolith/GamePlay/FramePacer.h"
 
 #include <mutex>
 
@@ -52,6 +54,27 @@ namespace Regolith
       // Count the frame times. Provide update time for loops and estimate FPS.
       FrameTimer _frameTimer;
 
+      // Flag to advance the contexts in fixed steps rather than by the length of each frame
+      bool _fixedTimestep;
+
+      // Length of a fixed step in milliseconds
+      float _timestep;
+
+      // Maximum number of fixed steps per frame. Any further time is dropped rather than caught up
+      unsigned int _maxSteps;
+
+      // Frame time not yet simulated
+      float _accumulator;
+
+      // Fraction of a fixed step in the accumulator. Objects are recorded this far between their last two updates
+      float _interpolation;
+
+      // Draw commands recorded after each update and replayed by the rendering thread
+      RenderQueue _renderQueue;
+
+      // Sleeps the engine and rendering threads between frames
+      FramePacer _framePacer;
+
       // Store the pause state
       std::atomic<bool> _pause;
 
@@ -64,6 +87,15 @@ namespace Regolith
       // Function which checks the current context stack and performs the queued operations
       bool performStackOperations();
 
+      // Wait for the rendering thread to finish with the render queue. Must be called while holding the render mutex
+      void flushRenderQueue();
+
+      // Update all the visible, unpaused contexts by the given time
+      void updateContexts( float );
+
+      // Record the draw commands for all the visible contexts and pass them to the rendering thread
+      void recordContexts();
+
 
     public:
       // Create the engine with the required references in place
@@ -72,6 +104,12 @@ namespace Regolith
       // Just in case I decided to inherit from here in the future...
       virtual ~EngineManager();
 
+      // Configure the simulation and frame timing
+      void configure( Json::Value& );
+
+      // Tell the frame pacer whether the window presents are synchronised to the display
+      void setVSync( bool v ) { _framePacer.setVSync( v ); }
+
       // Start the engine running. In order to stop it the quit() function must be used.
       void run();
 
@@ -101,6 +139,15 @@ namespace Regolith
       // Return the current estimated FPS of the engine
       float getFPS() const { return _frameTimer.getAvgFPS(); }
 
+      // Return true if the contexts are advanced in fixed steps
+      bool isFixedTimestep() const { return _fixedTimestep; }
+
+      // Return the length of a fixed step in milliseconds
+      float getTimestep() const { return _timestep; }
+
+      // Return the number of frame deadlines missed since the last report
+      unsigned long getMissedFrames() const { return _framePacer.getMissedFrames(); }
+
 
       // Fulfill the interface for a component
       // Register game-wide events with the manager
@@ -83,6 +83,9 @@ namespace Regolith
       // Iterate through all the SDL events and use the provided input handler to distribute user events
       void handleEvents( InputHandler* );
 
+      // Sleep until an event arrives or the timeout in milliseconds has passed. The event is left in the queue
+      void waitEvents( Uint32 );
+
 
 ////////////////////////////////////////////////////////////////////////////////
       // Signal access
@@ -121,6 +121,9 @@ namespace Regolith
       // Return a collision team id
       CollisionTeam getCollisionTeam( std::string );
 
+      // Return the number of collision teams. Team ids run from zero to one less than this.
+      size_t getNumberTeams() const;
+
       // Return a collision type id
       CollisionType getCollisionType( std::string );
 
@@ -5,6 +5,7 @@
 #include "Regolith/Global/Global.h"
 #include "Regolith/Architecture/Component.h"
 #include "Regolith/Utilities/Condition.h"
+#include "Regolith/Utilities/JobScheduler.h"
 
 #include <thread>
 #include <mutex>
@@ -56,6 +57,13 @@ namespace Regolith
       ConditionList _conditionVariables;
 
 
+      // General purpose workers for any subsystem that can split its work into jobs
+      JobScheduler _jobScheduler;
+
+      // Number of job workers to start
+      unsigned int _numberWorkers;
+
+
     protected:
 
       // Used by the thread handlers to update their respective status' status
@@ -68,6 +76,9 @@ namespace Regolith
       // Register a condition variable so that it can be triggered in the event of an error
       void registerCondition( std::condition_variable* );
 
+      // Return the job scheduler
+      JobScheduler& jobScheduler() { return _jobScheduler; }
+
 
     public:
       // Con/Destructors
@@ -75,6 +86,9 @@ namespace Regolith
 
       ~ThreadManager();
 
+      // Configure the job workers
+      void configure( Json::Value& );
+
 
       // Stop the threads with error signals
       void error();
@@ -102,6 +102,9 @@ namespace Regolith
       // Update the title
       void setTitle( std::string );
 
+      // Return true if the presents are synchronised to the display
+      bool isVSync() const { return _vsyncOn; }
+
 //////////////////////////////////////////////////////////////////////////////// 
       // WindowManager state accessors
 
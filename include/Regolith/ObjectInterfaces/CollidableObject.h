@@ -39,13 +39,50 @@ namespace Regolith
   };
 
 
+  class CollidableObject;
+
+  // Hitbox index used for the bounding box of a container
+  const unsigned int container_hit_box = static_cast< unsigned int >( -1 );
+
+  // A detected collision between two objects, waiting to be resolved
+  struct ContactPair
+  {
+    CollidableObject* object1;
+    CollidableObject* object2;
+
+    // Index of the hitbox on each object that touched
+    unsigned int hitBox1;
+    unsigned int hitBox2;
+
+    Contact contact1;
+    Contact contact2;
+  };
+
+  typedef std::vector< ContactPair > ContactBuffer;
+
+
 
   class CollidableObject : virtual public PhysicalObject
   {
     private:
+      // World-space copies of the bounding box and the active hitboxes.
+      // Rebuilt only when the position, rotation or active hitbox frame changes.
+      Vector _worldBoundingPoints[4];
+      Vector _worldBoundingNormals[4];
+      Collision::HitBoxVector _worldHitBoxes;
+      std::vector< HitBoxSoA > _worldPackedHitBoxes;
+
+      // State the cache was built for
+      bool _cacheValid;
+      Vector _cachePosition;
+      float _cacheRotation;
+      const HitBox* _cacheFrame;
+
+      // Collision model the cache was built from
+      const Collision* _cacheCollision;
 
     public:
-      CollidableObject() {}
+      CollidableObject();
       virtual ~CollidableObject() {}
 
 
@@ -59,6 +96,33 @@ namespace Regolith
       // Call back function for when this object collides with another
       virtual void onCollision( Contact&, CollidableObject* ) = 0;
 
+
+      // Rebuild the world-space hitboxes if the object has moved, rotated or changed frame since the last call
+      void updateWorldHitBoxes();
+
+      // Force the cache to be rebuilt on the next update
+      void invalidateWorldHitBoxes() { _cacheValid = false; }
+
+      // World-space bounding box vertices and edge normals. Valid after updateWorldHitBoxes()
+      const Vector* worldBoundingPoints() const { return _worldBoundingPoints; }
+      const Vector* worldBoundingNormals() const { return _worldBoundingNormals; }
+
+      // World-space versions of the active hitboxes. Valid after updateWorldHitBoxes()
+      const Collision::HitBoxVector& worldHitBoxes() const { return _worldHitBoxes; }
+
+      // Structure-of-arrays copies of the world-space hitboxes, in the same order. Valid after updateWorldHitBoxes()
+      const std::vector< HitBoxSoA >& worldPackedHitBoxes() const { return _worldPackedHitBoxes; }
+
+      // Collision model the world-space hitboxes were built from. Valid after updateWorldHitBoxes()
+      const Collision* worldCollision() const { return _cacheCollision; }
+
+      // Return true if the world-space hitboxes can be queried by region
+      bool hasIndexedHitBoxes() const { return _cacheCollision != nullptr && _cacheCollision->isIndexed(); }
+
+      // Append the indices of the world-space hitboxes that may overlap a world-space axis-aligned region, given by
+      // its lower and upper corners. Only valid if hasIndexedHitBoxes() is true.
+      void findWorldHitBoxes( const Vector&, const Vector&, std::vector< size_t >& ) const;
+
   };
 
 }
@@ -38,7 +38,7 @@ namespace Regolith
       virtual void updateContext( float ) override;
 
       // Called at the end of the render loop to do any context-specific rendering (e.g. transitions)
-      virtual void renderContext( Camera& );
+      virtual void renderContext( RenderQueue& );
 
     public:
       // Trivial Constructor
@@ -51,6 +51,9 @@ namespace Regolith
       // Resets the object to it's initial configuration to allow reusing of objects
       virtual void reset() override;
 
+      // Uses the default integrator, so can be stepped by the context's physics store
+      virtual bool usesPhysicsStore() const override { return true; }
+
 
 ////////////////////////////////////////////////////////////////////////////////
       // Specifc functions for enabling physics and rendering on the object
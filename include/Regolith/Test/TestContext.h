@@ -41,7 +41,7 @@ namespace Regolith
       virtual void updateContext( float ) override;
 
       // Called at the end of the render loop to do any context-specific rendering (e.g. transitions)
-      virtual void renderContext( Camera& ) override {}
+      virtual void renderContext( RenderQueue& ) override {}
 
     public:
       // Trivial Constructor
@@ -46,6 +46,12 @@ namespace Regolith
       // Return the rotation value
       virtual double getRotation() { return _rotation; }
 
+      // Return the blend mode. Textures are blended unless another mode was requested
+      virtual SDL_BlendMode getBlendMode() override { return ( _blendMod == SDL_BLENDMODE_NONE ? SDL_BLENDMODE_BLEND : _blendMod ); }
+
+      // Return the colour and alpha modulation
+      virtual SDL_Color getColourMod() override;
+
 
       // Return a pointer to the surface to render
       virtual SDL_Surface* getUpdateSurface() { return _theSurface; }
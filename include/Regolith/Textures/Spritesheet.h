@@ -18,6 +18,10 @@ namespace Regolith
     private:
       // Pointer to the raw sdl texture
       mutable RawTexture* _rawTexture;
+
+      // The texture that holds the pixels. Either the raw texture or the atlas it is packed into
+      mutable RawTexture* _sourceTexture;
+
       SDL_RendererFlip _flipFlag;
       SDL_Rect _clip;
       double _rotation;
@@ -30,7 +34,7 @@ namespace Regolith
       // Functions required to make this object render-able
 
       // Return a pointer the raw, SDL texture
-      virtual SDL_Texture* getSDLTexture() { return _rawTexture->sdl_texture; }
+      virtual SDL_Texture* getSDLTexture() { return _sourceTexture->sdl_texture; }
 
       // Return a pointer to the clip rect for the rendering process
       virtual SDL_Rect* getClip() { return &_clip; }
@@ -43,7 +47,7 @@ namespace Regolith
 
 
       // Return a pointer to the surface to render
-      virtual SDL_Surface* getUpdateSurface() { return _rawTexture->surface; }
+      virtual SDL_Surface* getUpdateSurface() { return _sourceTexture->surface; }
 
       // Set the newly rendered texture
       virtual void setRenderedTexture( SDL_Texture* t );
@@ -59,7 +63,7 @@ namespace Regolith
       virtual ~Spritesheet();
 
       // Return true if a surface needs to be rendered
-      virtual bool update() const { return ( _rawTexture != nullptr ) && ( _rawTexture->sdl_texture == nullptr ); }
+      virtual bool update() const { return ( _sourceTexture != nullptr ) && ( _sourceTexture->sdl_texture == nullptr ); }
 
 
       // Configures as a sprite sheet with optional animation. No. rows, No. Columns, and No. of used cells and update period
@@ -25,8 +25,9 @@ namespace Regolith
    */
   class Texture
   {
-    // Allow the camera special access for rendering
+    // Allow the camera and render queue special access for rendering
     friend class Camera;
+    friend class RenderQueue;
 
 ////////////////////////////////////////////////////////////////////////////////
       // Private member variables
@@ -49,6 +50,12 @@ namespace Regolith
       // Return the rotation value
       virtual double getRotation() = 0;
 
+      // Return the blend mode used to draw the texture
+      virtual SDL_BlendMode getBlendMode() { return SDL_BLENDMODE_BLEND; }
+
+      // Return the colour and alpha modulation applied when drawing
+      virtual SDL_Color getColourMod() { return { 255, 255, 255, 255 }; }
+
 
       // Return a pointer to the surface to render
       virtual SDL_Surface* getUpdateSurface() = 0;
@@ -0,0 +1,81 @@
+
+#ifndef REGOLITH_UTILITIES_ATLAS_PACKER_H_
+#define REGOLITH_UTILITIES_ATLAS_PACKER_H_
+
+#include "Regolith/Global/Global.h"
+
+#include <vector>
+
+
+namespace Regolith
+{
+
+  /*
+   * Packs rectangles into a fixed size atlas using the skyline bottom-left heuristic.
+   * The top edge of the packed rectangles is stored as a list of horizontal segments, and each new rectangle is
+   * placed where it sits lowest, preferring the narrowest segment on a tie.
+   * Packing is best when the rectangles are inserted tallest first.
+   */
+  class AtlasPacker
+  {
+    struct Segment
+    {
+      int x;
+      int y;
+      int width;
+    };
+
+    typedef std::vector< Segment > Skyline;
+
+    private:
+      // Atlas dimensions
+      int _width;
+      int _height;
+
+      // Empty pixels kept between neighbouring rectangles
+      int _padding;
+
+      // The top edge of the packed area, ordered left to right
+      Skyline _skyline;
+
+      // Total area of the inserted rectangles, without padding
+      long _usedArea;
+
+
+    protected:
+      // Return the height a rectangle would sit at if placed at the given segment, or -1 if it doesn't fit
+      int _fit( size_t, int, int ) const;
+
+      // Raise the skyline under a newly placed rectangle
+      void _place( size_t, int, int, int );
+
+
+    public:
+      AtlasPacker( int, int, int padding = 0 );
+
+      ~AtlasPacker();
+
+
+      // Remove all the packed rectangles
+      void reset();
+
+      // Find a position for a rectangle of the given size. Returns false if there is no room left
+      bool insert( int, int, SDL_Point& );
+
+
+      // Return the dimensions of the atlas
+      int getWidth() const { return _width; }
+      int getHeight() const { return _height; }
+
+      // Return the height of the tallest column of packed rectangles
+      int getUsedHeight() const;
+
+      // Return the fraction of the atlas covered by rectangles
+      float getOccupancy() const;
+
+  };
+
+}
+
+#endif // REGOLITH_UTILITIES_ATLAS_PACKER_H_
+
@@ -0,0 +1,30 @@
+
+#ifndef REGOLITH_UTILITIES_COMPRESSION_H_
+#define REGOLITH_UTILITIES_COMPRESSION_H_
+
+#include "Regolith/Global/Global.h"
+
+#include <vector>
+
+
+namespace Regolith
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // LZ4 block compression
+  /*
+   * Streams are written in the standard LZ4 block format, without the frame header, so the size of the
+   * uncompressed data must be stored alongside them. Compression is a single greedy pass, tuned for fast
+   * decompression rather than ratio.
+   */
+
+  // Compress the data into the vector, replacing its contents. Returns the compressed size
+  size_t compressLZ4( const unsigned char*, size_t, std::vector< unsigned char >& );
+
+  // Decompress a block into a buffer of exactly the uncompressed size. Returns false if the block is corrupt
+  bool decompressLZ4( const unsigned char*, size_t, unsigned char*, size_t );
+
+}
+
+#endif // REGOLITH_UTILITIES_COMPRESSION_H_
+
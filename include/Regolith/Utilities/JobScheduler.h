@@ -0,0 +1,133 @@
+
+#ifndef REGOLITH_UTILITIES_JOB_SCHEDULER_H_
+#define REGOLITH_UTILITIES_JOB_SCHEDULER_H_
+
+#include "Regolith/Global/Global.h"
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+
+namespace Regolith
+{
+
+  /*
+   * Work-stealing job scheduler.
+   *
+   * Each worker thread owns a deque of jobs. Jobs submitted by a worker go on the back of its own deque and it takes
+   * them from the back again, so related work stays on the same core. Idle workers steal from the front of the other
+   * deques. Jobs submitted from any other thread go into a shared queue that all the workers take from.
+   *
+   * A job may be given a parent when it is created. A parent is not finished until its own task and all of its
+   * children have finished, so a tree of work can be waited on through the root. Only root jobs can be waited on and
+   * every root must be waited on exactly once; children are deleted automatically when they finish. Waiting threads
+   * execute other jobs instead of blocking, so jobs may create and wait on their own roots.
+   *
+   * The first exception thrown by a job is rethrown by the wait on its root. If the error flag is raised the workers
+   * stop taking jobs. Waits then discard the queued jobs without executing them, but still wait for the jobs that are
+   * already executing to finish, so a job never outlives the data of the thread that waits on it.
+   */
+  class JobScheduler
+  {
+    public:
+      typedef std::function< void() > Task;
+
+      // Task for a range of indices, [start, end)
+      typedef std::function< void( size_t, size_t ) > RangeTask;
+
+      struct Job;
+
+    private:
+      // Queue of jobs for one worker
+      struct WorkerQueue
+      {
+        std::deque< Job* > jobs;
+        std::mutex mutex;
+      };
+
+      std::vector< std::thread > _threads;
+
+      // One queue per worker
+      std::vector< WorkerQueue* > _queues;
+
+      // Queue for jobs submitted by any other thread
+      WorkerQueue _shared;
+
+      // Number of jobs waiting in all the queues
+      std::atomic< unsigned int > _queued;
+
+      // Idle workers and waiting threads sleep on this
+      std::mutex _sleepMutex;
+      std::condition_variable _sleepCondition;
+
+      // Protects the exceptions stored in the root jobs
+      std::mutex _exceptionMutex;
+
+      std::atomic< bool > _quit;
+
+
+      // Worker thread loop
+      void work( unsigned int );
+
+      // Take the next job for the given worker, stealing if its own queue is empty. Other threads use the worker count
+      Job* findJob( unsigned int );
+
+      // Execute a job and mark it finished
+      void execute( Job* );
+
+      // Mark one part of a job finished, finishing the parents as required
+      void finish( Job* );
+
+      // Return the worker index of the calling thread, or the worker count for any other thread
+      unsigned int workerIndex() const;
+
+      // Wake one sleeping thread, or all of them
+      void notify( bool );
+
+    public:
+      // Con/Destruction
+      JobScheduler();
+      ~JobScheduler();
+
+      JobScheduler( const JobScheduler& ) = delete;
+      JobScheduler& operator=( const JobScheduler& ) = delete;
+
+
+      // Start the given number of worker threads
+      void start( unsigned int );
+
+      // Stop and join the workers. Queued jobs are only executed if something still waits on them
+      void stop();
+
+      // Return the number of worker threads
+      unsigned int size() const { return _threads.size(); }
+
+      // Return the condition variable so that waiting threads can be woken by an error
+      std::condition_variable* getCondition() { return &_sleepCondition; }
+
+
+      // Create a job, optionally as a child of another unfinished job. It does not run until it is submitted
+      Job* create( Task, Job* parent = nullptr );
+
+      // Queue a job to be executed
+      void submit( Job* );
+
+      // Execute other jobs until the root job and all its children have finished, then delete it.
+      // After an error the queued jobs are discarded instead of executed
+      void wait( Job* );
+
+      // Split the range [0, number) into blocks of at most the grain size and execute them in parallel.
+      // Returns when every block has finished
+      void parallelFor( size_t number, size_t grain, RangeTask );
+  };
+
+}
+
+#endif // REGOLITH_UTILITIES_JOB_SCHEDULER_H_
+
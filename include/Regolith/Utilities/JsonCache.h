@@ -0,0 +1,126 @@
+
+#ifndef REGOLITH_UTILITIES_JSON_CACHE_H_
+#define REGOLITH_UTILITIES_JSON_CACHE_H_
+
+#include "Regolith/Global/Global.h"
+
+#include <map>
+#include <set>
+#include <list>
+#include <mutex>
+#include <sys/stat.h>
+
+
+namespace Regolith
+{
+
+  /*
+   * Process-wide cache of parsed json documents, used by loadJsonData.
+   *
+   * Documents are keyed by path and are reparsed if the file's modification time or size has changed. Modification
+   * times have nanosecond resolution on Linux. Elsewhere they fall back to whole seconds, so an edit that keeps the
+   * file size the same within the same second can be missed. Every document
+   * is tagged with the owners that loaded it, set for the calling thread with a Scope. Invalidating an owner removes its
+   * tag and drops any document that no other owner is still using. Untagged documents are only removed to stay under
+   * the file size budget, discarding the least recently used first.
+   *
+   * The budget is measured in bytes of the source files on disk, not the memory used by the parsed documents, which is
+   * typically several times larger. It bounds the number and size of the cached files rather than the heap usage.
+   */
+  class JsonCache
+  {
+    public:
+      // Tags every document loaded by this thread with an owner while it exists
+      class Scope
+      {
+        private:
+          const void* _previous;
+
+        public:
+          explicit Scope( const void* );
+          ~Scope();
+
+          Scope( const Scope& ) = delete;
+          Scope& operator=( const Scope& ) = delete;
+      };
+
+    private:
+      typedef std::list< std::string > RecentList;
+
+      struct Document
+      {
+        Json::Value data;
+        long long modified;
+        size_t size;
+        std::set< const void* > owners;
+        RecentList::iterator recent;
+      };
+
+      typedef std::map< std::string, Document > DocumentMap;
+
+
+      mutable std::mutex _mutex;
+
+      DocumentMap _documents;
+
+      // Most recently used documents at the front
+      RecentList _recent;
+
+      // Budget for, and total of, the on-disk sizes of the cached files
+      size_t _fileSizeLimit;
+      size_t _fileSizeUsed;
+
+      unsigned long _hits;
+      unsigned long _misses;
+
+
+      // Private construction - use getInstance()
+      JsonCache();
+
+      // Remove a document
+      void erase( DocumentMap::iterator );
+
+      // Return the modification time of a file in nanoseconds, at the best resolution the platform provides
+      static long long modificationTime( const struct stat& );
+
+      // Parse a file from disk. Returns false if there were errors
+      static bool parse( Json::Value&, const std::string& );
+
+    public:
+      ~JsonCache();
+
+      JsonCache( const JsonCache& ) = delete;
+      JsonCache& operator=( const JsonCache& ) = delete;
+
+      // Return the single instance
+      static JsonCache& getInstance();
+
+
+      // Load the parsed contents of a file, from the cache if it is unchanged
+      void load( Json::Value&, const std::string& );
+
+      // Remove the owner from every document and drop the documents it was the last owner of
+      void invalidate( const void* );
+
+      // Empty the cache
+      void clear();
+
+
+      // Set the maximum total on-disk size of the cached files in bytes
+      void setFileSizeLimit( size_t );
+
+      // Return the total on-disk size of the cached files in bytes
+      size_t getFileSizeUsed() const;
+
+      // Return the number of cached documents
+      size_t size() const;
+
+      // Return the number of loads served from the cache and from disk
+      unsigned long getHits() const;
+      unsigned long getMisses() const;
+  };
+
+}
+
+#endif // REGOLITH_UTILITIES_JSON_CACHE_H_
+
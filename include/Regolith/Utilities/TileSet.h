@@ -56,6 +56,9 @@ namespace Regolith
       ~TileSet();
 
 
+      // Return true if neighbouring cells can be joined when building hitboxes
+      bool getOptimize() const { return _optimize; }
+
       // Return the width of a tile
       float getTileWidth() const { return _tileWidth; }
 
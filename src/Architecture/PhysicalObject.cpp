@@ -5,6 +5,8 @@
 #include "Regolith/Handlers/DataHandler.h"
 #include "Regolith/Utilities/JsonValidation.h"
 
+#include <cmath>
+
 
 namespace Regolith
 {
@@ -14,8 +16,12 @@ namespace Regolith
     _hasTranslatable( false ),
     _hasRotatable( false ),
     _hasPhysics( false ),
+    _isBullet( false ),
     _position(),
+    _previousPosition(),
     _rotation( 0.0 ),
+    _lastFramePosition(),
+    _lastFrameRotation( 0.0 ),
     _flipFlag( SDL_FLIP_NONE ),
     _center(),
     _centerPoint( {0, 0} ),
@@ -29,7 +35,13 @@ namespace Regolith
     _forces(),
     _angularVel( 0.0 ),
     _torques( 0.0 ),
-    _collisionTeam( 0 )
+    _collisionTeam( 0 ),
+    _sleeping( false ),
+    _restFrames( 0 ),
+    _island( this ),
+    _islandAwake( false ),
+    _physicsStore( nullptr ),
+    _physicsSlot( 0 )
   {
   }
 
@@ -40,8 +52,12 @@ namespace Regolith
     _hasTranslatable( other._hasTranslatable ),
     _hasRotatable( other._hasRotatable ),
     _hasPhysics( other._hasPhysics ),
-    _position( other._position ),
-    _rotation( other._rotation ),
+    _isBullet( other._isBullet ),
+    _position( other.getPosition() ),
+    _previousPosition( other.getPosition() ),
+    _rotation( other.getRotation() ),
+    _lastFramePosition( other.getPosition() ),
+    _lastFrameRotation( other.getRotation() ),
     _flipFlag( other._flipFlag ),
     _center( other._center ),
     _centerPoint( other._centerPoint ),
@@ -51,11 +67,17 @@ namespace Regolith
     _inverseInertiaDensity( other._inverseInertiaDensity ),
     _elasticity( other._elasticity ),
     _boundingBox( other._boundingBox ),
-    _velocity( other._velocity ),
+    _velocity( other.getVelocity() ),
     _forces(),
-    _angularVel( other._angularVel ),
+    _angularVel( other.getAngularVelocity() ),
     _torques( 0.0 ),
-    _collisionTeam( other._collisionTeam )
+    _collisionTeam( other._collisionTeam ),
+    _sleeping( false ),
+    _restFrames( 0 ),
+    _island( this ),
+    _islandAwake( false ),
+    _physicsStore( nullptr ),
+    _physicsSlot( 0 )
   {
   }
 
@@ -63,6 +85,10 @@ namespace Regolith
   // Destroy the children
   PhysicalObject::~PhysicalObject()
   {
+    if ( _physicsStore != nullptr )
+    {
+      _physicsStore->detach( this );
+    }
   }
 
 
@@ -81,6 +107,12 @@ namespace Regolith
     _hasPhysics = json_data["has_physics"].asBool();
 
 
+    // Fast objects can request swept collision tests
+    if ( validateJson( json_data, "bullet", JsonType::BOOLEAN, false ) )
+    {
+      _isBullet = json_data["bullet"].asBool();
+    }
+
     // Set the mass properties - Determine if an object can even be moved
     if ( validateJson( json_data, "mass", JsonType::FLOAT, false ) )
     {
@@ -107,12 +139,15 @@ namespace Regolith
       float x =  json_data["position"][0].asFloat();
       float y =  json_data["position"][1].asFloat();
       _position = Vector( x, y );
+      _previousPosition = _position;
+      _lastFramePosition = _position;
     }
 
     // Set the starting rotation (defaults to zero)
     if ( validateJson( json_data, "rotation", JsonType::FLOAT, false ) )
     {
       _rotation =  json_data["rotation"].asFloat() * degrees_to_radians;
+      _lastFrameRotation = _rotation;
     }
 
     // Set the center point for the object, w.r.t the bounding box
@@ -188,9 +223,18 @@ namespace Regolith
   void PhysicalObject::reset()
   {
     _destroyMe = false;
-    _velocity.zero();
-    _angularVel = 0.0;
-    _forces.zero();
+    setVelocity( zeroVector );
+    setAngularVelocity( 0.0 );
+
+    if ( _physicsStore == nullptr )
+      _forces.zero();
+    else
+      _physicsStore->setForces( _physicsSlot, zeroVector );
+
+    _sleeping = false;
+    _restFrames = 0;
+    resetIsland();
+    updatePhysicsSlot();
   }
 
 
@@ -204,6 +248,8 @@ namespace Regolith
       _inverseMass = 0.0;
     else
       _inverseMass = 1.0/_mass;
+
+    updatePhysicsSlot();
   }
 
 
@@ -214,6 +260,8 @@ namespace Regolith
       _inverseInertiaDensity = 0.0;
     else
       _inverseInertiaDensity = 1.0/_inertiaDensity;
+
+    updatePhysicsSlot();
   }
 
 
@@ -244,6 +292,37 @@ namespace Regolith
   }
 
 
+  void PhysicalObject::addForce( Vector f )
+  {
+    if ( _physicsStore == nullptr )
+      _forces += f;
+    else
+      _physicsStore->setForces( _physicsSlot, _physicsStore->getForces( _physicsSlot ) + f );
+
+    wake();
+  }
+
+
+  void PhysicalObject::addTorque( float t )
+  {
+    if ( _physicsStore == nullptr )
+      _torques += t;
+    else
+      _physicsStore->setTorque( _physicsSlot, _physicsStore->getTorque( _physicsSlot ) + t );
+
+    wake();
+  }
+
+
+  void PhysicalObject::updatePhysicsSlot()
+  {
+    if ( _physicsStore != nullptr )
+    {
+      _physicsStore->updateSlot( _physicsSlot );
+    }
+  }
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
   // Functions that enable physics
 
@@ -252,6 +331,16 @@ namespace Regolith
   {
     // Starting with Euler Step algorithm.
     // Might move to leap-frog/Runge-Kutta later
+    // Objects in a physics store are integrated by the store. PhysicsStore::integrate must be kept in step with this.
+
+    // Objects that are shared with a context that owns the slot are stepped in place
+    if ( _physicsStore != nullptr )
+    {
+      _physicsStore->step( _physicsSlot, time );
+      return;
+    }
+
+    _previousPosition = _position;
 
     if ( _hasTranslatable )
     {
@@ -276,6 +365,93 @@ namespace Regolith
     }
   }
 
+
+  void PhysicalObject::clampStep( float fraction )
+  {
+    Vector previous = previousPosition();
+    setPosition( previous + fraction * ( getPosition() - previous ) );
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Sleeping and islands
+
+  void PhysicalObject::wake()
+  {
+    if ( ! _sleeping ) return;
+
+    _sleeping = false;
+    _restFrames = 0;
+    updatePhysicsSlot();
+
+    // Waking the root lets the context wake the rest of the island
+    if ( _island != this )
+    {
+      _island->wake();
+    }
+  }
+
+
+  void PhysicalObject::sleep()
+  {
+    _sleeping = true;
+
+    setVelocity( zeroVector );
+    setAngularVelocity( 0.0 );
+
+    if ( _physicsStore == nullptr )
+    {
+      _forces.zero();
+      _torques = 0.0;
+    }
+    else
+    {
+      _physicsStore->setForces( _physicsSlot, zeroVector );
+      _physicsStore->setTorque( _physicsSlot, 0.0 );
+    }
+
+    updatePhysicsSlot();
+  }
+
+
+  void PhysicalObject::updateRest( float linear_threshold, float angular_threshold )
+  {
+    if ( getVelocity().square() < linear_threshold*linear_threshold && std::fabs( getAngularVelocity() ) < angular_threshold )
+    {
+      ++_restFrames;
+    }
+    else
+    {
+      _restFrames = 0;
+    }
+  }
+
+
+  PhysicalObject* PhysicalObject::findIsland()
+  {
+    // Path halving keeps the trees shallow
+    PhysicalObject* root = this;
+    while ( root->_island != root )
+    {
+      root->_island = root->_island->_island;
+      root = root->_island;
+    }
+    return root;
+  }
+
+
+  void PhysicalObject::joinIsland( PhysicalObject* other )
+  {
+    PhysicalObject* root = this->findIsland();
+    PhysicalObject* other_root = other->findIsland();
+
+    if ( root != other_root )
+    {
+      other_root->_island = root;
+    }
+  }
+
+
   /*
   // Copy of the Runge Kutta Order 4 integration algorith for a future me...
 
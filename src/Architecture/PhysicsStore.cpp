@@ -0,0 +1,353 @@
+
+#include "Regolith/Architecture/PhysicsStore.h"
+#include "Regolith/Architecture/PhysicalObject.h"
+
+#if defined REGOLITH_SIMD_AVX2
+#include <immintrin.h>
+#elif defined REGOLITH_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+
+namespace Regolith
+{
+
+  PhysicsStore::PhysicsStore() :
+    _owners(),
+    _positionX(),
+    _positionY(),
+    _previousX(),
+    _previousY(),
+    _velocityX(),
+    _velocityY(),
+    _forceX(),
+    _forceY(),
+    _inverseMass(),
+    _rotation(),
+    _angularVel(),
+    _torque(),
+    _inverseInertiaDensity(),
+    _translateMask(),
+    _rotateMask(),
+    _moveMask()
+  {
+  }
+
+
+  PhysicsStore::~PhysicsStore()
+  {
+    // Hand the state back to any objects that outlive the store
+    clear();
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Slot management
+
+  void PhysicsStore::reserveSlots( size_t number )
+  {
+    size_t padded = ( ( number + REGOLITH_SIMD_WIDTH - 1 ) / REGOLITH_SIMD_WIDTH ) * REGOLITH_SIMD_WIDTH;
+    if ( padded <= _positionX.size() ) return;
+
+    // New slots are zeroed, so the padding is never integrated
+    _positionX.resize( padded, 0.0 );
+    _positionY.resize( padded, 0.0 );
+    _previousX.resize( padded, 0.0 );
+    _previousY.resize( padded, 0.0 );
+    _velocityX.resize( padded, 0.0 );
+    _velocityY.resize( padded, 0.0 );
+    _forceX.resize( padded, 0.0 );
+    _forceY.resize( padded, 0.0 );
+    _inverseMass.resize( padded, 0.0 );
+    _rotation.resize( padded, 0.0 );
+    _angularVel.resize( padded, 0.0 );
+    _torque.resize( padded, 0.0 );
+    _inverseInertiaDensity.resize( padded, 0.0 );
+    _translateMask.resize( padded, 0.0 );
+    _rotateMask.resize( padded, 0.0 );
+    _moveMask.resize( padded, 0.0 );
+  }
+
+
+  void PhysicsStore::copySlot( size_t from, size_t to )
+  {
+    _positionX[to] = _positionX[from];
+    _positionY[to] = _positionY[from];
+    _previousX[to] = _previousX[from];
+    _previousY[to] = _previousY[from];
+    _velocityX[to] = _velocityX[from];
+    _velocityY[to] = _velocityY[from];
+    _forceX[to] = _forceX[from];
+    _forceY[to] = _forceY[from];
+    _inverseMass[to] = _inverseMass[from];
+    _rotation[to] = _rotation[from];
+    _angularVel[to] = _angularVel[from];
+    _torque[to] = _torque[from];
+    _inverseInertiaDensity[to] = _inverseInertiaDensity[from];
+    _translateMask[to] = _translateMask[from];
+    _rotateMask[to] = _rotateMask[from];
+    _moveMask[to] = _moveMask[from];
+  }
+
+
+  void PhysicsStore::clearSlot( size_t slot )
+  {
+    _positionX[slot] = 0.0;
+    _positionY[slot] = 0.0;
+    _previousX[slot] = 0.0;
+    _previousY[slot] = 0.0;
+    _velocityX[slot] = 0.0;
+    _velocityY[slot] = 0.0;
+    _forceX[slot] = 0.0;
+    _forceY[slot] = 0.0;
+    _inverseMass[slot] = 0.0;
+    _rotation[slot] = 0.0;
+    _angularVel[slot] = 0.0;
+    _torque[slot] = 0.0;
+    _inverseInertiaDensity[slot] = 0.0;
+    _translateMask[slot] = 0.0;
+    _rotateMask[slot] = 0.0;
+    _moveMask[slot] = 0.0;
+  }
+
+
+  void PhysicsStore::attach( PhysicalObject* object )
+  {
+    if ( object->_physicsStore == this ) return;
+
+    // Take the object over from the store of another context
+    if ( object->_physicsStore != nullptr )
+    {
+      object->_physicsStore->detach( object );
+    }
+
+    size_t slot = _owners.size();
+    _owners.push_back( object );
+    reserveSlots( _owners.size() );
+
+    _positionX[slot] = object->_position.x();
+    _positionY[slot] = object->_position.y();
+    _previousX[slot] = object->_previousPosition.x();
+    _previousY[slot] = object->_previousPosition.y();
+    _velocityX[slot] = object->_velocity.x();
+    _velocityY[slot] = object->_velocity.y();
+    _forceX[slot] = object->_forces.x();
+    _forceY[slot] = object->_forces.y();
+    _rotation[slot] = object->_rotation;
+    _angularVel[slot] = object->_angularVel;
+    _torque[slot] = object->_torques;
+
+    object->_physicsStore = this;
+    object->_physicsSlot = slot;
+
+    updateSlot( slot );
+  }
+
+
+  void PhysicsStore::detach( PhysicalObject* object )
+  {
+    if ( object->_physicsStore != this ) return;
+
+    size_t slot = object->_physicsSlot;
+
+    object->_position.set( _positionX[slot], _positionY[slot] );
+    object->_previousPosition.set( _previousX[slot], _previousY[slot] );
+    object->_velocity.set( _velocityX[slot], _velocityY[slot] );
+    object->_forces.set( _forceX[slot], _forceY[slot] );
+    object->_rotation = _rotation[slot];
+    object->_angularVel = _angularVel[slot];
+    object->_torques = _torque[slot];
+
+    object->_physicsStore = nullptr;
+    object->_physicsSlot = 0;
+
+    // Fill the gap with the last slot to keep the arrays dense
+    size_t last = _owners.size() - 1;
+    if ( slot != last )
+    {
+      copySlot( last, slot );
+      _owners[slot] = _owners[last];
+      _owners[slot]->_physicsSlot = slot;
+    }
+
+    clearSlot( last );
+    _owners.pop_back();
+  }
+
+
+  void PhysicsStore::clear()
+  {
+    while ( ! _owners.empty() )
+    {
+      detach( _owners.back() );
+    }
+  }
+
+
+  void PhysicsStore::updateSlot( size_t slot )
+  {
+    const PhysicalObject* object = _owners[slot];
+    bool awake = ! object->_sleeping;
+
+    _inverseMass[slot] = object->_inverseMass;
+    _inverseInertiaDensity[slot] = object->_inverseInertiaDensity;
+
+    _translateMask[slot] = ( awake && object->_hasTranslatable ? 1.0 : 0.0 );
+    _rotateMask[slot] = ( awake && object->_hasRotatable ? 1.0 : 0.0 );
+    _moveMask[slot] = ( awake && ( object->_hasTranslatable || object->_hasRotatable ) ? 1.0 : 0.0 );
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Integration kernel.
+  // Each lane performs exactly the operations of PhysicalObject::step. The masks are either zero or one, so scaling the
+  // time step by them either reproduces the step or leaves the slot untouched.
+
+  void PhysicsStore::integrate( float time )
+  {
+    size_t padded = ( ( _owners.size() + REGOLITH_SIMD_WIDTH - 1 ) / REGOLITH_SIMD_WIDTH ) * REGOLITH_SIMD_WIDTH;
+
+#if defined REGOLITH_SIMD_AVX2
+
+    const __m256 step = _mm256_set1_ps( time );
+    const __m256 one = _mm256_set1_ps( 1.0 );
+
+    for ( size_t i = 0; i < padded; i += 8 )
+    {
+      __m256 move = _mm256_loadu_ps( &_moveMask[i] );
+      __m256 translate = _mm256_loadu_ps( &_translateMask[i] );
+      __m256 rotate = _mm256_loadu_ps( &_rotateMask[i] );
+      __m256 linear_step = _mm256_mul_ps( step, translate );
+      __m256 angular_step = _mm256_mul_ps( step, rotate );
+
+      // Position at the start of the step
+      __m256 position_x = _mm256_loadu_ps( &_positionX[i] );
+      __m256 position_y = _mm256_loadu_ps( &_positionY[i] );
+      __m256 keep = _mm256_sub_ps( one, move );
+      _mm256_storeu_ps( &_previousX[i], _mm256_add_ps( _mm256_mul_ps( move, position_x ), _mm256_mul_ps( keep, _mm256_loadu_ps( &_previousX[i] ) ) ) );
+      _mm256_storeu_ps( &_previousY[i], _mm256_add_ps( _mm256_mul_ps( move, position_y ), _mm256_mul_ps( keep, _mm256_loadu_ps( &_previousY[i] ) ) ) );
+
+      // Linear Euler step
+      __m256 inverse_mass = _mm256_loadu_ps( &_inverseMass[i] );
+      __m256 force_x = _mm256_loadu_ps( &_forceX[i] );
+      __m256 force_y = _mm256_loadu_ps( &_forceY[i] );
+      __m256 velocity_x = _mm256_add_ps( _mm256_loadu_ps( &_velocityX[i] ), _mm256_mul_ps( _mm256_mul_ps( inverse_mass, force_x ), linear_step ) );
+      __m256 velocity_y = _mm256_add_ps( _mm256_loadu_ps( &_velocityY[i] ), _mm256_mul_ps( _mm256_mul_ps( inverse_mass, force_y ), linear_step ) );
+
+      _mm256_storeu_ps( &_velocityX[i], velocity_x );
+      _mm256_storeu_ps( &_velocityY[i], velocity_y );
+      _mm256_storeu_ps( &_positionX[i], _mm256_add_ps( position_x, _mm256_mul_ps( velocity_x, linear_step ) ) );
+      _mm256_storeu_ps( &_positionY[i], _mm256_add_ps( position_y, _mm256_mul_ps( velocity_y, linear_step ) ) );
+
+      __m256 keep_forces = _mm256_sub_ps( one, translate );
+      _mm256_storeu_ps( &_forceX[i], _mm256_mul_ps( force_x, keep_forces ) );
+      _mm256_storeu_ps( &_forceY[i], _mm256_mul_ps( force_y, keep_forces ) );
+
+      // Angular Euler step
+      __m256 torque = _mm256_loadu_ps( &_torque[i] );
+      __m256 angular_vel = _mm256_add_ps( _mm256_loadu_ps( &_angularVel[i] ), _mm256_mul_ps( _mm256_mul_ps( _mm256_loadu_ps( &_inverseInertiaDensity[i] ), torque ), angular_step ) );
+
+      _mm256_storeu_ps( &_angularVel[i], angular_vel );
+      _mm256_storeu_ps( &_rotation[i], _mm256_add_ps( _mm256_loadu_ps( &_rotation[i] ), _mm256_mul_ps( angular_vel, angular_step ) ) );
+      _mm256_storeu_ps( &_torque[i], _mm256_mul_ps( torque, _mm256_sub_ps( one, rotate ) ) );
+    }
+
+#elif defined REGOLITH_SIMD_SSE2
+
+    const __m128 step = _mm_set1_ps( time );
+    const __m128 one = _mm_set1_ps( 1.0 );
+
+    for ( size_t i = 0; i < padded; i += 4 )
+    {
+      __m128 move = _mm_loadu_ps( &_moveMask[i] );
+      __m128 translate = _mm_loadu_ps( &_translateMask[i] );
+      __m128 rotate = _mm_loadu_ps( &_rotateMask[i] );
+      __m128 linear_step = _mm_mul_ps( step, translate );
+      __m128 angular_step = _mm_mul_ps( step, rotate );
+
+      // Position at the start of the step
+      __m128 position_x = _mm_loadu_ps( &_positionX[i] );
+      __m128 position_y = _mm_loadu_ps( &_positionY[i] );
+      __m128 keep = _mm_sub_ps( one, move );
+      _mm_storeu_ps( &_previousX[i], _mm_add_ps( _mm_mul_ps( move, position_x ), _mm_mul_ps( keep, _mm_loadu_ps( &_previousX[i] ) ) ) );
+      _mm_storeu_ps( &_previousY[i], _mm_add_ps( _mm_mul_ps( move, position_y ), _mm_mul_ps( keep, _mm_loadu_ps( &_previousY[i] ) ) ) );
+
+      // Linear Euler step
+      __m128 inverse_mass = _mm_loadu_ps( &_inverseMass[i] );
+      __m128 force_x = _mm_loadu_ps( &_forceX[i] );
+      __m128 force_y = _mm_loadu_ps( &_forceY[i] );
+      __m128 velocity_x = _mm_add_ps( _mm_loadu_ps( &_velocityX[i] ), _mm_mul_ps( _mm_mul_ps( inverse_mass, force_x ), linear_step ) );
+      __m128 velocity_y = _mm_add_ps( _mm_loadu_ps( &_velocityY[i] ), _mm_mul_ps( _mm_mul_ps( inverse_mass, force_y ), linear_step ) );
+
+      _mm_storeu_ps( &_velocityX[i], velocity_x );
+      _mm_storeu_ps( &_velocityY[i], velocity_y );
+      _mm_storeu_ps( &_positionX[i], _mm_add_ps( position_x, _mm_mul_ps( velocity_x, linear_step ) ) );
+      _mm_storeu_ps( &_positionY[i], _mm_add_ps( position_y, _mm_mul_ps( velocity_y, linear_step ) ) );
+
+      __m128 keep_forces = _mm_sub_ps( one, translate );
+      _mm_storeu_ps( &_forceX[i], _mm_mul_ps( force_x, keep_forces ) );
+      _mm_storeu_ps( &_forceY[i], _mm_mul_ps( force_y, keep_forces ) );
+
+      // Angular Euler step
+      __m128 torque = _mm_loadu_ps( &_torque[i] );
+      __m128 angular_vel = _mm_add_ps( _mm_loadu_ps( &_angularVel[i] ), _mm_mul_ps( _mm_mul_ps( _mm_loadu_ps( &_inverseInertiaDensity[i] ), torque ), angular_step ) );
+
+      _mm_storeu_ps( &_angularVel[i], angular_vel );
+      _mm_storeu_ps( &_rotation[i], _mm_add_ps( _mm_loadu_ps( &_rotation[i] ), _mm_mul_ps( angular_vel, angular_step ) ) );
+      _mm_storeu_ps( &_torque[i], _mm_mul_ps( torque, _mm_sub_ps( one, rotate ) ) );
+    }
+
+#else
+
+    for ( size_t i = 0; i < padded; ++i )
+    {
+      float linear_step = time * _translateMask[i];
+      float angular_step = time * _rotateMask[i];
+
+      // Position at the start of the step
+      _previousX[i] = _moveMask[i] * _positionX[i] + ( 1.0f - _moveMask[i] ) * _previousX[i];
+      _previousY[i] = _moveMask[i] * _positionY[i] + ( 1.0f - _moveMask[i] ) * _previousY[i];
+
+      // Linear Euler step
+      _velocityX[i] += ( _inverseMass[i] * _forceX[i] ) * linear_step;
+      _velocityY[i] += ( _inverseMass[i] * _forceY[i] ) * linear_step;
+      _positionX[i] += _velocityX[i] * linear_step;
+      _positionY[i] += _velocityY[i] * linear_step;
+      _forceX[i] *= ( 1.0f - _translateMask[i] );
+      _forceY[i] *= ( 1.0f - _translateMask[i] );
+
+      // Angular Euler step
+      _angularVel[i] += ( _inverseInertiaDensity[i] * _torque[i] ) * angular_step;
+      _rotation[i] += _angularVel[i] * angular_step;
+      _torque[i] *= ( 1.0f - _rotateMask[i] );
+    }
+
+#endif
+  }
+
+
+  void PhysicsStore::step( size_t slot, float time )
+  {
+    float linear_step = time * _translateMask[slot];
+    float angular_step = time * _rotateMask[slot];
+
+    // Position at the start of the step
+    _previousX[slot] = _moveMask[slot] * _positionX[slot] + ( 1.0f - _moveMask[slot] ) * _previousX[slot];
+    _previousY[slot] = _moveMask[slot] * _positionY[slot] + ( 1.0f - _moveMask[slot] ) * _previousY[slot];
+
+    // Linear Euler step
+    _velocityX[slot] += ( _inverseMass[slot] * _forceX[slot] ) * linear_step;
+    _velocityY[slot] += ( _inverseMass[slot] * _forceY[slot] ) * linear_step;
+    _positionX[slot] += _velocityX[slot] * linear_step;
+    _positionY[slot] += _velocityY[slot] * linear_step;
+    _forceX[slot] *= ( 1.0f - _translateMask[slot] );
+    _forceY[slot] *= ( 1.0f - _translateMask[slot] );
+
+    // Angular Euler step
+    _angularVel[slot] += ( _inverseInertiaDensity[slot] * _torque[slot] ) * angular_step;
+    _rotation[slot] += _angularVel[slot] * angular_step;
+    _torque[slot] *= ( 1.0f - _rotateMask[slot] );
+  }
+
+}
+
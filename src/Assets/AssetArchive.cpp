@@ -0,0 +1,449 @@
+
+#include "Regolith/Assets/AssetArchive.h"
+#include "Regolith/Utilities/Compression.h"
+
+#include <fstream>
+#include <cstring>
+#include <cerrno>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
+
+namespace Regolith
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Helper functions
+
+  static uint64_t alignOffset( uint64_t offset )
+  {
+    return ( offset + archiveAlignment - 1 ) & ~( archiveAlignment - 1 );
+  }
+
+
+  // Map a whole file read-only. Returns nullptr and sets the error message on failure
+  static const unsigned char* mapFile( const std::string& filename, size_t& size, std::string& error )
+  {
+#ifdef _WIN32
+    HANDLE file = CreateFileA( filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+    if ( file == INVALID_HANDLE_VALUE )
+    {
+      error = "Could not open archive file";
+      return nullptr;
+    }
+
+    LARGE_INTEGER file_size;
+    if ( ! GetFileSizeEx( file, &file_size ) || (size_t)file_size.QuadPart < sizeof( ArchiveHeader ) )
+    {
+      CloseHandle( file );
+      error = "Archive file is too small";
+      return nullptr;
+    }
+    size = file_size.QuadPart;
+
+    // The view holds its own references to the file and the mapping
+    HANDLE mapping = CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    void* data = ( mapping == nullptr ) ? nullptr : MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+    if ( mapping != nullptr ) CloseHandle( mapping );
+    CloseHandle( file );
+
+    if ( data == nullptr )
+    {
+      error = "Could not map archive file";
+      return nullptr;
+    }
+#else
+    int file = ::open( filename.c_str(), O_RDONLY );
+    if ( file < 0 )
+    {
+      error = std::string( "Could not open archive file: " ) + std::strerror( errno );
+      return nullptr;
+    }
+
+    struct stat file_status;
+    if ( fstat( file, &file_status ) != 0 || (size_t)file_status.st_size < sizeof( ArchiveHeader ) )
+    {
+      ::close( file );
+      error = "Archive file is too small";
+      return nullptr;
+    }
+    size = file_status.st_size;
+
+    // The mapping holds its own reference to the file
+    void* data = mmap( nullptr, size, PROT_READ, MAP_PRIVATE, file, 0 );
+    ::close( file );
+
+    if ( data == MAP_FAILED )
+    {
+      error = std::string( "Could not map archive file: " ) + std::strerror( errno );
+      return nullptr;
+    }
+#endif
+
+    return (const unsigned char*) data;
+  }
+
+
+  static void unmapFile( const unsigned char* data, size_t size )
+  {
+#ifdef _WIN32
+    (void) size;
+    UnmapViewOfFile( data );
+#else
+    munmap( (void*)data, size );
+#endif
+  }
+
+
+  // Close function for decompressed entries. Frees the buffer along with the SDL_RWops
+  static int SDLCALL closeDecompressed( SDL_RWops* context )
+  {
+    if ( context != nullptr )
+    {
+      SDL_free( context->hidden.mem.base );
+      SDL_FreeRW( context );
+    }
+    return 0;
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Archive reader
+
+  AssetArchive::AssetArchive() :
+    _fileName(),
+    _data( nullptr ),
+    _size( 0 ),
+    _header( nullptr ),
+    _table( nullptr ),
+    _names( nullptr )
+  {
+  }
+
+
+  AssetArchive::~AssetArchive()
+  {
+    this->close();
+  }
+
+
+  uint64_t AssetArchive::hashName( const std::string& name )
+  {
+    // 64-bit FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for ( std::string::const_iterator it = name.begin(); it != name.end(); ++it )
+    {
+      hash ^= (unsigned char)(*it);
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+
+
+  void AssetArchive::open( std::string filename )
+  {
+    this->close();
+
+    std::string error;
+    size_t size = 0;
+    const unsigned char* data = mapFile( filename, size, error );
+    if ( data == nullptr )
+    {
+      Exception ex( "AssetArchive::open()", error );
+      ex.addDetail( "File name", filename );
+      throw ex;
+    }
+
+    _fileName = filename;
+    _data = data;
+    _size = size;
+    _header = (const ArchiveHeader*) _data;
+
+    // Validate everything up front so lookups never read outside the mapping
+    const char* problem = nullptr;
+    if ( std::memcmp( _header->magic, archiveMagic, sizeof( archiveMagic ) ) != 0 )
+    {
+      problem = "File is not an asset archive";
+    }
+    else if ( _header->version != archiveVersion )
+    {
+      problem = "Unsupported archive version";
+    }
+    else if ( _header->tableSize == 0 || ( _header->tableSize & ( _header->tableSize - 1 ) ) != 0 || _header->numberEntries > _header->tableSize )
+    {
+      problem = "Invalid hash table size";
+    }
+    else if ( _header->tableOffset > _size || ( _size - _header->tableOffset ) / sizeof( ArchiveEntry ) < _header->tableSize ||
+              _header->namesOffset > _size )
+    {
+      problem = "Archive is truncated";
+    }
+    else
+    {
+      _table = (const ArchiveEntry*)( _data + _header->tableOffset );
+      _names = (const char*)( _data + _header->namesOffset );
+      size_t names_size = _size - _header->namesOffset;
+
+      for ( uint32_t i = 0; i < _header->tableSize; ++i )
+      {
+        const ArchiveEntry& entry = _table[i];
+        if ( ! ( entry.flags & ARCHIVE_ENTRY_USED ) ) continue;
+
+        if ( entry.offset > _size || entry.size > _size - entry.offset ||
+             entry.nameOffset > names_size || entry.nameLength > names_size - entry.nameOffset )
+        {
+          problem = "Archive entry is out of bounds";
+          break;
+        }
+      }
+    }
+
+    if ( problem != nullptr )
+    {
+      this->close();
+      Exception ex( "AssetArchive::open()", problem );
+      ex.addDetail( "File name", filename );
+      throw ex;
+    }
+
+    INFO_STREAM << "AssetArchive::open : Mapped archive " << _fileName << ". " << _header->numberEntries << " entries, " << _size << " bytes";
+  }
+
+
+  void AssetArchive::close()
+  {
+    if ( _data == nullptr ) return;
+
+    unmapFile( _data, _size );
+    INFO_STREAM << "AssetArchive::close : Unmapped archive " << _fileName;
+
+    _fileName.clear();
+    _data = nullptr;
+    _size = 0;
+    _header = nullptr;
+    _table = nullptr;
+    _names = nullptr;
+  }
+
+
+  size_t AssetArchive::size() const
+  {
+    return ( _data == nullptr ) ? 0 : _header->numberEntries;
+  }
+
+
+  const ArchiveEntry* AssetArchive::find( const std::string& name ) const
+  {
+    if ( _table == nullptr ) return nullptr;
+
+    uint64_t hash = hashName( name );
+    uint32_t mask = _header->tableSize - 1;
+
+    for ( uint32_t i = 0; i < _header->tableSize; ++i )
+    {
+      const ArchiveEntry& entry = _table[ ( hash + i ) & mask ];
+
+      // An empty slot ends the probe sequence
+      if ( ! ( entry.flags & ARCHIVE_ENTRY_USED ) ) return nullptr;
+
+      if ( entry.hash == hash && entry.nameLength == name.size() && name.compare( 0, name.size(), _names + entry.nameOffset, entry.nameLength ) == 0 )
+      {
+        return &entry;
+      }
+    }
+
+    return nullptr;
+  }
+
+
+  bool AssetArchive::contains( const std::string& name ) const
+  {
+    return find( name ) != nullptr;
+  }
+
+
+  SDL_RWops* AssetArchive::openEntry( const std::string& name ) const
+  {
+    const ArchiveEntry* entry = find( name );
+    if ( entry == nullptr ) return nullptr;
+
+    const unsigned char* blob = _data + entry->offset;
+
+    if ( ! ( entry->flags & ARCHIVE_ENTRY_LZ4 ) )
+    {
+      return SDL_RWFromConstMem( blob, entry->size );
+    }
+
+    unsigned char* buffer = (unsigned char*) SDL_malloc( entry->rawSize );
+    if ( buffer == nullptr || ! decompressLZ4( blob, entry->size, buffer, entry->rawSize ) )
+    {
+      SDL_free( buffer );
+      Exception ex( "AssetArchive::openEntry()", "Could not decompress archive entry" );
+      ex.addDetail( "Archive", _fileName );
+      ex.addDetail( "Entry", name );
+      throw ex;
+    }
+
+    SDL_RWops* context = SDL_RWFromConstMem( buffer, entry->rawSize );
+    if ( context == nullptr )
+    {
+      SDL_free( buffer );
+      return nullptr;
+    }
+
+    context->close = closeDecompressed;
+    return context;
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Archive writer
+
+  AssetArchiveWriter::AssetArchiveWriter() :
+    _blobs()
+  {
+  }
+
+
+  bool AssetArchiveWriter::contains( std::string name ) const
+  {
+    return _blobs.find( name ) != _blobs.end();
+  }
+
+
+  void AssetArchiveWriter::addData( std::string name, const unsigned char* data, size_t size, bool compress )
+  {
+    if ( _blobs.find( name ) != _blobs.end() )
+    {
+      Exception ex( "AssetArchiveWriter::addData()", "Two entries provided with the same name. Duplicates are forbidden." );
+      ex.addDetail( "Entry", name );
+      throw ex;
+    }
+
+    Blob& blob = _blobs[ name ];
+    blob.rawSize = size;
+    blob.compressed = false;
+
+    if ( compress )
+    {
+      compressLZ4( data, size, blob.data );
+      blob.compressed = ( blob.data.size() < size );
+    }
+
+    if ( ! blob.compressed )
+    {
+      blob.data.assign( data, data + size );
+    }
+  }
+
+
+  void AssetArchiveWriter::addFile( std::string name, std::string path, bool compress )
+  {
+    std::ifstream input( path, std::ios::binary );
+    if ( ! input )
+    {
+      Exception ex( "AssetArchiveWriter::addFile()", "Could not open file" );
+      ex.addDetail( "Entry", name );
+      ex.addDetail( "Path", path );
+      throw ex;
+    }
+
+    std::vector< unsigned char > contents( ( std::istreambuf_iterator< char >( input ) ), std::istreambuf_iterator< char >() );
+    addData( name, contents.data(), contents.size(), compress );
+  }
+
+
+  void AssetArchiveWriter::write( std::string filename ) const
+  {
+    // Keep the table at most half full
+    uint32_t table_size = 1;
+    while ( table_size < 2 * _blobs.size() ) table_size <<= 1;
+
+    ArchiveHeader header;
+    std::memcpy( header.magic, archiveMagic, sizeof( archiveMagic ) );
+    header.version = archiveVersion;
+    header.numberEntries = _blobs.size();
+    header.tableSize = table_size;
+    header.tableOffset = alignOffset( sizeof( ArchiveHeader ) );
+    header.namesOffset = header.tableOffset + table_size * sizeof( ArchiveEntry );
+
+    std::vector< ArchiveEntry > table( table_size );
+    std::memset( table.data(), 0, table_size * sizeof( ArchiveEntry ) );
+
+    std::string names;
+    for ( BlobMap::const_iterator it = _blobs.begin(); it != _blobs.end(); ++it )
+    {
+      names += it->first;
+    }
+
+    uint64_t position = alignOffset( header.namesOffset + names.size() );
+    uint32_t name_offset = 0;
+
+    for ( BlobMap::const_iterator it = _blobs.begin(); it != _blobs.end(); ++it )
+    {
+      ArchiveEntry entry;
+      entry.hash = AssetArchive::hashName( it->first );
+      entry.offset = position;
+      entry.size = it->second.data.size();
+      entry.rawSize = it->second.rawSize;
+      entry.nameOffset = name_offset;
+      entry.nameLength = it->first.size();
+      entry.flags = it->second.compressed ? ( ARCHIVE_ENTRY_USED | ARCHIVE_ENTRY_LZ4 ) : ARCHIVE_ENTRY_USED;
+      entry.padding = 0;
+
+      uint32_t slot = entry.hash & ( table_size - 1 );
+      while ( table[ slot ].flags & ARCHIVE_ENTRY_USED )
+      {
+        slot = ( slot + 1 ) & ( table_size - 1 );
+      }
+      table[ slot ] = entry;
+
+      name_offset += entry.nameLength;
+      position = alignOffset( position + entry.size );
+    }
+
+
+    std::ofstream output( filename, std::ios::binary | std::ios::trunc );
+    if ( ! output )
+    {
+      Exception ex( "AssetArchiveWriter::write()", "Could not open archive file for writing" );
+      ex.addDetail( "File name", filename );
+      throw ex;
+    }
+
+    const char zeros[ archiveAlignment ] = { 0 };
+    uint64_t written = 0;
+
+    output.write( (const char*)&header, sizeof( ArchiveHeader ) );
+    output.write( zeros, header.tableOffset - sizeof( ArchiveHeader ) );
+    output.write( (const char*)table.data(), table_size * sizeof( ArchiveEntry ) );
+    output.write( names.data(), names.size() );
+    written = header.namesOffset + names.size();
+
+    for ( BlobMap::const_iterator it = _blobs.begin(); it != _blobs.end(); ++it )
+    {
+      uint64_t start = alignOffset( written );
+      output.write( zeros, start - written );
+      output.write( (const char*)it->second.data.data(), it->second.data.size() );
+      written = start + it->second.data.size();
+    }
+
+    if ( ! output )
+    {
+      Exception ex( "AssetArchiveWriter::write()", "Failed to write archive file" );
+      ex.addDetail( "File name", filename );
+      throw ex;
+    }
+
+    INFO_STREAM << "AssetArchiveWriter::write : Wrote " << _blobs.size() << " entries to " << filename << ", " << written << " bytes";
+  }
+
+}
+
@@ -0,0 +1,96 @@
+
+#include "Regolith/Assets/CookedImage.h"
+#include "Regolith/Utilities/Compression.h"
+
+#include <cstring>
+
+
+namespace Regolith
+{
+
+  SDL_Surface* loadCookedImage( SDL_RWops* file )
+  {
+    if ( file == nullptr ) return nullptr;
+
+    CookedImageHeader header;
+    if ( SDL_RWread( file, &header, sizeof( CookedImageHeader ), 1 ) != 1 ||
+         std::memcmp( header.magic, cookedImageMagic, sizeof( cookedImageMagic ) ) != 0 )
+    {
+      SDL_RWclose( file );
+      SDL_SetError( "Not a cooked image" );
+      return nullptr;
+    }
+
+    if ( header.version != cookedImageVersion || SDL_BYTESPERPIXEL( header.format ) != 4 ||
+         (uint64_t)header.width * header.height * 4 != header.rawSize )
+    {
+      SDL_RWclose( file );
+      SDL_SetError( "Unsupported cooked image. Version %u, format %u", header.version, header.format );
+      return nullptr;
+    }
+
+    std::vector< unsigned char > compressed( header.compressedSize );
+    size_t read = ( header.compressedSize > 0 ) ? SDL_RWread( file, compressed.data(), 1, header.compressedSize ) : 0;
+    SDL_RWclose( file );
+
+    if ( read != header.compressedSize )
+    {
+      SDL_SetError( "Cooked image is truncated" );
+      return nullptr;
+    }
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat( 0, header.width, header.height, 32, header.format );
+    if ( surface == nullptr ) return nullptr;
+
+    // 32-bit rows are never padded, so the pixels can be decompressed in one go
+    if ( ! decompressLZ4( compressed.data(), compressed.size(), (unsigned char*)surface->pixels, header.rawSize ) )
+    {
+      SDL_FreeSurface( surface );
+      SDL_SetError( "Cooked image data is corrupt" );
+      return nullptr;
+    }
+
+    return surface;
+  }
+
+
+  void cookImage( SDL_Surface* surface, std::vector< unsigned char >& output )
+  {
+    if ( surface->format->BytesPerPixel != 4 )
+    {
+      Exception ex( "cookImage()", "Only 32-bit surfaces can be cooked" );
+      ex.addDetail( "Bytes per pixel", (int)surface->format->BytesPerPixel );
+      throw ex;
+    }
+
+    // Remove any row padding
+    size_t row_size = surface->w * 4;
+    std::vector< unsigned char > pixels( row_size * surface->h );
+
+    if ( SDL_MUSTLOCK( surface ) ) SDL_LockSurface( surface );
+    for ( int row = 0; row < surface->h; ++row )
+    {
+      std::memcpy( pixels.data() + row * row_size, (const unsigned char*)surface->pixels + row * surface->pitch, row_size );
+    }
+    if ( SDL_MUSTLOCK( surface ) ) SDL_UnlockSurface( surface );
+
+    std::vector< unsigned char > compressed;
+    compressLZ4( pixels.data(), pixels.size(), compressed );
+
+    CookedImageHeader header;
+    std::memcpy( header.magic, cookedImageMagic, sizeof( cookedImageMagic ) );
+    header.version = cookedImageVersion;
+    header.width = surface->w;
+    header.height = surface->h;
+    header.format = surface->format->format;
+    header.rawSize = pixels.size();
+    header.compressedSize = compressed.size();
+    header.padding = 0;
+
+    output.resize( sizeof( CookedImageHeader ) );
+    std::memcpy( output.data(), &header, sizeof( CookedImageHeader ) );
+    output.insert( output.end(), compressed.begin(), compressed.end() );
+  }
+
+}
+
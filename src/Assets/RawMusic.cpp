@@ -5,11 +5,11 @@
 namespace Regolith
 {
 
-  RawMusic loadRawMusic( AudioDetail details )
+  RawMusic loadRawMusic( AudioDetail details, SDL_RWops* file )
   {
     RawMusic raw_music;
 
-    raw_music.music = Mix_LoadMUS( details.filename.c_str() );
+    raw_music.music = Mix_LoadMUS_RW( file, 1 );
     DEBUG_STREAM << "loadRawMusic : Loaded music data : " << details.filename << " @ " << raw_music.music;
 
     if ( raw_music.music == nullptr )
@@ -5,11 +5,11 @@
 namespace Regolith
 {
 
-  RawSound loadRawSound( AudioDetail details )
+  RawSound loadRawSound( AudioDetail details, SDL_RWops* file )
   {
     RawSound raw_sound;
 
-    raw_sound.sound = Mix_LoadWAV( details.filename.c_str() );
+    raw_sound.sound = Mix_LoadWAV_RW( file, 1 );
 
     if ( raw_sound.sound == nullptr )
     {
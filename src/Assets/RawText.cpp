@@ -5,23 +5,28 @@
 namespace Regolith
 {
 
-  RawText loadRawText( TextDetail details )
+  RawText loadRawText( TextDetail details, SDL_RWops* file )
   {
-    RawText raw_text;
-    raw_text.text = new std::string();
-
-    std::ifstream reader( details.filename );
-    std::stringstream buffer;
+    Sint64 file_size = ( file == nullptr ) ? -1 : SDL_RWsize( file );
+    if ( file_size < 0 )
+    {
+      if ( file != nullptr ) SDL_RWclose( file );
+      Exception ex( "loadRawText()", "Failed to load text file" );
+      ex.addDetail( "Path", details.filename );
+      ex.addDetail( "SDL Error", SDL_GetError() );
+      throw ex;
+    }
 
     // Load into the buffer
-    buffer << reader.rdbuf();
-    size_t size = buffer.str().size() - 1;
+    std::string buffer( file_size, '\0' );
+    size_t size = ( file_size > 0 ) ? SDL_RWread( file, &buffer[0], 1, file_size ) : 0;
+    SDL_RWclose( file );
 
-    // Reserve the right amount of space (skipping the last newline character)
-    raw_text.text->reserve( size );
+    // Skip the last newline character
+    if ( size > 0 ) size -= 1;
 
-    // Load
-    raw_text.text->assign( buffer.str(), 0, size );
+    RawText raw_text;
+    raw_text.text = new std::string( buffer, 0, size );
 
     return raw_text;
   }
@@ -1,5 +1,6 @@
 
 #include "Regolith/Assets/RawTexture.h"
+#include "Regolith/Assets/CookedImage.h"
 
 
 namespace Regolith
@@ -8,7 +9,7 @@ namespace Regolith
 ////////////////////////////////////////////////////////////////////////////////////////////////////
   // Raw Texture creation function
 
-  RawTexture loadRawTexture( ImageDetail details )
+  RawTexture loadRawTexture( ImageDetail details, SDL_RWops* file )
   {
     RawTexture raw_texture;
 
@@ -18,9 +19,27 @@ namespace Regolith
     raw_texture.rows = details.rows;
     raw_texture.columns = details.columns;
     raw_texture.cells = details.rows * details.columns;
+    raw_texture.x = details.x;
+    raw_texture.y = details.y;
+    raw_texture.atlas = nullptr;
 
-    // Load the image into a surface
-    raw_texture.surface = IMG_Load( details.filename.c_str() );
+    // Images packed into an atlas use the atlas's surface
+    if ( ! details.atlas.empty() )
+    {
+      if ( file != nullptr ) SDL_RWclose( file );
+      raw_texture.surface = nullptr;
+      return raw_texture;
+    }
+
+    // Load the image into a surface. Cooked images are already decoded
+    if ( details.cooked )
+    {
+      raw_texture.surface = loadCookedImage( file );
+    }
+    else
+    {
+      raw_texture.surface = IMG_Load_RW( file, 1 );
+    }
     DEBUG_STREAM << "loadRawTexture : Loaded @ " << raw_texture.surface;
     if ( raw_texture.surface == nullptr )
     {
@@ -0,0 +1,31 @@
+
+#include "Regolith/Collisions/BroadPhase.h"
+#include "Regolith/ObjectInterfaces/CollidableObject.h"
+
+#include <algorithm>
+
+
+namespace Regolith
+{
+
+  void BroadPhase::calculateBounds( CollidableObject* object, Vector& lower, Vector& upper )
+  {
+    // No-op unless the object moved since the last update
+    object->updateWorldHitBoxes();
+
+    const Vector* points = object->worldBoundingPoints();
+
+    lower = points[0];
+    upper = points[0];
+
+    for ( unsigned int i = 1; i < 4; ++i )
+    {
+      lower.x() = std::min( lower.x(), points[i].x() );
+      lower.y() = std::min( lower.y(), points[i].y() );
+      upper.x() = std::max( upper.x(), points[i].x() );
+      upper.y() = std::max( upper.y(), points[i].y() );
+    }
+  }
+
+}
+
@@ -0,0 +1,127 @@
+
+#include "Regolith/Collisions/Collision.h"
+
+#include <limits>
+#include <algorithm>
+
+#if defined REGOLITH_SIMD_AVX2
+#include <immintrin.h>
+#elif defined REGOLITH_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+
+namespace Regolith
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Structure-of-arrays hitbox
+
+  void HitBoxSoA::set( const HitBox& box )
+  {
+    number = box.number;
+
+    size_t padded = ( ( number + REGOLITH_SIMD_WIDTH - 1 ) / REGOLITH_SIMD_WIDTH ) * REGOLITH_SIMD_WIDTH;
+    x.resize( padded );
+    y.resize( padded );
+
+    for ( unsigned int i = 0; i < number; ++i )
+    {
+      x[i] = box.points[i].x();
+      y[i] = box.points[i].y();
+    }
+
+    for ( size_t i = number; i < padded; ++i )
+    {
+      x[i] = x[number-1];
+      y[i] = y[number-1];
+    }
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Projection kernels
+
+  void projectHitBoxScalar( const HitBoxSoA& box, const Vector& axis, float& min, float& max )
+  {
+    min = std::numeric_limits<float>::max();
+    max = std::numeric_limits<float>::lowest();
+
+    for ( unsigned int i = 0; i < box.number; ++i )
+    {
+      float projection = box.x[i]*axis.x() + box.y[i]*axis.y();
+      min = std::min( min, projection );
+      max = std::max( max, projection );
+    }
+  }
+
+
+#if defined REGOLITH_SIMD_AVX2
+
+  void projectHitBox( const HitBoxSoA& box, const Vector& axis, float& min, float& max )
+  {
+    const __m256 axis_x = _mm256_set1_ps( axis.x() );
+    const __m256 axis_y = _mm256_set1_ps( axis.y() );
+
+    __m256 lower = _mm256_set1_ps( std::numeric_limits<float>::max() );
+    __m256 upper = _mm256_set1_ps( std::numeric_limits<float>::lowest() );
+
+    const size_t padded = box.x.size();
+    for ( size_t i = 0; i < padded; i += 8 )
+    {
+      __m256 projection = _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( &box.x[i] ), axis_x ), _mm256_mul_ps( _mm256_loadu_ps( &box.y[i] ), axis_y ) );
+      lower = _mm256_min_ps( lower, projection );
+      upper = _mm256_max_ps( upper, projection );
+    }
+
+    // Horizontal reduction. Fold the 128-bit halves together, then within the half.
+    __m128 lower_4 = _mm_min_ps( _mm256_castps256_ps128( lower ), _mm256_extractf128_ps( lower, 1 ) );
+    __m128 upper_4 = _mm_max_ps( _mm256_castps256_ps128( upper ), _mm256_extractf128_ps( upper, 1 ) );
+    lower_4 = _mm_min_ps( lower_4, _mm_movehl_ps( lower_4, lower_4 ) );
+    upper_4 = _mm_max_ps( upper_4, _mm_movehl_ps( upper_4, upper_4 ) );
+    lower_4 = _mm_min_ss( lower_4, _mm_shuffle_ps( lower_4, lower_4, 0x55 ) );
+    upper_4 = _mm_max_ss( upper_4, _mm_shuffle_ps( upper_4, upper_4, 0x55 ) );
+
+    min = _mm_cvtss_f32( lower_4 );
+    max = _mm_cvtss_f32( upper_4 );
+  }
+
+#elif defined REGOLITH_SIMD_SSE2
+
+  void projectHitBox( const HitBoxSoA& box, const Vector& axis, float& min, float& max )
+  {
+    const __m128 axis_x = _mm_set1_ps( axis.x() );
+    const __m128 axis_y = _mm_set1_ps( axis.y() );
+
+    __m128 lower = _mm_set1_ps( std::numeric_limits<float>::max() );
+    __m128 upper = _mm_set1_ps( std::numeric_limits<float>::lowest() );
+
+    const size_t padded = box.x.size();
+    for ( size_t i = 0; i < padded; i += 4 )
+    {
+      __m128 projection = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( &box.x[i] ), axis_x ), _mm_mul_ps( _mm_loadu_ps( &box.y[i] ), axis_y ) );
+      lower = _mm_min_ps( lower, projection );
+      upper = _mm_max_ps( upper, projection );
+    }
+
+    // Horizontal reduction
+    lower = _mm_min_ps( lower, _mm_movehl_ps( lower, lower ) );
+    upper = _mm_max_ps( upper, _mm_movehl_ps( upper, upper ) );
+    lower = _mm_min_ss( lower, _mm_shuffle_ps( lower, lower, 0x55 ) );
+    upper = _mm_max_ss( upper, _mm_shuffle_ps( upper, upper, 0x55 ) );
+
+    min = _mm_cvtss_f32( lower );
+    max = _mm_cvtss_f32( upper );
+  }
+
+#else
+
+  void projectHitBox( const HitBoxSoA& box, const Vector& axis, float& min, float& max )
+  {
+    projectHitBoxScalar( box, axis, min, max );
+  }
+
+#endif
+
+}
+
@@ -0,0 +1,129 @@
+
+#include "Regolith/Collisions/ContactCache.h"
+
+
+namespace Regolith
+{
+
+  bool ContactCache::Key::operator<( const Key& other ) const
+  {
+    if ( object1 != other.object1 ) return object1 < other.object1;
+    if ( object2 != other.object2 ) return object2 < other.object2;
+    if ( hitBox1 != other.hitBox1 ) return hitBox1 < other.hitBox1;
+    return hitBox2 < other.hitBox2;
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  ContactCache::ContactCache() :
+    _manifolds(),
+    _frame( 0 ),
+    _mergeDistance( 2.0 )
+  {
+  }
+
+
+  ContactCache::~ContactCache()
+  {
+  }
+
+
+  void ContactCache::startFrame()
+  {
+    ManifoldMap::iterator it = _manifolds.begin();
+    while ( it != _manifolds.end() )
+    {
+      ContactManifold& manifold = it->second;
+
+      // Keep the refreshed points at the front
+      unsigned int count = 0;
+      for ( unsigned int i = 0; i < manifold.number; ++i )
+      {
+        if ( manifold.points[i].frame == _frame )
+        {
+          manifold.points[count] = manifold.points[i];
+          ++count;
+        }
+      }
+      manifold.number = count;
+
+      if ( count == 0 )
+      {
+        it = _manifolds.erase( it );
+      }
+      else
+      {
+        ++it;
+      }
+    }
+
+    ++_frame;
+  }
+
+
+  ContactPoint& ContactCache::findPoint( const ContactPair& pair )
+  {
+    Key key = { pair.object1, pair.object2, pair.hitBox1, pair.hitBox2 };
+
+    ManifoldMap::iterator found = _manifolds.find( key );
+    if ( found == _manifolds.end() )
+    {
+      ContactManifold manifold;
+      manifold.number = 0;
+      found = _manifolds.insert( std::make_pair( key, manifold ) ).first;
+    }
+
+    ContactManifold& manifold = found->second;
+    float merge_square = _mergeDistance * _mergeDistance;
+
+    // Merge with the closest existing point that hasn't already been claimed this frame
+    ContactPoint* closest = nullptr;
+    float closest_square = merge_square;
+    for ( unsigned int i = 0; i < manifold.number; ++i )
+    {
+      ContactPoint& point = manifold.points[i];
+      if ( point.frame == _frame ) continue;
+
+      float distance_square = ( point.point - pair.contact1.point ).square();
+      if ( distance_square <= closest_square && point.normal * pair.contact1.normal > 0.0 )
+      {
+        closest = &point;
+        closest_square = distance_square;
+      }
+    }
+
+    if ( closest == nullptr )
+    {
+      // Replace the oldest point when the manifold is full
+      if ( manifold.number < max_manifold_points )
+      {
+        closest = &manifold.points[ manifold.number ];
+        ++manifold.number;
+      }
+      else
+      {
+        closest = &manifold.points[0];
+        for ( unsigned int i = 1; i < manifold.number; ++i )
+        {
+          if ( manifold.points[i].frame < closest->frame ) closest = &manifold.points[i];
+        }
+      }
+      closest->normalImpulse = 0.0;
+    }
+
+    closest->point = pair.contact1.point;
+    closest->normal = pair.contact1.normal;
+    closest->frame = _frame;
+
+    return *closest;
+  }
+
+
+  void ContactCache::clear()
+  {
+    _manifolds.clear();
+  }
+
+}
+
@@ -0,0 +1,318 @@
+
+#include "Regolith/Collisions/ContactSolver.h"
+#include "Regolith/Collisions/ContactCache.h"
+#include "Regolith/Utilities/JsonValidation.h"
+
+#include <algorithm>
+
+
+namespace Regolith
+{
+
+  ContactSolver::ContactSolver() :
+    _iterations( 8 ),
+    _positionCorrection( PositionCorrection::SplitImpulse ),
+    _baumgarte( 0.2 ),
+    _slop( 0.5 ),
+    _restitutionThreshold( 0.05 ),
+    _bodies(),
+    _constraints(),
+    _bodyMap()
+  {
+  }
+
+
+  ContactSolver::~ContactSolver()
+  {
+  }
+
+
+  void ContactSolver::configure( Json::Value& json_data )
+  {
+    if ( validateJson( json_data, "iterations", JsonType::INTEGER, false ) )
+    {
+      _iterations = json_data["iterations"].asUInt();
+    }
+
+    if ( validateJson( json_data, "position_correction", JsonType::STRING, false ) )
+    {
+      std::string correction = json_data["position_correction"].asString();
+
+      if ( correction == "baumgarte" )
+      {
+        _positionCorrection = PositionCorrection::Baumgarte;
+      }
+      else if ( correction == "split_impulse" )
+      {
+        _positionCorrection = PositionCorrection::SplitImpulse;
+      }
+      else
+      {
+        Exception ex( "ContactSolver::configure()", "Unknown position correction method" );
+        ex.addDetail( "Method", correction );
+        throw ex;
+      }
+    }
+
+    // Objects are stepped before their contacts are solved so a Baumgarte bias is only integrated in the following
+    // frame. Large factors overshoot and the stack starts to bounce, so it needs a softer default than split impulse.
+    _baumgarte = ( _positionCorrection == PositionCorrection::Baumgarte ? 0.05 : 0.2 );
+
+    if ( validateJson( json_data, "baumgarte", JsonType::FLOAT, false ) )
+    {
+      _baumgarte = json_data["baumgarte"].asFloat();
+    }
+
+    if ( validateJson( json_data, "slop", JsonType::FLOAT, false ) )
+    {
+      _slop = json_data["slop"].asFloat();
+    }
+
+    if ( validateJson( json_data, "restitution_threshold", JsonType::FLOAT, false ) )
+    {
+      _restitutionThreshold = json_data["restitution_threshold"].asFloat();
+    }
+
+    INFO_STREAM << "ContactSolver::configure : Iterations = " << _iterations << ", " << ( _positionCorrection == PositionCorrection::Baumgarte ? "Baumgarte" : "Split Impulse" ) << " position correction";
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Solver bodies
+
+  unsigned int ContactSolver::findBody( CollidableObject* object )
+  {
+    BodyMap::iterator found = _bodyMap.find( object );
+    if ( found != _bodyMap.end() )
+    {
+      return found->second;
+    }
+
+    SolverBody body;
+    body.velocity = object->getVelocity();
+    body.angularVelocity = object->getAngularVelocity();
+    body.pseudoVelocity = zeroVector;
+    body.inverseMass = ( object->hasTranslation() ? object->getInverseMass() : 0.0 );
+    body.inverseInertia = ( object->hasRotation() ? object->getInverseInertia() : 0.0 );
+
+    unsigned int index = _bodies.size();
+    _bodies.push_back( body );
+    _bodyMap[ object ] = index;
+
+    return index;
+  }
+
+
+  float ContactSolver::relativeVelocity( const SolverContact& constraint ) const
+  {
+    const SolverBody& body1 = _bodies[ constraint.body1 ];
+    const SolverBody& body2 = _bodies[ constraint.body2 ];
+    const Vector& normal = constraint.pair->contact1.normal;
+
+    // Same convention as CollisionHandler::resolve. Negative when the objects are approaching.
+    return ( body2.velocity - body1.velocity ) * normal +
+           body1.angularVelocity * constraint.lever1 +
+           body2.angularVelocity * constraint.lever2;
+  }
+
+
+  float ContactSolver::relativePseudoVelocity( const SolverContact& constraint ) const
+  {
+    return ( _bodies[ constraint.body2 ].pseudoVelocity - _bodies[ constraint.body1 ].pseudoVelocity ) * constraint.pair->contact1.normal;
+  }
+
+
+  void ContactSolver::applyImpulse( const SolverContact& constraint, float impulse )
+  {
+    SolverBody& body1 = _bodies[ constraint.body1 ];
+    SolverBody& body2 = _bodies[ constraint.body2 ];
+    const Vector& normal = constraint.pair->contact1.normal;
+
+    body1.velocity += body1.inverseMass * impulse * normal;
+    body2.velocity -= body2.inverseMass * impulse * normal;
+
+    body1.angularVelocity -= body1.inverseInertia * impulse * constraint.lever1;
+    body2.angularVelocity -= body2.inverseInertia * impulse * constraint.lever2;
+  }
+
+
+  void ContactSolver::applyPseudoImpulse( const SolverContact& constraint, float impulse )
+  {
+    const Vector& normal = constraint.pair->contact1.normal;
+
+    _bodies[ constraint.body1 ].pseudoVelocity += _bodies[ constraint.body1 ].inverseMass * impulse * normal;
+    _bodies[ constraint.body2 ].pseudoVelocity -= _bodies[ constraint.body2 ].inverseMass * impulse * normal;
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Solver
+
+  void ContactSolver::solve( ContactBuffer& contacts, ContactCache* cache, float time )
+  {
+    _bodies.clear();
+    _constraints.clear();
+    _bodyMap.clear();
+
+    float inverse_time = ( time > epsilon ? 1.0 / time : 0.0 );
+
+////////////////////////////////////////////////////////////////////////////////
+    // Build the constraints
+
+    for ( ContactBuffer::iterator it = contacts.begin(); it != contacts.end(); ++it )
+    {
+      CollidableObject* object1 = it->object1;
+      CollidableObject* object2 = it->object2;
+
+      SolverContact constraint;
+      constraint.pair = &(*it);
+      constraint.body1 = findBody( object1 );
+      constraint.body2 = findBody( object2 );
+
+      const SolverBody& body1 = _bodies[ constraint.body1 ];
+      const SolverBody& body2 = _bodies[ constraint.body2 ];
+
+      constraint.lever1 = it->contact1.normal ^ ( it->contact1.point - object1->getPosition() );
+      constraint.lever2 = it->contact2.normal ^ ( it->contact2.point - object2->getPosition() );
+
+      float effective_mass = body1.inverseMass + body2.inverseMass +
+                             constraint.lever1*constraint.lever1*body1.inverseInertia +
+                             constraint.lever2*constraint.lever2*body2.inverseInertia;
+
+      // Neither object can respond. Nothing to solve.
+      constraint.inverseEffectiveMass = ( effective_mass > epsilon ? 1.0 / effective_mass : 0.0 );
+
+      // Bounce off the initial approach speed
+      float approach = relativeVelocity( constraint );
+      float restitution = 0.5 * ( object1->getElasticity() + object2->getElasticity() );
+      constraint.targetVelocity = ( approach < -_restitutionThreshold ? -restitution * approach : 0.0 );
+
+      // Speed required to remove the overlap, beyond the allowed slop
+      float penetration = std::max( - it->contact1.overlap - _slop, 0.0f );
+      constraint.correctionVelocity = _baumgarte * penetration * inverse_time;
+
+      // The warm start impulse was applied to the objects at the start of the frame
+      constraint.cached = ( cache != nullptr && constraint.inverseEffectiveMass > 0.0 ? &cache->findPoint( *it ) : nullptr );
+      constraint.initialImpulse = ( constraint.cached != nullptr ? constraint.cached->normalImpulse : 0.0 );
+      constraint.impulse = constraint.initialImpulse;
+      constraint.pseudoImpulse = 0.0;
+
+      _constraints.push_back( constraint );
+    }
+
+
+////////////////////////////////////////////////////////////////////////////////
+    // Velocity iterations
+
+    for ( unsigned int i = 0; i < _iterations; ++i )
+    {
+      for ( std::vector< SolverContact >::iterator it = _constraints.begin(); it != _constraints.end(); ++it )
+      {
+        if ( it->inverseEffectiveMass == 0.0 ) continue;
+
+        float correction = ( relativeVelocity( *it ) - it->targetVelocity ) * it->inverseEffectiveMass;
+
+        // Clamp the total so the contact can only push
+        float old_impulse = it->impulse;
+        it->impulse = std::min( old_impulse + correction, 0.0f );
+
+        applyImpulse( *it, it->impulse - old_impulse );
+      }
+    }
+
+
+////////////////////////////////////////////////////////////////////////////////
+    // Position correction iterations.
+    // Solved after the velocities and accumulated separately so that the correction is never stored in the cache.
+    // Warm starting with it would push resting objects apart again in the next frame.
+
+    if ( _positionCorrection == PositionCorrection::Baumgarte )
+    {
+      // Bias the real velocities until the objects separate at the correction speed
+      for ( unsigned int i = 0; i < _iterations; ++i )
+      {
+        for ( std::vector< SolverContact >::iterator it = _constraints.begin(); it != _constraints.end(); ++it )
+        {
+          if ( it->inverseEffectiveMass == 0.0 ) continue;
+
+          float correction = ( relativeVelocity( *it ) - std::max( it->targetVelocity, it->correctionVelocity ) ) * it->inverseEffectiveMass;
+
+          float old_impulse = it->pseudoImpulse;
+          it->pseudoImpulse = std::min( old_impulse + correction, 0.0f );
+
+          applyImpulse( *it, it->pseudoImpulse - old_impulse );
+        }
+      }
+    }
+    else
+    {
+      // Solve a separate set of velocities that only move the objects
+      for ( unsigned int i = 0; i < _iterations; ++i )
+      {
+        for ( std::vector< SolverContact >::iterator it = _constraints.begin(); it != _constraints.end(); ++it )
+        {
+          float linear_mass = _bodies[ it->body1 ].inverseMass + _bodies[ it->body2 ].inverseMass;
+          if ( linear_mass < epsilon ) continue;
+
+          float correction = ( relativePseudoVelocity( *it ) - it->correctionVelocity ) / linear_mass;
+
+          float old_impulse = it->pseudoImpulse;
+          it->pseudoImpulse = std::min( old_impulse + correction, 0.0f );
+
+          applyPseudoImpulse( *it, it->pseudoImpulse - old_impulse );
+        }
+      }
+    }
+
+
+////////////////////////////////////////////////////////////////////////////////
+    // Write the results into the contacts
+
+    for ( std::vector< SolverContact >::iterator it = _constraints.begin(); it != _constraints.end(); ++it )
+    {
+      ContactPair& pair = *it->pair;
+      const SolverBody& body1 = _bodies[ it->body1 ];
+      const SolverBody& body2 = _bodies[ it->body2 ];
+
+      if ( it->cached != nullptr )
+      {
+        it->cached->normalImpulse = it->impulse;
+      }
+
+      // Only the change is applied. The initial impulse was applied by the warm start.
+      float impulse = it->impulse - it->initialImpulse;
+
+      if ( _positionCorrection == PositionCorrection::Baumgarte )
+      {
+        impulse += it->pseudoImpulse;
+      }
+
+      float total_M = pair.object1->getInverseMass() + pair.object2->getInverseMass();
+      float total_L = pair.object1->getInverseInertia() + pair.object2->getInverseInertia();
+
+      pair.contact1.massRatio = ( total_M > epsilon ? pair.object1->getInverseMass() / total_M : 0.0 );
+      pair.contact2.massRatio = ( total_M > epsilon ? pair.object2->getInverseMass() / total_M : 0.0 );
+      pair.contact1.inertiaRatio = ( total_L > epsilon ? pair.object1->getInverseInertia() / total_L : 0.0 );
+      pair.contact2.inertiaRatio = ( total_L > epsilon ? pair.object2->getInverseInertia() / total_L : 0.0 );
+
+      pair.contact1.impulse = body1.inverseMass * impulse * pair.contact1.normal;
+      pair.contact2.impulse = body2.inverseMass * impulse * pair.contact2.normal;
+      pair.contact1.angularImpulse = - body1.inverseInertia * impulse * it->lever1;
+      pair.contact2.angularImpulse = - body2.inverseInertia * impulse * it->lever2;
+
+      // Objects move themselves by massRatio * overlap along the normal. Choose the overlap so that this is the
+      // displacement given by the pseudo-impulse. With Baumgarte stabilisation the velocity does the work instead.
+      float overlap = 0.0;
+      if ( _positionCorrection == PositionCorrection::SplitImpulse )
+      {
+        overlap = it->pseudoImpulse * time * total_M;
+      }
+      pair.contact1.overlap = overlap;
+      pair.contact2.overlap = overlap;
+    }
+
+    DEBUG_STREAM << "ContactSolver::solve : Solved " << _constraints.size() << " contacts between " << _bodies.size() << " objects";
+  }
+
+}
+
@@ -0,0 +1,176 @@
+
+#include "Regolith/Collisions/ContinuousCollision.h"
+#include "Regolith/ObjectInterfaces/CollidableObject.h"
+
+#include <limits>
+#include <algorithm>
+
+
+namespace Regolith
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Local functions
+
+  // Narrow the interval of overlap times for a single axis. Returns false if the projections never overlap.
+  bool sweepAxis( const HitBox& moving_box, const HitBoxSoA& moving, const Vector& displacement, const HitBox& fixed_box, const HitBoxSoA& fixed, const Vector& axis, float& first, float& last )
+  {
+    float moving_min, moving_max;
+    float fixed_min, fixed_max;
+
+    projectHitBox( moving, axis, moving_min, moving_max );
+    projectHitBox( fixed, axis, fixed_min, fixed_max );
+
+    // Circles and capsules extend by their radius beyond their points
+    moving_min -= moving_box.radius;
+    moving_max += moving_box.radius;
+    fixed_min -= fixed_box.radius;
+    fixed_max += fixed_box.radius;
+
+    // Move the moving projection back to the start of the step
+    float speed = displacement * axis;
+    moving_min -= speed;
+    moving_max -= speed;
+
+    float enter;
+    float exit;
+
+    if ( moving_max < fixed_min )
+    {
+      if ( speed <= 0.0 ) return false;
+      enter = ( fixed_min - moving_max ) / speed;
+      exit = ( fixed_max - moving_min ) / speed;
+    }
+    else if ( fixed_max < moving_min )
+    {
+      if ( speed >= 0.0 ) return false;
+      enter = ( fixed_max - moving_min ) / speed;
+      exit = ( fixed_min - moving_max ) / speed;
+    }
+    else
+    {
+      // Overlapping at the start
+      enter = std::numeric_limits<float>::lowest();
+
+      if ( speed > 0.0 )
+        exit = ( fixed_max - moving_min ) / speed;
+      else if ( speed < 0.0 )
+        exit = ( fixed_min - moving_max ) / speed;
+      else
+        exit = std::numeric_limits<float>::max();
+    }
+
+    first = std::max( first, enter );
+    last = std::min( last, exit );
+
+    return first <= last;
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Swept tests
+
+  bool sweepHitBox( const HitBox& moving, const HitBoxSoA& moving_packed, const Vector& displacement, const HitBox& fixed, const HitBoxSoA& fixed_packed, float& time )
+  {
+    float first = std::numeric_limits<float>::lowest();
+    float last = std::numeric_limits<float>::max();
+
+    for ( unsigned int i = 0; i < moving.normals.size(); ++i )
+    {
+      if ( ! sweepAxis( moving, moving_packed, displacement, fixed, fixed_packed, moving.normals[i], first, last ) ) return false;
+    }
+
+    for ( unsigned int i = 0; i < fixed.normals.size(); ++i )
+    {
+      if ( ! sweepAxis( moving, moving_packed, displacement, fixed, fixed_packed, fixed.normals[i], first, last ) ) return false;
+    }
+
+    // Rounded hitboxes have too few normals to bound the sweep. Add the axes along and across the displacement, which
+    // gives a conservative (slightly early) time of impact.
+    if ( ( moving.shape != HitBoxType::Polygon || fixed.shape != HitBoxType::Polygon ) && displacement.square() > epsilon )
+    {
+      Vector along = displacement.norm();
+      Vector across( along.y(), -along.x() );
+
+      if ( ! sweepAxis( moving, moving_packed, displacement, fixed, fixed_packed, along, first, last ) ) return false;
+      if ( ! sweepAxis( moving, moving_packed, displacement, fixed, fixed_packed, across, first, last ) ) return false;
+    }
+
+    // Already overlapping at the start - leave it to the discrete tests. Or it doesn't reach the fixed hitbox.
+    if ( first < 0.0 || first > 1.0 ) return false;
+
+    time = first;
+    return true;
+  }
+
+
+  bool timeOfImpact( const CollidableObject* moving, const Vector& displacement, const CollidableObject* fixed, float& time )
+  {
+    // Swept bounding box test first
+    const Vector* moving_points = moving->worldBoundingPoints();
+    const Vector* fixed_points = fixed->worldBoundingPoints();
+
+    Vector moving_lower = moving_points[0];
+    Vector moving_upper = moving_points[0];
+    Vector fixed_lower = fixed_points[0];
+    Vector fixed_upper = fixed_points[0];
+
+    for ( unsigned int i = 1; i < 4; ++i )
+    {
+      moving_lower.x() = std::min( moving_lower.x(), moving_points[i].x() );
+      moving_lower.y() = std::min( moving_lower.y(), moving_points[i].y() );
+      moving_upper.x() = std::max( moving_upper.x(), moving_points[i].x() );
+      moving_upper.y() = std::max( moving_upper.y(), moving_points[i].y() );
+
+      fixed_lower.x() = std::min( fixed_lower.x(), fixed_points[i].x() );
+      fixed_lower.y() = std::min( fixed_lower.y(), fixed_points[i].y() );
+      fixed_upper.x() = std::max( fixed_upper.x(), fixed_points[i].x() );
+      fixed_upper.y() = std::max( fixed_upper.y(), fixed_points[i].y() );
+    }
+
+    // Extend back to the start of the step
+    moving_lower.x() = std::min( moving_lower.x(), moving_lower.x() - displacement.x() );
+    moving_lower.y() = std::min( moving_lower.y(), moving_lower.y() - displacement.y() );
+    moving_upper.x() = std::max( moving_upper.x(), moving_upper.x() - displacement.x() );
+    moving_upper.y() = std::max( moving_upper.y(), moving_upper.y() - displacement.y() );
+
+    if ( moving_upper.x() < fixed_lower.x() || fixed_upper.x() < moving_lower.x() ||
+         moving_upper.y() < fixed_lower.y() || fixed_upper.y() < moving_lower.y() )
+    {
+      return false;
+    }
+
+
+    const Collision::HitBoxVector& collision1 = moving->worldHitBoxes();
+    const Collision::HitBoxVector& collision2 = fixed->worldHitBoxes();
+    const std::vector< HitBoxSoA >& packed1 = moving->worldPackedHitBoxes();
+    const std::vector< HitBoxSoA >& packed2 = fixed->worldPackedHitBoxes();
+
+    // Only test the tiles of a tile map under the swept bounding box
+    std::vector< size_t > indices;
+    bool indexed = fixed->hasIndexedHitBoxes();
+    if ( indexed ) fixed->findWorldHitBoxes( moving_lower, moving_upper, indices );
+    size_t number = ( indexed ? indices.size() : collision2.size() );
+
+    bool found = false;
+    float hitbox_time;
+    time = std::numeric_limits<float>::max();
+
+    for ( size_t hb1 = 0; hb1 < collision1.size(); ++hb1 )
+    {
+      for ( size_t i2 = 0; i2 < number; ++i2 )
+      {
+        size_t hb2 = ( indexed ? indices[i2] : i2 );
+        if ( sweepHitBox( collision1[hb1], packed1[hb1], displacement, collision2[hb2], packed2[hb2], hitbox_time ) && hitbox_time < time )
+        {
+          time = hitbox_time;
+          found = true;
+        }
+      }
+    }
+
+    return found;
+  }
+
+}
+
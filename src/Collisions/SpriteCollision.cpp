@@ -59,6 +59,8 @@ namespace Regolith
             validateJsonArray( hitbox_data["points"], 2, JsonType::ARRAY );
 
             Json::Value& points = hitbox_data["points"];
+            hb.shape = HitBoxType::Polygon;
+            hb.radius = 0.0;
             hb.number = points.size();
             hb.points.reserve( hb.number );
             hb.normals.reserve( hb.number );
@@ -97,8 +99,57 @@ namespace Regolith
               }
             }
           }
+          else if ( validateJson( hitbox_data, "radius", JsonType::FLOAT, false ) )
+          {
+            hb.radius = hitbox_data["radius"].asFloat();
+            if ( hb.radius <= 0.0 )
+            {
+              Exception ex( "SpriteCollision::configure()", "Hitbox radius must be positive." );
+              ex.addDetail( "Radius", hb.radius );
+              throw ex;
+            }
+
+            if ( validateJson( hitbox_data, "start", JsonType::ARRAY, false ) )
+            {
+              // Capsule: a segment swept out by the radius
+              validateJson( hitbox_data, "end", JsonType::ARRAY );
+              validateJsonArray( hitbox_data["start"], 2, JsonType::FLOAT );
+              validateJsonArray( hitbox_data["end"], 2, JsonType::FLOAT );
+
+              hb.shape = HitBoxType::Capsule;
+              hb.number = 2;
+              hb.points.reserve( 2 );
+              hb.normals.reserve( 1 );
+
+              hb.points.push_back( Vector( hitbox_data["start"][0].asFloat(), hitbox_data["start"][1].asFloat() ) );
+              hb.points.push_back( Vector( hitbox_data["end"][0].asFloat(), hitbox_data["end"][1].asFloat() ) );
+
+              Vector delta = hb.points[1] - hb.points[0];
+              if ( delta.square() < epsilon )
+              {
+                Exception ex( "SpriteCollision::configure()", "Capsule start and end points must be different. Use a circle instead." );
+                throw ex;
+              }
+
+              // Either side of the segment is equivalent
+              hb.normals.push_back( Vector( delta.y(), -delta.x() ).norm() );
+            }
+            else
+            {
+              // Circle: a single point swept out by the radius
+              validateJson( hitbox_data, "center", JsonType::ARRAY );
+              validateJsonArray( hitbox_data["center"], 2, JsonType::FLOAT );
+
+              hb.shape = HitBoxType::Circle;
+              hb.number = 1;
+              hb.points.push_back( Vector( hitbox_data["center"][0].asFloat(), hitbox_data["center"][1].asFloat() ) );
+            }
+          }
           else // Default is an axis-align bounding box
           {
+            hb.shape = HitBoxType::Polygon;
+            hb.radius = 0.0;
+
             validateJson( hitbox_data, "position", JsonType::ARRAY );
             validateJsonArray( hitbox_data["position"], 2, JsonType::FLOAT );
             validateJson( hitbox_data, "width", JsonType::FLOAT );
@@ -134,8 +185,13 @@ namespace Regolith
           DEBUG_LOG( "SpriteCollision::configure : Hitbox configured" );
           for ( unsigned int i = 0; i < hb.number; ++i )
           {
-            DEBUG_STREAM << "SpriteCollision::configure :   Hitbox point : " << hb.points[i] << ", normal : " << hb.normals[i];
+            DEBUG_STREAM << "SpriteCollision::configure :   Hitbox point : " << hb.points[i];
+          }
+          for ( unsigned int i = 0; i < hb.normals.size(); ++i )
+          {
+            DEBUG_STREAM << "SpriteCollision::configure :   Hitbox normal : " << hb.normals[i];
           }
+          DEBUG_STREAM << "SpriteCollision::configure :   Hitbox radius : " << hb.radius;
         }
       }
 
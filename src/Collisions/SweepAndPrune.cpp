@@ -0,0 +1,195 @@
+
+#include "Regolith/Collisions/SweepAndPrune.h"
+#include "Regolith/ObjectInterfaces/CollidableObject.h"
+#include "Regolith/Handlers/CollisionHandler.h"
+
+
+namespace Regolith
+{
+
+  SweepAndPrune::SweepAndPrune() :
+    BroadPhase(),
+    _sweepX( true ),
+    _proxies(),
+    _present(),
+    _proxyMap(),
+    _endPoints(),
+    _active()
+  {
+  }
+
+
+  SweepAndPrune::~SweepAndPrune()
+  {
+  }
+
+
+  void SweepAndPrune::configure( const BoundingBox& box )
+  {
+    _sweepX = ( box.width >= box.height );
+
+    _proxies.clear();
+    _present.clear();
+    _proxyMap.clear();
+    _endPoints.clear();
+    _active.clear();
+
+    DEBUG_STREAM << "SweepAndPrune::configure : Sweeping along the " << ( _sweepX ? "x" : "y" ) << "-axis";
+  }
+
+
+  void SweepAndPrune::startUpdate()
+  {
+    for ( std::vector< bool >::iterator it = _present.begin(); it != _present.end(); ++it )
+    {
+      (*it) = false;
+    }
+  }
+
+
+  void SweepAndPrune::insert( CollidableObject* object )
+  {
+    ProxyMap::iterator found = _proxyMap.find( object );
+
+    if ( found != _proxyMap.end() )
+    {
+      Proxy& proxy = _proxies[ found->second ];
+      proxy.team = object->getCollisionTeam();
+      calculateBounds( object, proxy.lower, proxy.upper );
+      _present[ found->second ] = true;
+    }
+    else
+    {
+      unsigned int index = _proxies.size();
+
+      Proxy proxy = { object, object->getCollisionTeam(), Vector(), Vector() };
+      calculateBounds( object, proxy.lower, proxy.upper );
+
+      _proxies.push_back( proxy );
+      _present.push_back( true );
+      _proxyMap[ object ] = index;
+
+      // Values are filled in before sorting
+      _endPoints.push_back( { 0.0, index, true } );
+      _endPoints.push_back( { 0.0, index, false } );
+    }
+  }
+
+
+  void SweepAndPrune::removeAbsent()
+  {
+    unsigned int number = _proxies.size();
+    std::vector< unsigned int > new_index( number, number );
+
+    unsigned int count = 0;
+    for ( unsigned int i = 0; i < number; ++i )
+    {
+      if ( _present[i] )
+      {
+        new_index[i] = count;
+        _proxies[count] = _proxies[i];
+        _present[count] = true;
+        _proxyMap[ _proxies[count].object ] = count;
+        ++count;
+      }
+      else
+      {
+        _proxyMap.erase( _proxies[i].object );
+      }
+    }
+
+    if ( count == number ) return;
+
+    DEBUG_STREAM << "SweepAndPrune::removeAbsent : Removing " << ( number - count ) << " proxies";
+
+    _proxies.resize( count );
+    _present.resize( count );
+
+    // Stable compaction keeps the endpoints sorted
+    EndPointVector::iterator end = _endPoints.begin();
+    for ( EndPointVector::iterator it = _endPoints.begin(); it != _endPoints.end(); ++it )
+    {
+      if ( new_index[ it->proxy ] != number )
+      {
+        (*end) = (*it);
+        end->proxy = new_index[ it->proxy ];
+        ++end;
+      }
+    }
+    _endPoints.erase( end, _endPoints.end() );
+  }
+
+
+  void SweepAndPrune::sortEndPoints()
+  {
+    for ( EndPointVector::iterator it = _endPoints.begin(); it != _endPoints.end(); ++it )
+    {
+      const Proxy& proxy = _proxies[ it->proxy ];
+      if ( _sweepX )
+      {
+        it->value = ( it->isLower ? proxy.lower.x() : proxy.upper.x() );
+      }
+      else
+      {
+        it->value = ( it->isLower ? proxy.lower.y() : proxy.upper.y() );
+      }
+    }
+
+    // Insertion sort. Lower endpoints go first when the values are equal so that touching intervals overlap.
+    for ( size_t i = 1; i < _endPoints.size(); ++i )
+    {
+      EndPoint key = _endPoints[i];
+      size_t j = i;
+
+      while ( j > 0 && ( key.value < _endPoints[j-1].value || ( key.value == _endPoints[j-1].value && key.isLower && ! _endPoints[j-1].isLower ) ) )
+      {
+        _endPoints[j] = _endPoints[j-1];
+        --j;
+      }
+      _endPoints[j] = key;
+    }
+  }
+
+
+  void SweepAndPrune::findPairs( const CollisionHandler& handler, PairList& pairs )
+  {
+    removeAbsent();
+    sortEndPoints();
+
+    _active.clear();
+
+    for ( EndPointVector::const_iterator it = _endPoints.begin(); it != _endPoints.end(); ++it )
+    {
+      if ( it->isLower )
+      {
+        const Proxy& proxy1 = _proxies[ it->proxy ];
+
+        for ( std::vector< unsigned int >::const_iterator active_it = _active.begin(); active_it != _active.end(); ++active_it )
+        {
+          const Proxy& proxy2 = _proxies[ *active_it ];
+
+          if ( overlaps( proxy1, proxy2 ) && handler.canCollide( proxy1.team, proxy2.team ) )
+          {
+            pairs.push_back( std::make_pair( proxy2.object, proxy1.object ) );
+          }
+        }
+
+        _active.push_back( it->proxy );
+      }
+      else
+      {
+        for ( std::vector< unsigned int >::iterator active_it = _active.begin(); active_it != _active.end(); ++active_it )
+        {
+          if ( (*active_it) == it->proxy )
+          {
+            (*active_it) = _active.back();
+            _active.pop_back();
+            break;
+          }
+        }
+      }
+    }
+  }
+
+}
+
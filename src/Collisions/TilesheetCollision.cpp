@@ -4,12 +4,30 @@
 #include "Regolith/Utilities/TileSet.h"
 #include "Regolith/Utilities/JsonValidation.h"
 
+#include <algorithm>
+#include <cmath>
+
 
 namespace Regolith
 {
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Local function declarations
+
+  // Build an axis-aligned rectangular hitbox from its corner and size
+  HitBox buildBoxHitBox( float, float, float, float, CollisionType );
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // TilesheetCollision class member functions
 
   TilesheetCollision::TilesheetCollision() :
-    _hitboxes()
+    _hitboxes(),
+    _grid(),
+    _numRows( 0 ),
+    _numCols( 0 ),
+    _tileWidth( 0.0 ),
+    _tileHeight( 0.0 ),
+    _merged( false )
   {
   }
 
@@ -26,6 +44,23 @@ namespace Regolith
     // Collision type for the hitboxes
     CollisionType collision_type = Manager::getInstance()->getCollisionType( json_data["collision_type"].asString() );
 
+    // Shape of each solid tile
+    HitBoxType tile_shape = HitBoxType::Polygon;
+    if ( validateJson( json_data, "tile_shape", JsonType::STRING, false ) )
+    {
+      std::string shape = json_data["tile_shape"].asString();
+      if ( shape == "circle" )
+      {
+        tile_shape = HitBoxType::Circle;
+      }
+      else if ( shape != "box" )
+      {
+        Exception ex( "TilesheetCollision::configure()", "Unknown tile shape. Expected \"box\" or \"circle\"" );
+        ex.addDetail( "Shape", shape );
+        throw ex;
+      }
+    }
+
     // Build the hitboxes
     size_t num_rows = the_tiles.getNumberRows();
     size_t num_cols = the_tiles.getNumberColumns();
@@ -34,6 +69,14 @@ namespace Regolith
     float width = the_tiles.getTileWidth();
     float height = the_tiles.getTileHeight();
 
+    // Keep the grid so the hitboxes can be found by position
+    _numRows = num_rows;
+    _numCols = num_cols;
+    _tileWidth = width;
+    _tileHeight = height;
+    _hitboxes.clear();
+    _grid.assign( num_rows*num_cols, -1 );
+
 
     for ( size_t row = 0; row < num_rows; ++row )
     {
@@ -42,29 +85,165 @@ namespace Regolith
         if ( the_tiles( row, col ) > 0 )
         {
           HitBox hb;
-
           hb.collisionType = collision_type;
-          hb.number = 4;
-          hb.points.reserve( 4 );
-          hb.normals.reserve( 4 );
 
-          hb.points.push_back( Vector( col*width, row*height ) );
-          hb.points.push_back( Vector( (col+1)*width, row*height ) );
-          hb.points.push_back( Vector( (col+1)*width, (row+1)*height ) );
-          hb.points.push_back( Vector( col*width, (row+1)*height ) );
+          if ( tile_shape == HitBoxType::Circle )
+          {
+            // Largest circle that fits inside the tile
+            hb.shape = HitBoxType::Circle;
+            hb.radius = 0.5*std::min( width, height );
+            hb.number = 1;
+            hb.points.push_back( Vector( (col+0.5)*width, (row+0.5)*height ) );
 
-          hb.normals.push_back( -unitVector_y );
-          hb.normals.push_back(  unitVector_x );
-          hb.normals.push_back(  unitVector_y );
-          hb.normals.push_back( -unitVector_x );
+            DEBUG_STREAM << "TilesheetCollision::configure : Added circular HitBox: " << hb.points[0] << ", radius " << hb.radius;
+          }
+          else
+          {
+            hb = buildBoxHitBox( col*width, row*height, width, height, collision_type );
 
-          _hitboxes.push_back( hb );
+            DEBUG_STREAM << "TilesheetCollision::configure : Added HitBox: " << Vector( col*width, row*height ) << ", " << Vector( (col+1)*width, row*height ) << ", " << Vector( (col+1)*width, (row+1)*height ) << ", " <<  Vector( col*width, (row+1)*height );
+          }
 
-          DEBUG_STREAM << "TilesheetCollision::configure : Added HitBox: " << Vector( col*width, row*height ) << ", " << Vector( (col+1)*width, row*height ) << ", " << Vector( (col+1)*width, (row+1)*height ) << ", " <<  Vector( col*width, (row+1)*height );
+          _grid[ row*num_cols + col ] = _hitboxes.size();
+          _hitboxes.push_back( hb );
         } 
       }
     }
 
+    // Join neighbouring tiles if requested. Circles can't be joined.
+    _merged = false;
+    bool optimize = the_tiles.getOptimize();
+    if ( validateJson( json_data, "optimize_hitboxes", JsonType::BOOLEAN, false ) )
+    {
+      optimize = json_data["optimize_hitboxes"].asBool();
+    }
+
+    if ( optimize && tile_shape == HitBoxType::Polygon )
+    {
+      size_t number_tiles = _hitboxes.size();
+      this->mergeTiles( collision_type );
+      INFO_STREAM << "TilesheetCollision::configure : Merged " << number_tiles << " tile hitboxes into " << _hitboxes.size();
+    }
+    else
+    {
+      INFO_STREAM << "TilesheetCollision::configure : Built " << _hitboxes.size() << " tile hitboxes";
+    }
+  }
+
+
+  void TilesheetCollision::mergeTiles( CollisionType collision_type )
+  {
+    // Solid tiles that have not yet been claimed by a rectangle
+    std::vector< bool > available( _grid.size() );
+    for ( size_t i = 0; i < _grid.size(); ++i )
+    {
+      available[i] = ( _grid[i] >= 0 );
+    }
+
+    _hitboxes.clear();
+
+    // Greedy meshing. Grow each rectangle along the row as far as possible, then downwards while every tile in the
+    // next row is available. Every tile in the rectangle points at the merged hitbox.
+    for ( size_t row = 0; row < _numRows; ++row )
+    {
+      for ( size_t col = 0; col < _numCols; ++col )
+      {
+        if ( ! available[ row*_numCols + col ] ) continue;
+
+        size_t end_col = col + 1;
+        while ( end_col < _numCols && available[ row*_numCols + end_col ] ) ++end_col;
+
+        size_t end_row = row + 1;
+        while ( end_row < _numRows )
+        {
+          size_t c = col;
+          while ( c < end_col && available[ end_row*_numCols + c ] ) ++c;
+          if ( c != end_col ) break;
+          ++end_row;
+        }
+
+        int index = _hitboxes.size();
+        for ( size_t r = row; r < end_row; ++r )
+        {
+          for ( size_t c = col; c < end_col; ++c )
+          {
+            available[ r*_numCols + c ] = false;
+            _grid[ r*_numCols + c ] = index;
+          }
+        }
+
+        _hitboxes.push_back( buildBoxHitBox( col*_tileWidth, row*_tileHeight, (end_col-col)*_tileWidth, (end_row-row)*_tileHeight, collision_type ) );
+
+        DEBUG_STREAM << "TilesheetCollision::mergeTiles : Added HitBox: rows " << row << "-" << end_row-1 << ", columns " << col << "-" << end_col-1;
+      }
+    }
+
+    _merged = true;
+  }
+
+
+
+  void TilesheetCollision::findHitBoxes( const Vector& lower, const Vector& upper, std::vector< size_t >& indices ) const
+  {
+    // Entirely outside the grid
+    if ( _grid.empty() || upper.x() < 0.0 || upper.y() < 0.0 || lower.x() > _numCols*_tileWidth || lower.y() > _numRows*_tileHeight )
+    {
+      return;
+    }
+
+    // Tiles that only touch the region along an edge are included, as the hitbox tests count touching as colliding
+    size_t first_col = ( lower.x() > _tileWidth ) ? (size_t)std::ceil( lower.x() / _tileWidth ) - 1 : 0;
+    size_t first_row = ( lower.y() > _tileHeight ) ? (size_t)std::ceil( lower.y() / _tileHeight ) - 1 : 0;
+    size_t last_col = std::min( (size_t)( upper.x() / _tileWidth ), _numCols - 1 );
+    size_t last_row = std::min( (size_t)( upper.y() / _tileHeight ), _numRows - 1 );
+
+    size_t start = indices.size();
+
+    for ( size_t row = first_row; row <= last_row; ++row )
+    {
+      for ( size_t col = first_col; col <= last_col; ++col )
+      {
+        int cell = _grid[ row*_numCols + col ];
+        if ( cell >= 0 )
+        {
+          indices.push_back( cell );
+        }
+      }
+    }
+
+    // Merged hitboxes cover many tiles
+    if ( _merged )
+    {
+      std::sort( indices.begin() + start, indices.end() );
+      indices.erase( std::unique( indices.begin() + start, indices.end() ), indices.end() );
+    }
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Local functions
+
+  HitBox buildBoxHitBox( float x, float y, float width, float height, CollisionType collision_type )
+  {
+    HitBox hb;
+    hb.collisionType = collision_type;
+    hb.shape = HitBoxType::Polygon;
+    hb.radius = 0.0;
+    hb.number = 4;
+    hb.points.reserve( 4 );
+    hb.normals.reserve( 4 );
+
+    hb.points.push_back( Vector( x, y ) );
+    hb.points.push_back( Vector( x + width, y ) );
+    hb.points.push_back( Vector( x + width, y + height ) );
+    hb.points.push_back( Vector( x, y + height ) );
+
+    hb.normals.push_back( -unitVector_y );
+    hb.normals.push_back(  unitVector_x );
+    hb.normals.push_back(  unitVector_y );
+    hb.normals.push_back( -unitVector_x );
+
+    return hb;
   }
 
 
@@ -0,0 +1,143 @@
+
+#include "Regolith/Collisions/UniformGrid.h"
+#include "Regolith/ObjectInterfaces/CollidableObject.h"
+#include "Regolith/Handlers/CollisionHandler.h"
+
+#include <cmath>
+#include <algorithm>
+
+
+namespace Regolith
+{
+
+  UniformGrid::UniformGrid() :
+    BroadPhase(),
+    _origin( 0.0 ),
+    _cellSize( 1.0 ),
+    _inverseCellSize( 1.0 ),
+    _columns( 1 ),
+    _rows( 1 ),
+    _proxies(),
+    _cells( 1 ),
+    _occupied()
+  {
+  }
+
+
+  UniformGrid::~UniformGrid()
+  {
+  }
+
+
+  void UniformGrid::configure( const BoundingBox& box, float cell_size )
+  {
+    if ( cell_size <= 0.0 )
+    {
+      Exception ex( "UniformGrid::configure()", "Cell size must be greater than zero" );
+      ex.addDetail( "Cell Size", cell_size );
+      throw ex;
+    }
+
+    _origin = box.points[0];
+    _cellSize = cell_size;
+    _inverseCellSize = 1.0 / cell_size;
+
+    _columns = std::max( 1, (int)std::ceil( box.width * _inverseCellSize ) );
+    _rows = std::max( 1, (int)std::ceil( box.height * _inverseCellSize ) );
+
+    _proxies.clear();
+    _occupied.clear();
+    _cells.clear();
+    _cells.resize( _columns * _rows );
+
+    DEBUG_STREAM << "UniformGrid::configure : Cell Size = " << _cellSize << ", Columns = " << _columns << ", Rows = " << _rows;
+  }
+
+
+  unsigned int UniformGrid::column( float x ) const
+  {
+    int c = std::floor( ( x - _origin.x() ) * _inverseCellSize );
+    return std::min( (int)_columns - 1, std::max( 0, c ) );
+  }
+
+
+  unsigned int UniformGrid::row( float y ) const
+  {
+    int r = std::floor( ( y - _origin.y() ) * _inverseCellSize );
+    return std::min( (int)_rows - 1, std::max( 0, r ) );
+  }
+
+
+  void UniformGrid::startUpdate()
+  {
+    for ( std::vector< unsigned int >::iterator it = _occupied.begin(); it != _occupied.end(); ++it )
+    {
+      _cells[ *it ].clear();
+    }
+    _occupied.clear();
+    _proxies.clear();
+  }
+
+
+  void UniformGrid::insert( CollidableObject* object )
+  {
+    Proxy proxy = { object, object->getCollisionTeam(), Vector(), Vector() };
+    calculateBounds( object, proxy.lower, proxy.upper );
+
+    unsigned int index = _proxies.size();
+    _proxies.push_back( proxy );
+
+    unsigned int c_start = column( proxy.lower.x() );
+    unsigned int c_end = column( proxy.upper.x() );
+    unsigned int r_start = row( proxy.lower.y() );
+    unsigned int r_end = row( proxy.upper.y() );
+
+    for ( unsigned int r = r_start; r <= r_end; ++r )
+    {
+      for ( unsigned int c = c_start; c <= c_end; ++c )
+      {
+        unsigned int cell_number = r*_columns + c;
+        Cell& cell = _cells[ cell_number ];
+
+        if ( cell.empty() )
+        {
+          _occupied.push_back( cell_number );
+        }
+        cell.push_back( index );
+      }
+    }
+  }
+
+
+  void UniformGrid::findPairs( const CollisionHandler& handler, PairList& pairs )
+  {
+    for ( std::vector< unsigned int >::const_iterator cell_it = _occupied.begin(); cell_it != _occupied.end(); ++cell_it )
+    {
+      const Cell& cell = _cells[ *cell_it ];
+      if ( cell.size() < 2 ) continue;
+
+      for ( Cell::const_iterator it1 = cell.begin(); it1 != cell.end(); ++it1 )
+      {
+        const Proxy& proxy1 = _proxies[ *it1 ];
+
+        for ( Cell::const_iterator it2 = it1 + 1; it2 != cell.end(); ++it2 )
+        {
+          const Proxy& proxy2 = _proxies[ *it2 ];
+
+          if ( ! overlaps( proxy1, proxy2 ) ) continue;
+
+          // Only report the pair from the cell containing the lower corner of the overlap
+          unsigned int owner = row( std::max( proxy1.lower.y(), proxy2.lower.y() ) )*_columns + column( std::max( proxy1.lower.x(), proxy2.lower.x() ) );
+          if ( owner != *cell_it ) continue;
+
+          if ( handler.canCollide( proxy1.team, proxy2.team ) )
+          {
+            pairs.push_back( std::make_pair( proxy1.object, proxy2.object ) );
+          }
+        }
+      }
+    }
+  }
+
+}
+
@@ -10,7 +10,11 @@
 #include "Regolith/ObjectInterfaces/AnimatedObject.h"
 #include "Regolith/ObjectInterfaces/ControllableObject.h"
 #include "Regolith/Managers/Manager.h"
-#include "Regolith/GamePlay/Camera.h"
+#include "Regolith/GamePlay/RenderQueue.h"
+#include "Regolith/Collisions/ContinuousCollision.h"
+
+#include <algorithm>
+#include <cmath>
 
 
 namespace Regolith
@@ -20,6 +24,8 @@ namespace Regolith
 
   void configureObject( ContextLayer&, PhysicalObject*, Json::Value& );
 
+  bool restingPair( PhysicalObject*, PhysicalObject* );
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
   Context::Context() :
@@ -29,10 +35,18 @@ namespace Regolith
     _theInput(),
     _theFocus(),
     _theCollision(),
+    _cameraPosition(),
+    _cameraOffset(),
+    _lastCameraPosition(),
     _closed( false ),
     _paused( false ),
     _pauseable( false ),
-    _layers()
+    _layers(),
+    _candidatePairs(),
+    _islandPairs(),
+    _bullets(),
+    _usePhysicsStore( false ),
+    _physicsStore()
   {
   }
 
@@ -67,12 +81,16 @@ namespace Regolith
 
   void Context::startContext()
   {
+    storeTransforms();
+    attachPhysicsObjects();
     this->onStart();
   }
 
 
   void Context::stopContext()
   {
+    // Hand the shared objects back so that the contexts that are still running keep moving them
+    _physicsStore.clear();
     this->onStop();
   }
 
@@ -83,6 +101,9 @@ namespace Regolith
     {
       _paused = true;
       _owner->getAudioHandler().pause();
+
+      // Nothing moves while paused, so stop interpolating towards the last update
+      storeTransforms();
       this->onPause();
     }
   }
@@ -94,6 +115,7 @@ namespace Regolith
     {
       _paused = false;
       _owner->getAudioHandler().play();
+      attachPhysicsObjects();
       this->onResume();
     }
   }
@@ -106,47 +128,79 @@ namespace Regolith
   {
     DEBUG_LOG( "Context::update : Context Update" );
 
-    // Update all the animated objects
+    // Re-apply the impulses from the contacts that persisted since the last frame
+    _theCollision.warmStart();
+
+    // Remove the objects marked for destruction in a single pass, keeping the order of the rest
     ContextLayerList::iterator layer_end = _layers.end();
     for ( ContextLayerList::iterator layer_it = _layers.begin(); layer_it != layer_end; ++layer_it )
     {
+      layer_it->removeDestroyed();
+    }
+
+    // Rendering interpolates from the state at the start of this update
+    storeTransforms();
+
+    // Integrate every object in this context's physics store at once. They are skipped in the per-object loop below
+    if ( _usePhysicsStore )
+    {
+      _physicsStore.integrate( time );
+    }
+
+    // Update all the animated objects
+    for ( ContextLayerList::iterator layer_it = _layers.begin(); layer_it != layer_end; ++layer_it )
+    {
+      _bullets.clear();
+
       for ( LayerGraph::iterator team_it = layer_it->layerGraph.begin(); team_it != layer_it->layerGraph.end(); ++team_it )
       {
-        DEBUG_STREAM << "Context::update : Updating " << team_it->second.size() << " objects.";
-        for ( PhysicalObjectList::iterator obj_it = team_it->second.begin(); obj_it != team_it->second.end(); /*++obj_it*/ )
+        DEBUG_STREAM << "Context::update : Updating " << team_it->size() << " objects.";
+        for ( PhysicalObjectVector::iterator obj_it = team_it->begin(); obj_it != team_it->end(); ++obj_it )
         {
-          // If object is marked for destruction, remove it from the scene graph
-          if ( (*obj_it)->isDestroyed() )
+          // If object can be moved, do the physics integration. Sleeping objects are left where they are.
+          if ( (*obj_it)->hasMovement() && ! (*obj_it)->isSleeping() )
           {
-            DEBUG_LOG( "Context::update : Removing object from layer." );
-            obj_it = team_it->second.erase( obj_it );
-            continue;
-          }
-          else
-          {
-
-            // If object can be moved, do the physics integration
-            if ( (*obj_it)->hasMovement() )
+            // Objects shared with another context may be in its store, and are stepped through their slot
+            if ( (*obj_it)->getPhysicsStore() != &_physicsStore )
             {
               (*obj_it)->step( time );
             }
 
-            // If the object is animated, update the animation
-            if ( (*obj_it)->hasAnimation() )
+            if ( _theCollision.isSleepEnabled() )
             {
-              dynamic_cast<AnimatedObject*>(*obj_it)->update( time );
+              (*obj_it)->updateRest( _theCollision.getSleepVelocity(), _theCollision.getSleepAngularVelocity() );
             }
+          }
 
-            if ( (*obj_it)->hasPhysics() )
+          // If the object is animated, update the animation
+          if ( (*obj_it)->hasAnimation() )
+          {
+            dynamic_cast<AnimatedObject*>(*obj_it)->update( time );
+          }
+
+          // Refresh the world-space hitboxes once the object has moved and changed frame
+          if ( (*obj_it)->hasCollision() )
+          {
+            dynamic_cast<CollidableObject*>(*obj_it)->updateWorldHitBoxes();
+
+            if ( (*obj_it)->isBullet() && ! (*obj_it)->isSleeping() )
             {
-              this->updatePhysics( (*obj_it), time );
+              _bullets.push_back( dynamic_cast<CollidableObject*>(*obj_it) );
             }
+          }
 
-            // Update the iterator.
-            ++obj_it;
+          if ( (*obj_it)->hasPhysics() && ! (*obj_it)->isSleeping() )
+          {
+            this->updatePhysics( (*obj_it), time );
           }
         }
       }
+
+      // Stop fast objects at the first static object they passed through
+      if ( ! _bullets.empty() )
+      {
+        sweepBullets( *layer_it );
+      }
     }
 
     // Update the context state
@@ -156,91 +210,233 @@ namespace Regolith
     _cameraPosition = updateCamera( time );
 
 
-    DEBUG_STREAM << "Context::update : Starting Team Collision";
-    CollisionHandler::SetIterator team_end = _theCollision.teamCollisionEnd();
+    DEBUG_STREAM << "Context::update : Starting Broad Phase";
 
     for ( ContextLayerList::iterator layer_it = _layers.begin(); layer_it != layer_end; ++layer_it )
     {
-      for ( CollisionHandler::SetIterator rule_it = _theCollision.teamCollisionBegin(); rule_it != team_end; ++rule_it )
-      {
-        PhysicalObjectList& team = layer_it->layerGraph[ *rule_it ];
-        if ( team.size() < 2 ) continue;
+      BroadPhase& broad_phase = layer_it->getBroadPhase();
+      broad_phase.startUpdate();
 
-        PhysicalObjectList::iterator end = team.end();
-        PhysicalObjectList::iterator it1 = team.begin();
-        PhysicalObjectList::iterator it2 = team.begin();
+      for ( CollisionTeam team = 0; team < layer_it->layerGraph.size(); ++team )
+      {
+        if ( ! _theCollision.isColliding( team ) ) continue;
 
-        while ( it1 != end )
+        PhysicalObjectVector& objects = layer_it->layerGraph[ team ];
+        for ( PhysicalObjectVector::iterator obj_it = objects.begin(); obj_it != objects.end(); ++obj_it )
         {
-          it2 = it1;
-          ++it2;
-          while ( it2 != end )
+          if ( (*obj_it)->hasCollision() )
           {
-            _theCollision.collides( dynamic_cast<CollidableObject*>((*it1)), dynamic_cast<CollidableObject*>((*it2)) );
-            ++it2;
+            broad_phase.insert( dynamic_cast<CollidableObject*>( *obj_it ) );
           }
-          ++it1;
         }
       }
-    }
 
+      _candidatePairs.clear();
+      broad_phase.findPairs( _theCollision, _candidatePairs );
 
-    DEBUG_STREAM << "Context::update : Starting Layer Collision";
-    CollisionHandler::PairIterator collides_end = _theCollision.collisionEnd();
+      DEBUG_STREAM << "Context::update : Layer " << layer_it->getName() << " : " << broad_phase.size() << " objects, " << _candidatePairs.size() << " candidate pairs";
 
-    for ( ContextLayerList::iterator layer_it = _layers.begin(); layer_it != layer_end; ++layer_it )
-    {
-      for ( CollisionHandler::PairIterator rule_it = _theCollision.collisionBegin(); rule_it != collides_end; ++rule_it )
+      if ( _theCollision.isSleepEnabled() )
+      {
+        // Nothing can change between objects that are both at rest
+        BroadPhase::PairList::iterator pairs_end = std::remove_if( _candidatePairs.begin(), _candidatePairs.end(),
+            []( const BroadPhase::PairList::value_type& pair ) { return restingPair( pair.first, pair.second ); } );
+        _candidatePairs.erase( pairs_end, _candidatePairs.end() );
+      }
+
+      // Detection only reads the world-space caches so it can run in parallel
+      _theCollision.narrowPhase( _candidatePairs );
+
+
+      // Containment contacts join the same buffer so that all the contacts in the layer are resolved together
+      size_t number_teams = layer_it->layerGraph.size();
+      for ( CollisionTeam container = 0; container < number_teams; ++container )
       {
-        PhysicalObjectList& team1 = layer_it->layerGraph[ rule_it->first ];
+        PhysicalObjectVector& team1 = layer_it->layerGraph[ container ];
         if ( team1.size() == 0 ) continue;
-        PhysicalObjectList& team2 = layer_it->layerGraph[ rule_it->second ];
-        if ( team2.size() == 0 ) continue;
 
-        PhysicalObjectList::iterator end1 = team1.end();
-        PhysicalObjectList::iterator end2 = team2.end();
+        for ( CollisionTeam contained = 0; contained < number_teams; ++contained )
+        {
+          if ( ! _theCollision.canContain( container, contained ) ) continue;
+
+          PhysicalObjectVector& team2 = layer_it->layerGraph[ contained ];
+          if ( team2.size() == 0 ) continue;
+
+          PhysicalObjectVector::iterator end1 = team1.end();
+          PhysicalObjectVector::iterator end2 = team2.end();
 
-        for ( PhysicalObjectList::iterator it1 = team1.begin(); it1 != end1; ++it1 )
+          for ( PhysicalObjectVector::iterator it1 = team1.begin(); it1 != end1; ++it1 )
+          {
+            for ( PhysicalObjectVector::iterator it2 = team2.begin(); it2 != end2; ++it2 )
+            {
+              if ( restingPair( *it1, *it2 ) ) continue;
+
+              _theCollision.addContainment( dynamic_cast<CollidableObject*>( *it1 ), dynamic_cast<CollidableObject*>( *it2 ) );
+            }
+          }
+        }
+      }
+
+
+      if ( _theCollision.isSleepEnabled() )
+      {
+        // Remember who touched who before the contacts are consumed
+        _islandPairs.clear();
+        for ( CollisionHandler::ContactIterator contact_it = _theCollision.contactBegin(); contact_it != _theCollision.contactEnd(); ++contact_it )
         {
-          for ( PhysicalObjectList::iterator it2 = team2.begin(); it2 != end2; ++it2 )
+          _islandPairs.push_back( std::make_pair( contact_it->object1, contact_it->object2 ) );
+        }
+      }
+
+      // Resolution stays serial and in order
+      _theCollision.resolveContacts( time );
+
+      if ( _theCollision.isSleepEnabled() )
+      {
+        updateIslands( *layer_it );
+      }
+    }
+  }
+
+
+  void Context::sweepBullets( ContextLayer& layer )
+  {
+    for ( std::vector< CollidableObject* >::iterator bullet_it = _bullets.begin(); bullet_it != _bullets.end(); ++bullet_it )
+    {
+      CollidableObject* bullet = (*bullet_it);
+      Vector displacement = bullet->position() - bullet->previousPosition();
+
+      if ( displacement.square() < epsilon ) continue;
+
+      float first_impact = 1.0;
+      bool impact = false;
+
+      for ( CollisionTeam team = 0; team < layer.layerGraph.size(); ++team )
+      {
+        if ( ! _theCollision.canCollide( bullet->getCollisionTeam(), team ) ) continue;
+
+        PhysicalObjectVector& objects = layer.layerGraph[ team ];
+        for ( PhysicalObjectVector::iterator obj_it = objects.begin(); obj_it != objects.end(); ++obj_it )
+        {
+          // Only static geometry. Moving objects are left to the discrete tests.
+          if ( (*obj_it)->hasMovement() || ! (*obj_it)->hasCollision() || (*obj_it)->isDestroyed() ) continue;
+
+          CollidableObject* fixed = dynamic_cast<CollidableObject*>( *obj_it );
+          fixed->updateWorldHitBoxes();
+
+          float time;
+          if ( timeOfImpact( bullet, displacement, fixed, time ) && time < first_impact )
           {
-            _theCollision.collides( dynamic_cast<CollidableObject*>((*it1)), dynamic_cast<CollidableObject*>((*it2)) );
+            first_impact = time;
+            impact = true;
           }
         }
       }
+
+      if ( impact )
+      {
+        // Leave it just touching so the narrow phase resolves the contact this frame
+        float fraction = std::min( first_impact + sweep_skin / std::sqrt( displacement.square() ), 1.0 );
+
+        DEBUG_STREAM << "Context::sweepBullets : Bullet clamped to " << fraction << " of its step";
+
+        bullet->clampStep( fraction );
+        bullet->updateWorldHitBoxes();
+      }
     }
+  }
 
 
-    DEBUG_STREAM << "Context::update : Starting Layer Containment";
-    collides_end = _theCollision.containerEnd();
+  void Context::updateIslands( ContextLayer& layer )
+  {
+    unsigned int sleep_frames = _theCollision.getSleepFrames();
 
-    for ( ContextLayerList::iterator layer_it = _layers.begin(); layer_it != layer_end; ++layer_it )
+    // Contact with an awake body wakes a sleeping one, and through it the rest of its island
+    for ( BroadPhase::PairList::iterator pair_it = _islandPairs.begin(); pair_it != _islandPairs.end(); ++pair_it )
     {
-      for ( CollisionHandler::PairIterator rule_it = _theCollision.containerBegin(); rule_it != collides_end; ++rule_it )
+      if ( pair_it->first->hasMovement() && pair_it->second->hasMovement() )
       {
-        PhysicalObjectList& team1 = layer_it->layerGraph[ rule_it->first ];
-        if ( team1.size() == 0 ) continue;
-        PhysicalObjectList& team2 = layer_it->layerGraph[ rule_it->second ];
-        if ( team2.size() == 0 ) continue;
+        if ( pair_it->first->isSleeping() && ! pair_it->second->isSleeping() )
+        {
+          pair_it->first->wake();
+        }
+        else if ( pair_it->second->isSleeping() && ! pair_it->first->isSleeping() )
+        {
+          pair_it->second->wake();
+        }
+      }
+    }
 
-        PhysicalObjectList::iterator end1 = team1.end();
-        PhysicalObjectList::iterator end2 = team2.end();
+    // Any island with an awake root has been disturbed. Wake all of its members.
+    for ( LayerGraph::iterator team_it = layer.layerGraph.begin(); team_it != layer.layerGraph.end(); ++team_it )
+    {
+      for ( PhysicalObjectVector::iterator obj_it = team_it->begin(); obj_it != team_it->end(); ++obj_it )
+      {
+        if ( (*obj_it)->isSleeping() && ! (*obj_it)->findIsland()->isSleeping() )
+        {
+          (*obj_it)->wake();
+        }
+      }
+    }
 
-        for ( PhysicalObjectList::iterator it1 = team1.begin(); it1 != end1; ++it1 )
+    // Rebuild the islands of the awake objects from this frame's contacts. Sleeping islands keep their links.
+    for ( LayerGraph::iterator team_it = layer.layerGraph.begin(); team_it != layer.layerGraph.end(); ++team_it )
+    {
+      for ( PhysicalObjectVector::iterator obj_it = team_it->begin(); obj_it != team_it->end(); ++obj_it )
+      {
+        if ( (*obj_it)->hasMovement() && ! (*obj_it)->isSleeping() )
         {
-          for ( PhysicalObjectList::iterator it2 = team2.begin(); it2 != end2; ++it2 )
-          {
-            _theCollision.contains( dynamic_cast<CollidableObject*>( *it1 ), dynamic_cast<CollidableObject*>( *it2 ) );
-          }
+          (*obj_it)->resetIsland();
+        }
+      }
+    }
+
+    for ( BroadPhase::PairList::iterator pair_it = _islandPairs.begin(); pair_it != _islandPairs.end(); ++pair_it )
+    {
+      // Static objects don't join islands, otherwise everything resting on the floor would be one island
+      if ( pair_it->first->hasMovement() && pair_it->second->hasMovement() )
+      {
+        pair_it->first->joinIsland( pair_it->second );
+      }
+    }
+
+    // An island stays awake while any of its members is still moving
+    for ( LayerGraph::iterator team_it = layer.layerGraph.begin(); team_it != layer.layerGraph.end(); ++team_it )
+    {
+      for ( PhysicalObjectVector::iterator obj_it = team_it->begin(); obj_it != team_it->end(); ++obj_it )
+      {
+        if ( (*obj_it)->hasMovement() && ! (*obj_it)->isSleeping() && (*obj_it)->getRestFrames() < sleep_frames )
+        {
+          (*obj_it)->findIsland()->setIslandAwake();
         }
       }
     }
+
+    unsigned int number_sleeping = 0;
+    for ( LayerGraph::iterator team_it = layer.layerGraph.begin(); team_it != layer.layerGraph.end(); ++team_it )
+    {
+      for ( PhysicalObjectVector::iterator obj_it = team_it->begin(); obj_it != team_it->end(); ++obj_it )
+      {
+        if ( (*obj_it)->hasMovement() && ! (*obj_it)->isSleeping() && ! (*obj_it)->findIsland()->isIslandAwake() )
+        {
+          (*obj_it)->sleep();
+        }
+
+        if ( (*obj_it)->isSleeping() ) ++number_sleeping;
+      }
+    }
+
+    DEBUG_STREAM << "Context::updateIslands : Layer " << layer.getName() << " : " << number_sleeping << " sleeping objects";
   }
 
 
-  void Context::render( Camera& camera )
+  void Context::render( RenderQueue& queue )
   {
     DEBUG_LOG( "Context::render : Context Render" );
+
+    // Camera follows the objects between updates
+    Vector interpolated_camera = _lastCameraPosition + queue.getInterpolation() * ( _cameraPosition - _lastCameraPosition );
+
     ContextLayerList::iterator layer_end = _layers.end();
     for ( ContextLayerList::iterator layer_it = _layers.begin(); layer_it != layer_end; ++layer_it )
     {
@@ -248,24 +444,49 @@ namespace Regolith
       const Vector& movement_scale = layer_it->getMovementScale();
 
       // % - Directional dot-product
-      Vector camera_position = ( _cameraPosition - layer_position ) % movement_scale;
+      Vector camera_position = ( interpolated_camera - layer_position ) % movement_scale;
 
-      for ( LayerGraph::iterator team_it = layer_it->layerGraph.begin(); team_it != layer_it->layerGraph.end(); ++team_it )
+      for ( CollisionTeam team = 0; team < layer_it->layerGraph.size(); ++team )
       {
-        DEBUG_STREAM << "Context::render : Rendering team : " << team_it->first;
-        for ( PhysicalObjectList::iterator it = team_it->second.begin(); it != team_it->second.end(); ++it )
+        DEBUG_STREAM << "Context::render : Rendering team : " << team;
+        PhysicalObjectVector& objects = layer_it->layerGraph[ team ];
+        for ( PhysicalObjectVector::iterator it = objects.begin(); it != objects.end(); ++it )
         {
           // If the object can be drawn, render it to the back buffer
           if ( (*it)->hasTexture() )
           {
-            camera.renderDrawableObject( dynamic_cast<DrawableObject*>(*it), camera_position );
+            queue.drawObject( dynamic_cast<DrawableObject*>(*it), camera_position );
           }
         }
       }
     }
 
     // Call inherited function to do any context-specific rendering. (e.g. transition effects)
-    renderContext( camera );
+    renderContext( queue );
+  }
+
+
+  void Context::storeTransforms()
+  {
+    _lastCameraPosition = _cameraPosition;
+
+    ContextLayerList::iterator layer_end = _layers.end();
+    for ( ContextLayerList::iterator layer_it = _layers.begin(); layer_it != layer_end; ++layer_it )
+    {
+      layer_it->forEachObject( []( PhysicalObject* object ) { object->storeTransform(); } );
+    }
+  }
+
+
+  void Context::attachPhysicsObjects()
+  {
+    if ( ! _usePhysicsStore ) return;
+
+    ContextLayerList::iterator layer_end = _layers.end();
+    for ( ContextLayerList::iterator layer_it = _layers.begin(); layer_it != layer_end; ++layer_it )
+    {
+      layer_it->forEachObject( [this]( PhysicalObject* object ) { if ( object->usesPhysicsStore() ) _physicsStore.attach( object ); } );
+    }
   }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////// 
@@ -298,6 +519,13 @@ namespace Regolith
       DEBUG_STREAM << "Context::configure : Context " << ( _pauseable ? "is" : "is not" ) << " pauseable";
     }
 
+    // Batched integration for the object types that support it
+    if ( validateJson( json_data, "physics_store", JsonType::BOOLEAN, false ) )
+    {
+      _usePhysicsStore = json_data["physics_store"].asBool();
+      DEBUG_STREAM << "Context::configure : Context " << ( _usePhysicsStore ? "uses" : "does not use" ) << " the physics store";
+    }
+
 
     DEBUG_LOG( "Context::configure : Building context layers" );
     Json::Value& layers = json_data["layers"];
@@ -394,7 +622,7 @@ namespace Regolith
         configureObject( the_layer, object, object_data[i] );
 
         // and insert!
-        the_layer.layerGraph[ object->getCollisionTeam() ].push_back( object );
+        the_layer.addObject( object );
       }
 
 
@@ -444,7 +672,7 @@ namespace Regolith
         configureObject( the_layer, object, spawn_data[j] );
 
         // and insert!
-        the_layer.layerGraph[ object->getCollisionTeam() ].push_back( object );
+        the_layer.addObject( object );
       }
     }
 
@@ -528,5 +756,15 @@ namespace Regolith
       object->setAngularVelocity( ang_vel );
     }
   }
+
+
+  bool restingPair( PhysicalObject* object1, PhysicalObject* object2 )
+  {
+    // At least one must be asleep and the other either asleep or immovable
+    bool resting1 = object1->isSleeping() || ! object1->hasMovement();
+    bool resting2 = object2->isSleeping() || ! object2->hasMovement();
+
+    return resting1 && resting2 && ( object1->isSleeping() || object2->isSleeping() );
+  }
 }
 
@@ -4,6 +4,8 @@
 #include "Regolith/Architecture/PhysicalObject.h"
 #include "Regolith/Contexts/Context.h"
 
+#include <algorithm>
+
 
 namespace Regolith
 {
@@ -14,6 +16,7 @@ namespace Regolith
     _position( 0.0 ),
     _movementScale( 0.0 ),
     _boundingBox(),
+    _broadPhase( nullptr ),
     layerGraph()
   {
   }
@@ -22,6 +25,22 @@ namespace Regolith
   ContextLayer::~ContextLayer()
   {
     layerGraph.clear();
+
+    if ( _broadPhase != nullptr )
+    {
+      delete _broadPhase;
+      _broadPhase = nullptr;
+    }
+  }
+
+
+  void ContextLayer::setBroadPhase( BroadPhase* broad_phase )
+  {
+    if ( _broadPhase != nullptr )
+    {
+      delete _broadPhase;
+    }
+    _broadPhase = broad_phase;
   }
 
 
@@ -35,5 +54,67 @@ namespace Regolith
     _boundingBox.configure( _position, width, height );
   }
 
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Object storage
+
+  void ContextLayer::addObject( PhysicalObject* object )
+  {
+    CollisionTeam team = object->getCollisionTeam();
+    if ( team >= layerGraph.size() )
+    {
+      layerGraph.resize( team + 1 );
+    }
+
+    layerGraph[ team ].push_back( object );
+
+    // Don't interpolate from wherever the object was before it was placed
+    object->storeTransform();
+
+    // Types with the default integrator hand their state to the context's store, if it has one
+    PhysicsStore* store = ( _owner == nullptr ? nullptr : _owner->getPhysicsStore() );
+    if ( store != nullptr && object->usesPhysicsStore() )
+    {
+      store->attach( object );
+    }
+  }
+
+
+  void ContextLayer::removeDestroyed()
+  {
+    PhysicsStore* store = ( _owner == nullptr ? nullptr : _owner->getPhysicsStore() );
+
+    for ( LayerGraph::iterator team_it = layerGraph.begin(); team_it != layerGraph.end(); ++team_it )
+    {
+      // Destroyed objects give their state back before they are reset or respawned
+      if ( store != nullptr )
+      {
+        for ( PhysicalObjectVector::iterator obj_it = team_it->begin(); obj_it != team_it->end(); ++obj_it )
+        {
+          if ( (*obj_it)->isDestroyed() ) store->detach( *obj_it );
+        }
+      }
+
+      PhysicalObjectVector::iterator end = std::remove_if( team_it->begin(), team_it->end(), []( PhysicalObject* object ) { return object->isDestroyed(); } );
+
+      if ( end != team_it->end() )
+      {
+        DEBUG_STREAM << "ContextLayer::removeDestroyed : Removing " << ( team_it->end() - end ) << " objects from layer " << _name;
+        team_it->erase( end, team_it->end() );
+      }
+    }
+  }
+
+
+  size_t ContextLayer::getNumberObjects() const
+  {
+    size_t number = 0;
+    for ( LayerGraph::const_iterator team_it = layerGraph.begin(); team_it != layerGraph.end(); ++team_it )
+    {
+      number += team_it->size();
+    }
+    return number;
+  }
+
 }
 
@@ -1,6 +1,5 @@
 
 #include "Regolith/GamePlay/Camera.h"
-#include "Regolith/ObjectInterfaces/DrawableObject.h"
 #include "Regolith/Managers/WindowManager.h"
 #include "Regolith/Textures/Texture.h"
 #include "Regolith/Assets/RawTexture.h"
@@ -87,27 +86,37 @@ namespace Regolith
   }
 
 
-  void Camera::renderDrawableObject( DrawableObject* object, Vector& camera_position )
+  void Camera::replay( const RenderCommandList& commands )
   {
-    // Scale factors account for different window sizes
-    _targetRect.x = ( object->position().x() - object->center().x() - camera_position.x() ) * _scaleX;
-    _targetRect.y = ( object->position().y() - object->center().y() - camera_position.y() ) * _scaleY;
-    _targetRect.w = object->getWidth() * _scaleX;
-    _targetRect.h = object->getHeight() * _scaleY;
+    for ( RenderCommandList::const_iterator it = commands.begin(); it != commands.end(); ++it )
+    {
+      if ( it->type == RenderCommandType::Fill )
+      {
+        SDL_Color colour = it->colour;
+        fillWindow( colour );
+        continue;
+      }
 
-    // Get a reference to the texture object
-    Texture& texture = object->getTexture();
+      // Textures that were pending when recorded have been uploaded since
+      SDL_Texture* sdl_texture = ( it->texture != nullptr ? it->texture->getSDLTexture() : it->sdlTexture );
+      if ( sdl_texture == nullptr ) continue;
 
-    // If a new surface has been provided, re-render the texture
-    if ( texture.update() )
-    {
-      renderTexture( texture );
-    }
+      // Scale factors account for different window sizes
+      _targetRect.x = it->x * _scaleX;
+      _targetRect.y = it->y * _scaleY;
+      _targetRect.w = it->width * _scaleX;
+      _targetRect.h = it->height * _scaleY;
+
+      DEBUG_STREAM << "Camera::replay : " << _targetRect.x << ", " << _targetRect.y << ", " << _targetRect.w << ", " << _targetRect.h << " ~ " << it->angle << " @ " << sdl_texture;
 
-    DEBUG_STREAM << "Camera::renderDrawableObject : " << _targetRect.x << ", " << _targetRect.y << ", " << _targetRect.w << ", " << _targetRect.h << " ~ " << object->getRotation()+texture.getRotation() <<  " @ " << texture.getSDLTexture();
+      // SDL textures may be shared between objects, so the modulation is set for every copy
+      SDL_SetTextureBlendMode( sdl_texture, it->blendMode );
+      SDL_SetTextureColorMod( sdl_texture, it->colour.r, it->colour.g, it->colour.b );
+      SDL_SetTextureAlphaMod( sdl_texture, it->colour.a );
 
-    // Render to the back bufer (Note SDL uses degrees...)
-    SDL_RenderCopyEx( _theRenderer, texture.getSDLTexture(), texture.getClip(), &_targetRect, (object->getRotation()+texture.getRotation())*radians_to_degrees , &object->getCenterPoint(), (SDL_RendererFlip) (object->getFlipFlag() ^ texture.getRendererFlip()) );
+      // Render to the back bufer
+      SDL_RenderCopyEx( _theRenderer, sdl_texture, ( it->clipped ? &it->clip : nullptr ), &_targetRect, it->angle, &it->center, it->flip );
+    }
   }
 
 
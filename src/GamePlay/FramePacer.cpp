@@ -0,0 +1,167 @@
+
+#include "Regolith/GamePlay/FramePacer.h"
+#include "Regolith/Managers/ThreadManager.h"
+
+#include <thread>
+#include <algorithm>
+
+
+namespace Regolith
+{
+
+  FramePacer::FramePacer() :
+    _period( ClockType::duration::zero() ),
+    _vsync( true ),
+    _idleTime( std::chrono::milliseconds( 100 ) ),
+    _deadline( ClockType::now() ),
+    _spinTime( std::chrono::milliseconds( 1 ) ),
+    _maxSpinTime( std::chrono::milliseconds( 1 ) ),
+    _lastPresent( 0 ),
+    _frameCount( 0 ),
+    _missedCount( 0 ),
+    _worstLateness( 0.0 ),
+    _lastWake( 0 ),
+    _mutex(),
+    _condition(),
+    _presentCount( 0 ),
+    _wakeCount( 0 )
+  {
+  }
+
+
+  FramePacer::~FramePacer()
+  {
+  }
+
+
+  void FramePacer::configure( float fps, float spin )
+  {
+    if ( fps > 0.0 )
+    {
+      _period = std::chrono::duration_cast< ClockType::duration >( std::chrono::duration< float >( 1.0 / fps ) );
+    }
+    else
+    {
+      _period = ClockType::duration::zero();
+    }
+
+    _maxSpinTime = std::chrono::duration_cast< ClockType::duration >( std::chrono::duration< float, std::milli >( spin ) );
+    _spinTime = _maxSpinTime;
+  }
+
+
+  void FramePacer::sleepUntil( ClockType::time_point deadline )
+  {
+    ClockType::time_point wake_time = deadline - _spinTime;
+
+    if ( ClockType::now() < wake_time )
+    {
+      std::this_thread::sleep_until( wake_time );
+
+      // Follow the worst recent wake up latency, and slowly give the time back when the scheduler is prompt
+      ClockType::duration overshoot = ClockType::now() - wake_time;
+      _spinTime = std::min( _maxSpinTime, std::max( overshoot, _spinTime - _spinTime / 16 ) );
+    }
+
+    // Give the core away without risking another late wake up
+    while ( ClockType::now() < deadline )
+    {
+      std::this_thread::yield();
+    }
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Engine thread
+
+  void FramePacer::start()
+  {
+    _deadline = ClockType::now() + _period;
+
+    std::lock_guard< std::mutex > lock( _mutex );
+    _lastPresent = _presentCount;
+  }
+
+
+  void FramePacer::waitForFrame()
+  {
+    if ( _period > ClockType::duration::zero() )
+    {
+      ClockType::time_point now = ClockType::now();
+      ++_frameCount;
+
+      if ( now > _deadline )
+      {
+        float lateness = std::chrono::duration< float, std::milli >( now - _deadline ).count();
+        ++_missedCount;
+        if ( lateness > _worstLateness ) _worstLateness = lateness;
+
+        DEBUG_STREAM << "FramePacer::waitForFrame : Missed frame deadline by " << lateness << " ms";
+
+        // Start the next frame now rather than rushing to catch up
+        _deadline = now + _period;
+      }
+      else
+      {
+        sleepUntil( _deadline );
+        _deadline += _period;
+      }
+    }
+    else if ( _vsync )
+    {
+      // Follow the display refresh through the rendering thread
+      std::unique_lock< std::mutex > lock( _mutex );
+      _condition.wait_for( lock, _idleTime, [&]()->bool{ return ( _presentCount != _lastPresent ) || ThreadManager::QuitFlag; } );
+      _lastPresent = _presentCount;
+    }
+  }
+
+
+  void FramePacer::report()
+  {
+    if ( _frameCount > 0 )
+    {
+      INFO_STREAM << "FramePacer::report : Missed " << _missedCount << " of " << _frameCount << " frame deadlines. Worst by " << _worstLateness << " ms";
+    }
+
+    _frameCount = 0;
+    _missedCount = 0;
+    _worstLateness = 0.0;
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Rendering thread
+
+  void FramePacer::framePresented()
+  {
+    std::unique_lock< std::mutex > lock( _mutex );
+    ++_presentCount;
+    lock.unlock();
+
+    _condition.notify_all();
+  }
+
+
+  void FramePacer::waitForWork()
+  {
+    std::unique_lock< std::mutex > lock( _mutex );
+    _condition.wait_for( lock, _idleTime, [&]()->bool{ return ( _wakeCount != _lastWake ) || ThreadManager::QuitFlag; } );
+    _lastWake = _wakeCount;
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Any thread
+
+  void FramePacer::wake()
+  {
+    std::unique_lock< std::mutex > lock( _mutex );
+    ++_wakeCount;
+    lock.unlock();
+
+    _condition.notify_all();
+  }
+
+}
+
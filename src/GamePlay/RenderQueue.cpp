@@ -0,0 +1,168 @@
+
+#include "Regolith/GamePlay/RenderQueue.h"
+#include "Regolith/ObjectInterfaces/DrawableObject.h"
+#include "Regolith/Textures/Texture.h"
+#include "Regolith/Managers/ThreadManager.h"
+
+#include <chrono>
+
+
+namespace Regolith
+{
+
+  RenderQueue::RenderQueue() :
+    _frames(),
+    _recording( &_frames[0] ),
+    _ready( &_frames[1] ),
+    _replaying( &_frames[2] ),
+    _fresh( false ),
+    _replayActive( false ),
+    _interpolation( 1.0 ),
+    _swapMutex(),
+    _released()
+  {
+  }
+
+
+  RenderQueue::~RenderQueue()
+  {
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Recording
+
+  void RenderQueue::startRecording( float interpolation )
+  {
+    _interpolation = interpolation;
+    _recording->commands.clear();
+    _recording->uploads.clear();
+  }
+
+
+  void RenderQueue::drawObject( DrawableObject* object, const Vector& camera_position )
+  {
+    // Draw the object part way between its last two updates
+    Vector position = object->interpolatePosition( _interpolation );
+    float rotation = object->interpolateRotation( _interpolation );
+
+    Texture& texture = object->getTexture();
+
+    RenderCommand command;
+    command.type = RenderCommandType::Copy;
+
+    // A new surface has to be uploaded by the rendering thread before the SDL texture exists
+    if ( texture.update() )
+    {
+      command.texture = &texture;
+      command.sdlTexture = nullptr;
+      _recording->uploads.push_back( &texture );
+    }
+    else
+    {
+      command.texture = nullptr;
+      command.sdlTexture = texture.getSDLTexture();
+    }
+
+    SDL_Rect* clip = texture.getClip();
+    command.clipped = ( clip != nullptr );
+    command.clip = ( command.clipped ? *clip : SDL_Rect( { 0, 0, 0, 0 } ) );
+
+    command.x = position.x() - object->center().x() - camera_position.x();
+    command.y = position.y() - object->center().y() - camera_position.y();
+    command.width = object->getWidth();
+    command.height = object->getHeight();
+
+    // Note SDL uses degrees...
+    command.angle = ( rotation + texture.getRotation() ) * radians_to_degrees;
+    command.center = object->getCenterPoint();
+    command.flip = (SDL_RendererFlip) ( object->getFlipFlag() ^ texture.getRendererFlip() );
+
+    command.blendMode = texture.getBlendMode();
+    command.colour = texture.getColourMod();
+
+    _recording->commands.push_back( command );
+  }
+
+
+  void RenderQueue::fillWindow( const SDL_Color& colour )
+  {
+    RenderCommand command;
+    command.type = RenderCommandType::Fill;
+    command.texture = nullptr;
+    command.sdlTexture = nullptr;
+    command.clip = { 0, 0, 0, 0 };
+    command.clipped = false;
+    command.x = 0.0;
+    command.y = 0.0;
+    command.width = 0.0;
+    command.height = 0.0;
+    command.angle = 0.0;
+    command.center = { 0, 0 };
+    command.flip = SDL_FLIP_NONE;
+    command.blendMode = SDL_BLENDMODE_BLEND;
+    command.colour = colour;
+
+    _recording->commands.push_back( command );
+  }
+
+
+  void RenderQueue::publish()
+  {
+    std::lock_guard< std::mutex > lock( _swapMutex );
+
+    std::swap( _recording, _ready );
+    _fresh = true;
+  }
+
+
+  void RenderQueue::flush()
+  {
+    std::unique_lock< std::mutex > lock( _swapMutex );
+
+    // Poll the flags as well, in case the rendering thread has already stopped
+    while ( _replayActive && ! ThreadManager::QuitFlag && ! ThreadManager::ErrorFlag )
+    {
+      _released.wait_for( lock, std::chrono::milliseconds( 10 ) );
+    }
+
+    for ( unsigned int i = 0; i < 3; ++i )
+    {
+      _frames[i].commands.clear();
+      _frames[i].uploads.clear();
+    }
+    _fresh = false;
+
+    DEBUG_LOG( "RenderQueue::flush : Render queue flushed" );
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Replaying
+
+  RenderFrame& RenderQueue::acquire()
+  {
+    std::lock_guard< std::mutex > lock( _swapMutex );
+
+    if ( _fresh )
+    {
+      std::swap( _replaying, _ready );
+      _fresh = false;
+    }
+
+    _replayActive = true;
+    return *_replaying;
+  }
+
+
+  void RenderQueue::release()
+  {
+    std::unique_lock< std::mutex > lock( _swapMutex );
+    _replayActive = false;
+    lock.unlock();
+
+    _released.notify_all();
+  }
+
+}
+
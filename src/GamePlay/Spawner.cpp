@@ -25,7 +25,7 @@ namespace Regolith
     {
       PhysicalObject* temp = _owner.pop();
       temp->setPosition( position );
-      _targetLayer->layerGraph[ temp->getCollisionTeam() ].push_back( temp );
+      _targetLayer->addObject( temp );
       return temp;
     }
     else
@@ -42,7 +42,7 @@ namespace Regolith
       PhysicalObject* temp = _owner.pop();
       temp->setPosition( position );
       temp->setVelocity( velocity );
-      _targetLayer->layerGraph[ temp->getCollisionTeam() ].push_back( temp );
+      _targetLayer->addObject( temp );
       return temp;
     }
     else
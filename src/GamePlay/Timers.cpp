@@ -97,7 +97,7 @@ namespace Regolith
   // Minimal timer class
 
   FrameTimer::FrameTimer( unsigned int n ) :
-    _startTime( SDL_GetTicks() ),
+    _startTime( ClockType::now() ),
     _frameCount( n ),
     _frameSum( 0.0 ),
     _fpsSum( 0.0 ),
@@ -111,9 +111,9 @@ namespace Regolith
 
   float FrameTimer::lap()
   {
-    Uint32 ticks = SDL_GetTicks();
-    float time = ticks - _startTime;
-    _startTime = ticks;
+    ClockType::time_point now = ClockType::now();
+    float time = std::chrono::duration< float, std::milli >( now - _startTime ).count();
+    _startTime = now;
 
     _fpsSum += 1000.0 / time;
     _frameSum += 1.0;
@@ -2,31 +2,49 @@
 
 #include "Regolith/Handlers/CollisionHandler.h"
 #include "Regolith/Managers/Manager.h"
+#include "Regolith/Links/LinkThreadManager.h"
 #include "Regolith/ObjectInterfaces/CollidableObject.h"
 #include "Regolith/Contexts/ContextLayer.h"
+#include "Regolith/Collisions/UniformGrid.h"
+#include "Regolith/Collisions/SweepAndPrune.h"
 #include "Regolith/Utilities/BoundingBox.h"
 
 #include <limits>
+#include <algorithm>
+#include <cmath>
 
 
 namespace Regolith
 {
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-  // Forward declarations
+  // Local function declarations
+
+  // Find the closest points between two line segments. Either segment may have zero length.
+  void closestSegmentPoints( const Vector&, const Vector&, const Vector&, const Vector&, Vector&, Vector& );
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
   // Collision handler class member functions
 
   CollisionHandler::CollisionHandler() :
-    _teamCollision(),
-    _pairings(),
-    _containers(),
-    _contact1(),
-    _contact2()
+    _numberTeams( 0 ),
+    _collisionMatrix(),
+    _containerMatrix(),
+    _collidingTeams(),
+    _broadPhaseType( BroadPhaseType::Grid ),
+    _cellSize( 128.0 ),
+    _parallelThreshold( 64 ),
+    _contacts(),
+    _workerContacts(),
+    _sleepEnabled( false ),
+    _sleepVelocity( 0.01 ),
+    _sleepAngularVelocity( 0.001 ),
+    _sleepFrames( 30 ),
+    _warmStarting( false ),
+    _contactCache(),
+    _solverType( SolverType::Direct ),
+    _solver()
   {
-    _contact1.other = &_contact2;
-    _contact2.other = &_contact1;
   }
 
 
@@ -35,63 +53,73 @@ namespace Regolith
   }
 
 
+  void CollisionHandler::addTeam( CollisionTeam team )
+  {
+    if ( team < _numberTeams ) return;
+
+    size_t number = team + 1;
+    TeamMatrix collision( number*number, false );
+    TeamMatrix container( number*number, false );
+
+    for ( size_t i = 0; i < _numberTeams; ++i )
+    {
+      for ( size_t j = 0; j < _numberTeams; ++j )
+      {
+        collision[ i*number + j ] = _collisionMatrix[ i*_numberTeams + j ];
+        container[ i*number + j ] = _containerMatrix[ i*_numberTeams + j ];
+      }
+    }
+
+    _collisionMatrix.swap( collision );
+    _containerMatrix.swap( container );
+    _collidingTeams.resize( number, false );
+    _numberTeams = number;
+  }
+
+
   void CollisionHandler::addTeamCollision( CollisionTeam team )
   {
-    _teamCollision.insert( team );
+    addTeam( team );
+
+    _collisionMatrix[ team*_numberTeams + team ] = true;
+    _collidingTeams[ team ] = true;
   }
 
 
   void CollisionHandler::addCollisionPair( CollisionTeam team1, CollisionTeam team2 )
   {
-    CollisionPairList::iterator end = _pairings.end();
-    for ( CollisionPairList::iterator it = _pairings.begin(); it != end; ++it )
+    addTeam( std::max( team1, team2 ) );
+
+    if ( _collisionMatrix[ team1*_numberTeams + team2 ] )
     {
-      if ( it->first == team1 )
-      {
-        if ( it->second == team2 )
-        {
-          WARN_LOG( "Attempting to add existing team collision pairing twice" );
-          return;
-        }
-      }
-      else if ( it->first == team2 )
-      {
-        if ( it->second == team1 )
-        {
-          WARN_LOG( "Attempting to add existing team collision pairing twice" );
-          return;
-        }
-      }
+      WARN_LOG( "Attempting to add existing team collision pairing twice" );
+      return;
     }
 
-    _pairings.push_back( std::make_pair( team1, team2 ) );
+    _collisionMatrix[ team1*_numberTeams + team2 ] = true;
+    _collisionMatrix[ team2*_numberTeams + team1 ] = true;
+    _collidingTeams[ team1 ] = true;
+    _collidingTeams[ team2 ] = true;
   }
 
 
   void CollisionHandler::addContainerPair( CollisionTeam team1, CollisionTeam team2 )
   {
-    CollisionPairList::iterator end = _pairings.end();
-    for ( CollisionPairList::iterator it = _pairings.begin(); it != end; ++it )
+    addTeam( std::max( team1, team2 ) );
+
+    if ( _containerMatrix[ team1*_numberTeams + team2 ] )
     {
-      if ( it->first == team1 )
-      {
-        if ( it->second == team2 )
-        {
-          WARN_LOG( "Attempting to add existing team collision pairing twice" );
-          return;
-        }
-      }
-      else if ( it->first == team2 )
-      {
-        if ( it->second == team1 )
-        {
-          ERROR_LOG( "Cannot add an inverse contaimment rule." );
-          return;
-        }
-      }
+      WARN_LOG( "Attempting to add existing team container pairing twice" );
+      return;
+    }
+
+    if ( _containerMatrix[ team2*_numberTeams + team1 ] )
+    {
+      ERROR_LOG( "Cannot add an inverse contaimment rule." );
+      return;
     }
 
-    _containers.push_back( std::make_pair( team1, team2 ) );
+    _containerMatrix[ team1*_numberTeams + team2 ] = true;
   }
 
 
@@ -99,6 +127,13 @@ namespace Regolith
   {
     INFO_LOG( "CollisionHandler::configure : Configuring Collision Handler" );
 
+    // Size the rule matrices for every team known to the game
+    size_t number_teams = Manager::getInstance()->getNumberTeams();
+    if ( number_teams > 0 )
+    {
+      addTeam( number_teams - 1 );
+    }
+
     validateJson( json_data, "team_collision", JsonType::ARRAY );
     validateJsonArray( json_data["collision_rules"], 0, JsonType::STRING );
 
@@ -108,6 +143,110 @@ namespace Regolith
     validateJson( json_data, "container_rules", JsonType::ARRAY );
     validateJsonArray( json_data["container_rules"], 0, JsonType::ARRAY );
 
+    // Optional broad phase configuration
+    if ( validateJson( json_data, "broad_phase", JsonType::STRING, false ) )
+    {
+      std::string broad_phase = json_data["broad_phase"].asString();
+
+      if ( broad_phase == "grid" )
+      {
+        _broadPhaseType = BroadPhaseType::Grid;
+      }
+      else if ( broad_phase == "sweep_and_prune" )
+      {
+        _broadPhaseType = BroadPhaseType::SweepAndPrune;
+      }
+      else
+      {
+        Exception ex( "CollisionHandler::configure()", "Unknown broad phase type" );
+        ex.addDetail( "Broad Phase", broad_phase );
+        throw ex;
+      }
+      INFO_STREAM << "CollisionHandler::configure : Broad phase: " << broad_phase;
+    }
+
+    if ( validateJson( json_data, "parallel_threshold", JsonType::INTEGER, false ) )
+    {
+      _parallelThreshold = json_data["parallel_threshold"].asUInt();
+      INFO_STREAM << "CollisionHandler::configure : Parallel narrow phase threshold: " << _parallelThreshold;
+    }
+
+    if ( validateJson( json_data, "cell_size", JsonType::FLOAT, false ) )
+    {
+      _cellSize = json_data["cell_size"].asFloat();
+
+      if ( _cellSize <= 0.0 )
+      {
+        Exception ex( "CollisionHandler::configure()", "Broad phase cell size must be greater than zero" );
+        ex.addDetail( "Cell Size", _cellSize );
+        throw ex;
+      }
+      INFO_STREAM << "CollisionHandler::configure : Broad phase cell size: " << _cellSize;
+    }
+
+    // Optional persistent contacts
+    if ( validateJson( json_data, "warm_starting", JsonType::BOOLEAN, false ) )
+    {
+      _warmStarting = json_data["warm_starting"].asBool();
+      INFO_STREAM << "CollisionHandler::configure : Warm starting " << ( _warmStarting ? "enabled" : "disabled" );
+    }
+
+    if ( validateJson( json_data, "contact_merge_distance", JsonType::FLOAT, false ) )
+    {
+      _contactCache.setMergeDistance( json_data["contact_merge_distance"].asFloat() );
+    }
+
+    // Optional contact solver
+    if ( validateJson( json_data, "solver", JsonType::OBJECT, false ) )
+    {
+      Json::Value& solver_data = json_data["solver"];
+
+      if ( validateJson( solver_data, "type", JsonType::STRING, false ) )
+      {
+        std::string solver_type = solver_data["type"].asString();
+
+        if ( solver_type == "direct" )
+        {
+          _solverType = SolverType::Direct;
+        }
+        else if ( solver_type == "sequential_impulse" )
+        {
+          _solverType = SolverType::SequentialImpulse;
+        }
+        else
+        {
+          Exception ex( "CollisionHandler::configure()", "Unknown contact solver type" );
+          ex.addDetail( "Solver", solver_type );
+          throw ex;
+        }
+        INFO_STREAM << "CollisionHandler::configure : Contact solver: " << solver_type;
+      }
+
+      _solver.configure( solver_data );
+    }
+
+    // Optional sleeping of objects that have come to rest
+    if ( validateJson( json_data, "sleeping", JsonType::OBJECT, false ) )
+    {
+      Json::Value& sleep_data = json_data["sleeping"];
+      _sleepEnabled = true;
+
+      if ( validateJson( sleep_data, "velocity", JsonType::FLOAT, false ) )
+      {
+        _sleepVelocity = sleep_data["velocity"].asFloat();
+      }
+      if ( validateJson( sleep_data, "angular_velocity", JsonType::FLOAT, false ) )
+      {
+        _sleepAngularVelocity = sleep_data["angular_velocity"].asFloat() * degrees_to_radians;
+      }
+      if ( validateJson( sleep_data, "frames", JsonType::INTEGER, false ) )
+      {
+        _sleepFrames = sleep_data["frames"].asUInt();
+      }
+
+      INFO_STREAM << "CollisionHandler::configure : Sleeping enabled. V = " << _sleepVelocity << " W = " << _sleepAngularVelocity << " frames = " << _sleepFrames;
+    }
+
 
     // Load the team collision rules
     Json::Value& team_rules = json_data["team_collision"];
@@ -156,29 +295,237 @@ namespace Regolith
 
   void CollisionHandler::setupEmptyLayer( ContextLayer& layer ) const
   {
-    for ( CollisionPairList::const_iterator it = _pairings.begin(); it != _pairings.end(); ++it )
+    switch ( _broadPhaseType )
     {
-      if ( layer.layerGraph.find( it->first ) == layer.layerGraph.end() )
+      case BroadPhaseType::SweepAndPrune :
+        {
+          SweepAndPrune* sap = new SweepAndPrune();
+          sap->configure( layer.getBoundingBox() );
+          layer.setBroadPhase( sap );
+        }
+        break;
+
+      case BroadPhaseType::Grid :
+      default :
+        {
+          UniformGrid* grid = new UniformGrid();
+          grid->configure( layer.getBoundingBox(), _cellSize );
+          layer.setBroadPhase( grid );
+        }
+        break;
+    }
+
+    // One list of objects for every team
+    layer.layerGraph.resize( _numberTeams );
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Narrow phase
+
+  void CollisionHandler::collides( CollidableObject* object1, CollidableObject* object2 )
+  {
+    object1->updateWorldHitBoxes();
+    object2->updateWorldHitBoxes();
+
+    // Kept apart from the contacts waiting for resolveContacts()
+    ContactBuffer contacts;
+    detectCollision( object1, object2, contacts );
+
+    for ( ContactBuffer::iterator it = contacts.begin(); it != contacts.end(); ++it )
+    {
+      resolve( *it );
+    }
+  }
+
+
+  void CollisionHandler::contains( CollidableObject* object1, CollidableObject* object2 )
+  {
+    object1->updateWorldHitBoxes();
+    object2->updateWorldHitBoxes();
+
+    // Kept apart from the contacts waiting for resolveContacts()
+    ContactBuffer contacts;
+    detectContainment( object1, object2, contacts );
+
+    for ( ContactBuffer::iterator it = contacts.begin(); it != contacts.end(); ++it )
+    {
+      resolve( *it );
+    }
+  }
+
+
+  void CollisionHandler::addContainment( CollidableObject* object1, CollidableObject* object2 )
+  {
+    object1->updateWorldHitBoxes();
+    object2->updateWorldHitBoxes();
+
+    detectContainment( object1, object2, _contacts );
+  }
+
+
+  void CollisionHandler::narrowPhase( const BroadPhase::PairList& pairs )
+  {
+    _contacts.clear();
+
+    size_t number_pairs = pairs.size();
+
+    // Not worth waking the workers
+    JobScheduler* scheduler = nullptr;
+    if ( number_pairs >= _parallelThreshold )
+    {
+      scheduler = &Manager::getInstance()->getThreadManager<CollisionHandler>().jobScheduler();
+    }
+
+    if ( scheduler == nullptr || scheduler->size() == 0 )
+    {
+      for ( BroadPhase::PairList::const_iterator it = pairs.begin(); it != pairs.end(); ++it )
       {
-        layer.layerGraph[ it->first ] = PhysicalObjectList();
+        detectCollision( it->first, it->second, _contacts );
       }
-      if ( layer.layerGraph.find( it->second ) == layer.layerGraph.end() )
+      return;
+    }
+
+    // One block for each worker and one for this thread, which helps while it waits
+    size_t number_blocks = std::min( number_pairs, (size_t)scheduler->size() + 1 );
+    size_t grain = ( number_pairs + number_blocks - 1 ) / number_blocks;
+    number_blocks = ( number_pairs + grain - 1 ) / grain;
+
+    _workerContacts.resize( number_blocks );
+    for ( size_t i = 0; i < number_blocks; ++i )
+    {
+      _workerContacts[i].clear();
+    }
+
+    // Each block of pairs fills its own buffer
+    scheduler->parallelFor( number_pairs, grain, [&]( size_t start, size_t end )
+    {
+      ContactBuffer& buffer = _workerContacts[ start / grain ];
+
+      for ( size_t i = start; i < end; ++i )
       {
-        layer.layerGraph[ it->second ] = PhysicalObjectList();
+        detectCollision( pairs[i].first, pairs[i].second, buffer );
       }
+    } );
+
+    // Merge in block order so the result matches the serial ordering
+    for ( size_t i = 0; i < number_blocks; ++i )
+    {
+      _contacts.insert( _contacts.end(), _workerContacts[i].begin(), _workerContacts[i].end() );
     }
 
-    for ( CollisionPairList::const_iterator it = _containers.begin(); it != _containers.end(); ++it )
+    DEBUG_STREAM << "CollisionHandler::narrowPhase : " << number_pairs << " pairs tested in " << number_blocks << " blocks. " << _contacts.size() << " contacts found";
+  }
+
+
+  void CollisionHandler::warmStart()
+  {
+    if ( ! _warmStarting ) return;
+
+    _contactCache.startFrame();
+
+    DEBUG_STREAM << "CollisionHandler::warmStart : " << _contactCache.size() << " cached manifolds";
+
+    for ( ContactCache::ManifoldIterator it = _contactCache.begin(); it != _contactCache.end(); ++it )
     {
-      if ( layer.layerGraph.find( it->first ) == layer.layerGraph.end() )
+      CollidableObject* object1 = ContactCache::object1( it );
+      CollidableObject* object2 = ContactCache::object2( it );
+
+      // Don't disturb sleeping objects or push objects that have been removed
+      if ( object1->isSleeping() || object2->isSleeping() ) continue;
+      if ( object1->isDestroyed() || object2->isDestroyed() ) continue;
+
+      const ContactManifold& manifold = it->second;
+      for ( unsigned int i = 0; i < manifold.number; ++i )
       {
-        layer.layerGraph[ it->first ] = PhysicalObjectList();
+        const ContactPoint& point = manifold.points[i];
+
+        if ( object1->hasTranslation() )
+        {
+          Vector impulse = object1->getInverseMass() * point.normalImpulse * point.normal;
+          object1->kick( impulse );
+        }
+        if ( object2->hasTranslation() )
+        {
+          Vector impulse = - object2->getInverseMass() * point.normalImpulse * point.normal;
+          object2->kick( impulse );
+        }
+
+        if ( object1->hasRotation() )
+        {
+          float lever_len = point.normal ^ ( point.point - object1->getPosition() );
+          object1->spin( - object1->getInverseInertia() * point.normalImpulse * lever_len );
+        }
+        if ( object2->hasRotation() )
+        {
+          float lever_len = - point.normal ^ ( point.point - object2->getPosition() );
+          object2->spin( - object2->getInverseInertia() * point.normalImpulse * lever_len );
+        }
       }
-      if ( layer.layerGraph.find( it->second ) == layer.layerGraph.end() )
+    }
+  }
+
+
+  float CollisionHandler::accumulateImpulse( ContactPair& pair, float relative_impulse, float lever_len_1, float lever_len_2 )
+  {
+    CollidableObject* object1 = pair.object1;
+    CollidableObject* object2 = pair.object2;
+
+    float momentum_sink = 0.0;
+
+    if ( object1->hasTranslation() )
+    {
+      momentum_sink += object1->getInverseMass();
+    }
+    if ( object2->hasTranslation() )
+    {
+      momentum_sink += object2->getInverseMass();
+    }
+    if ( object1->hasRotation() )
+    {
+      momentum_sink += lever_len_1*lever_len_1*object1->getInverseInertia();
+    }
+    if ( object2->hasRotation() )
+    {
+      momentum_sink += lever_len_2*lever_len_2*object2->getInverseInertia();
+    }
+
+    if ( momentum_sink < epsilon ) return 0.0;
+
+    // The velocities already include last frame's impulse, so this is the correction to it.
+    // Clamping the total rather than the correction lets a contact give back impulse it over-applied.
+    ContactPoint& point = _contactCache.findPoint( pair );
+
+    float old_impulse = point.normalImpulse;
+    point.normalImpulse = std::min( old_impulse + relative_impulse / momentum_sink, 0.0f );
+
+    return point.normalImpulse - old_impulse;
+  }
+
+
+  void CollisionHandler::resolveContacts( float time )
+  {
+    if ( _solverType == SolverType::SequentialImpulse )
+    {
+      _solver.solve( _contacts, ( _warmStarting ? &_contactCache : nullptr ), time );
+
+      for ( ContactBuffer::iterator it = _contacts.begin(); it != _contacts.end(); ++it )
+      {
+        it->contact1.other = &it->contact2;
+        it->contact2.other = &it->contact1;
+
+        it->object1->onCollision( it->contact1, it->object2 );
+        it->object2->onCollision( it->contact2, it->object1 );
+      }
+    }
+    else
+    {
+      for ( ContactBuffer::iterator it = _contacts.begin(); it != _contacts.end(); ++it )
       {
-        layer.layerGraph[ it->second ] = PhysicalObjectList();
+        resolve( *it );
       }
     }
+    _contacts.clear();
   }
 
 
@@ -186,13 +533,25 @@ namespace Regolith
   // Collision algorithm
 
 
-  void CollisionHandler::collides( CollidableObject* object1, CollidableObject* object2 )
+  void CollisionHandler::detectCollision( CollidableObject* object1, CollidableObject* object2, ContactBuffer& contacts ) const
   {
-    _object_pos1 = object1->position();
-    _object_pos2 = object2->position();
+    // All scratch space is local so that workers can test pairs concurrently.
+    // The world-space hitboxes must already be up to date.
+    Vector point1, point2;
+    Vector normal1, normal2;
+    float projection1, projection2;
+    float min_projection, max_projection;
+    float largest_overlap;
+    float diff;
+
+    ContactPair pair;
+    pair.object1 = object1;
+    pair.object2 = object2;
 
-    const BoundingBox& boundingBox1 = object1->boundingBox();
-    const BoundingBox& boundingBox2 = object2->boundingBox();
+    const Vector* bounding_points1 = object1->worldBoundingPoints();
+    const Vector* bounding_normals1 = object1->worldBoundingNormals();
+    const Vector* bounding_points2 = object2->worldBoundingPoints();
+    const Vector* bounding_normals2 = object2->worldBoundingNormals();
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -200,23 +559,23 @@ namespace Regolith
     for ( unsigned int b1_i = 0; b1_i < 4; ++b1_i )
     {
       // Absolute _positions of the hit boxes vertices
-      _point1 = _object_pos1 + boundingBox1.points[b1_i].getRotated( object1->rotation() );
-      _normal1 = boundingBox1.normals[b1_i].getRotated( object1->rotation() );
-      _projection1 = _point1 * _normal1;
-      _largest_overlap = std::numeric_limits<float>::max();
+      point1 = bounding_points1[b1_i];
+      normal1 = bounding_normals1[b1_i];
+      projection1 = point1 * normal1;
+      largest_overlap = std::numeric_limits<float>::max();
 
       for ( unsigned int b2_i = 0; b2_i < 4; ++b2_i )
       {
-        _point2 = _object_pos2 + boundingBox2.points[b2_i].getRotated( object2->rotation() );
-        _diff = (_point2*_normal1) - _projection1;
-//        DEBUG_STREAM << "CollisionHandler::collides : Checking BB1, Side  P1 = " << _point1 << ", N = " << _normal1 << " P2 = " << _point2;
+        point2 = bounding_points2[b2_i];
+        diff = (point2*normal1) - projection1;
+//        DEBUG_STREAM << "CollisionHandler::detectCollision : Checking BB1, Side  P1 = " << point1 << ", N = " << normal1 << " P2 = " << point2;
 
-        if ( _diff < _largest_overlap ) // Find the max size of the overlap
+        if ( diff < largest_overlap ) // Find the max size of the overlap
         {
-          _largest_overlap = _diff;
+          largest_overlap = diff;
         }
       }
-      if ( _largest_overlap > 0.0 ) // Separating axis found. We good!
+      if ( largest_overlap > 0.0 ) // Separating axis found. We good!
       {
         return;
       }
@@ -228,23 +587,23 @@ namespace Regolith
     for ( unsigned int b2_i = 0; b2_i < 4; ++b2_i )
     {
       // Absolute _positions of the hit boxes vertices
-      _point2 = _object_pos2 + boundingBox2.points[b2_i].getRotated( object2->rotation() );
-      _normal2 = boundingBox2.normals[b2_i].getRotated( object2->rotation() );
-      _projection2 = _point2 * _normal2;
-      _largest_overlap = std::numeric_limits<float>::max();
+      point2 = bounding_points2[b2_i];
+      normal2 = bounding_normals2[b2_i];
+      projection2 = point2 * normal2;
+      largest_overlap = std::numeric_limits<float>::max();
 
       for ( unsigned int b1_i = 0; b1_i < 4; ++b1_i )
       {
-        _point1 = _object_pos1 + boundingBox1.points[b1_i].getRotated( object1->rotation() );
-        _diff = (_point1*_normal2) - _projection2;
-//        DEBUG_STREAM << "CollisionHandler::collides : Checking BB2, Side  P2 = " << _point2 << ", N = " << _normal2 << " P1 = " << _point1;
+        point1 = bounding_points1[b1_i];
+        diff = (point1*normal2) - projection2;
+//        DEBUG_STREAM << "CollisionHandler::detectCollision : Checking BB2, Side  P2 = " << point2 << ", N = " << normal2 << " P1 = " << point1;
 
-        if ( _diff < _largest_overlap ) // Find the max size of the overlap
+        if ( diff < largest_overlap ) // Find the max size of the overlap
         {
-          _largest_overlap = _diff;
+          largest_overlap = diff;
         }
       }
-      if ( _largest_overlap > 0.0 ) // Separating axis found. We good!
+      if ( largest_overlap > 0.0 ) // Separating axis found. We good!
       {
         return;
       }
@@ -254,64 +613,106 @@ namespace Regolith
 ////////////////////////////////////////////////////////////////////////////////
     // Bounding boxes collide - check the hitboxes
 
-    const Collision& collision1 = object1->getCollision();
-    const Collision& collision2 = object2->getCollision();
+    const Collision::HitBoxVector& collision1 = object1->worldHitBoxes();
+    const Collision::HitBoxVector& collision2 = object2->worldHitBoxes();
+    const std::vector< HitBoxSoA >& packed1 = object1->worldPackedHitBoxes();
+    const std::vector< HitBoxSoA >& packed2 = object2->worldPackedHitBoxes();
 
-    DEBUG_STREAM << "CollisionHandler::collides : Checkig hitboxes. Obj1 : " << _object_pos1 << ", Obj2 : " << _object_pos2;
+    DEBUG_STREAM << "CollisionHandler::detectCollision : Checkig hitboxes. Obj1 : " << object1->position() << ", Obj2 : " << object2->position();
 
-    for ( Collision::iterator col_it1 = collision1.begin(); col_it1 != collision1.end(); ++col_it1 )
+    // Tile maps only offer the hitboxes under the other object's bounding box
+    std::vector< size_t > indices1;
+    std::vector< size_t > indices2;
+    bool indexed1 = object1->hasIndexedHitBoxes();
+    bool indexed2 = object2->hasIndexedHitBoxes();
+    if ( indexed1 ) findIndexedHitBoxes( object1, object2, indices1 );
+    if ( indexed2 ) findIndexedHitBoxes( object2, object1, indices2 );
+    size_t number1 = ( indexed1 ? indices1.size() : collision1.size() );
+    size_t number2 = ( indexed2 ? indices2.size() : collision2.size() );
+
+    for ( size_t i1 = 0; i1 < number1; ++i1 )
     {
-      const HitBox& box1 = (*col_it1);
-      for ( Collision::iterator col_it2 = collision2.begin(); col_it2 != collision2.end(); ++col_it2 )
+      size_t hb1 = ( indexed1 ? indices1[i1] : i1 );
+      const HitBox& box1 = collision1[hb1];
+      for ( size_t i2 = 0; i2 < number2; ++i2 )
       {
-        const HitBox& box2 = (*col_it2);
-        _contact1.overlap = std::numeric_limits<float>::lowest();
+        size_t hb2 = ( indexed2 ? indices2[i2] : i2 );
+        const HitBox& box2 = collision2[hb2];
+
+////////////////////////////////////////////////////////////////////////////////
+        // Circles and capsules use the specialised tests
+        if ( box1.shape != HitBoxType::Polygon || box2.shape != HitBoxType::Polygon )
+        {
+          bool overlapping;
+          if ( box1.shape == HitBoxType::Polygon )
+          {
+            overlapping = collidePolygonRounded( box1, packed1[hb1], box2, packed2[hb2], pair.contact1.normal, pair.contact1.overlap, pair.contact1.point );
+          }
+          else if ( box2.shape == HitBoxType::Polygon )
+          {
+            overlapping = collidePolygonRounded( box2, packed2[hb2], box1, packed1[hb1], pair.contact2.normal, pair.contact1.overlap, pair.contact1.point );
+            pair.contact1.normal = -pair.contact2.normal;
+          }
+          else if ( box1.shape == HitBoxType::Circle && box2.shape == HitBoxType::Circle )
+          {
+            overlapping = collideCircles( box1, box2, pair.contact1.normal, pair.contact1.overlap, pair.contact1.point );
+          }
+          else
+          {
+            overlapping = collideCapsules( box1, box2, pair.contact1.normal, pair.contact1.overlap, pair.contact1.point );
+          }
+
+          if ( ! overlapping ) continue;
+
+          pair.contact2.overlap = pair.contact1.overlap;
+          pair.contact2.normal = -pair.contact1.normal;
+          pair.contact2.point = pair.contact1.point;
+
+          pair.contact1.type = box1.collisionType;
+          pair.contact2.type = box2.collisionType;
+          pair.hitBox1 = hb1;
+          pair.hitBox2 = hb2;
+          DEBUG_STREAM << "CollisionHandler::detectCollision : Rounded hitbox overlap = " << pair.contact1.overlap <<  " -- Normal 1 = " << pair.contact1.normal;
+          contacts.push_back( pair );
+          continue;
+        }
+
+        pair.contact1.overlap = std::numeric_limits<float>::lowest();
 
 ////////////////////////////////////////////////////////////////////////////////
         // First objects edges.
         for ( unsigned int box1_i = 0; box1_i < box1.number; ++box1_i )
         {
           // Absolute _positions of the hit boxes vertices
-          _point1 = _object_pos1 + box1.points[box1_i].getRotated( object1->rotation() );
-          _normal1 = box1.normals[box1_i].getRotated( object1->rotation() );
-          _projection1 = _point1 * _normal1;
-          _largest_overlap = std::numeric_limits<float>::max();
-
-          DEBUG_STREAM << "CollisionHandler::collides : Checking Object1, Side " << box1_i << " P = " << _point1 << ", N = " << _normal1;
+          point1 = box1.points[box1_i];
+          normal1 = box1.normals[box1_i];
+          projection1 = point1 * normal1;
 
-          for ( unsigned int box2_i = 0; box2_i < box2.number; ++box2_i )
-          {
-            _point2 = _object_pos2 + box2.points[box2_i].getRotated( object2->rotation() );
-            _diff = (_point2*_normal1) - _projection1;
+          DEBUG_STREAM << "CollisionHandler::detectCollision : Checking Object1, Side " << box1_i << " P = " << point1 << ", N = " << normal1;
 
-            DEBUG_STREAM << "CollisionHandler::collides :   Object2, P = " << _point2 << " - DIFF = " << _diff;
+          // Find the max size of the overlap
+          projectHitBox( packed2[hb2], normal1, min_projection, max_projection );
+          largest_overlap = min_projection - projection1;
 
-            if ( _diff < _largest_overlap ) // Find the max size of the overlap
-            {
-              _largest_overlap = _diff;
-              _overlapping_point = _point2;
-            }
-          }
-
-          DEBUG_STREAM << "CollisionHandler::collides : Checking Object1, Overlap = " << _largest_overlap;
-          if ( _largest_overlap > 0.0 )
+          DEBUG_STREAM << "CollisionHandler::detectCollision : Checking Object1, Overlap = " << largest_overlap;
+          if ( largest_overlap > 0.0 )
           {
             // Separating axis found. We good!
             goto CollidingSeparatingAxisFound;
           }
 
-          if ( _largest_overlap > _contact1.overlap ) // Smallest total overlap is the shortest collision resolution
+          if ( largest_overlap > pair.contact1.overlap ) // Smallest total overlap is the shortest collision resolution
           {
-            _contact1.overlap = _largest_overlap;
-            _contact1.normal = _normal1;
-            _contact1.point = _overlapping_point;
+            pair.contact1.overlap = largest_overlap;
+            pair.contact1.normal = normal1;
+            pair.contact1.point = supportPoint( box2, normal1 );
           }
         }
-        _contact2.overlap = _contact1.overlap;
-        _contact2.normal = -_contact1.normal;
-        _contact2.point = _contact1.point;
+        pair.contact2.overlap = pair.contact1.overlap;
+        pair.contact2.normal = -pair.contact1.normal;
+        pair.contact2.point = pair.contact1.point;
 
-        DEBUG_STREAM << "CollisionHandler::collides : Object1, Overlap = " << _contact1.overlap;
+        DEBUG_STREAM << "CollisionHandler::detectCollision : Object1, Overlap = " << pair.contact1.overlap;
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -319,58 +720,48 @@ namespace Regolith
         for ( unsigned int box2_i = 0; box2_i < box2.number; ++box2_i )
         {
           // Absolute _positions of the hit boxes vertices
-          _point2 = _object_pos2 + box2.points[box2_i].getRotated( object2->rotation() );
-          _normal2 = box2.normals[box2_i].getRotated( object2->rotation() );
-          _projection2 = _point2 * _normal2;
-
-          DEBUG_STREAM << "CollisionHandler::collides : Checking Object2, Side " << box2_i << " P = " << _point2 << ", N = " << _normal2;
+          point2 = box2.points[box2_i];
+          normal2 = box2.normals[box2_i];
+          projection2 = point2 * normal2;
 
-          _largest_overlap = std::numeric_limits<float>::max();
+          DEBUG_STREAM << "CollisionHandler::detectCollision : Checking Object2, Side " << box2_i << " P = " << point2 << ", N = " << normal2;
 
-          for ( unsigned int box1_i = 0; box1_i < box1.number; ++box1_i )
-          {
-            _point1 = _object_pos1 + box1.points[box1_i].getRotated( object1->rotation() );
-            _diff = (_point1*_normal2) - _projection2;
-
-            DEBUG_STREAM << "CollisionHandler::collides :   Object1, P = " << _point1 << " - DIFF = " << _diff;
-
-            if ( _diff < _largest_overlap ) // Find the max size of the overlap
-            {
-              _largest_overlap = _diff;
-              _overlapping_point = _point1;
-            }
-          }
+          // Find the max size of the overlap
+          projectHitBox( packed1[hb1], normal2, min_projection, max_projection );
+          largest_overlap = min_projection - projection2;
 
-          DEBUG_STREAM << "CollisionHandler::collides : Checking Object2, Overlap = " << _largest_overlap;
-          if ( _largest_overlap > 0.0 )
+          DEBUG_STREAM << "CollisionHandler::detectCollision : Checking Object2, Overlap = " << largest_overlap;
+          if ( largest_overlap > 0.0 )
           {
             // Separating axis found. We good!
             goto CollidingSeparatingAxisFound;
           }
 
-          if ( _largest_overlap > _contact2.overlap ) // Smallest total overlap is the shortest collision resolution
+          if ( largest_overlap > pair.contact2.overlap ) // Smallest total overlap is the shortest collision resolution
           {
-            _contact2.overlap = _largest_overlap;
-            _contact2.normal = _normal2;
-            _contact2.point = _overlapping_point;
+            pair.contact2.overlap = largest_overlap;
+            pair.contact2.normal = normal2;
+            pair.contact2.point = supportPoint( box1, normal2 );
           }
         }
-        _contact1.overlap = _contact2.overlap;
-        _contact1.normal = -_contact2.normal;
-        _contact1.point = _contact2.point;
+        pair.contact1.overlap = pair.contact2.overlap;
+        pair.contact1.normal = -pair.contact2.normal;
+        pair.contact1.point = pair.contact2.point;
 
-        DEBUG_STREAM << "CollisionHandler::collides : Object2, Overlap = " << _contact2.overlap;
+        DEBUG_STREAM << "CollisionHandler::detectCollision : Object2, Overlap = " << pair.contact2.overlap;
 
 
 ////////////////////////////////////////////////////////////////////////////////
         // Collision determined
         // Got this far, therefore separating axis not found. Calculate collision parameters
 
-        _contact1.type = col_it1->collisionType;
-        _contact2.type = col_it2->collisionType;
-        DEBUG_STREAM << "CollisionHandler::collides : Collides-Callback Overlap 1 = " << _contact1.overlap <<  " -- Normal 1 = " << _contact1.normal;
-        DEBUG_STREAM << "CollisionHandler::collides : Collides-Callback Overlap 2 = " << _contact2.overlap <<  " -- Normal 2 = " << _contact2.normal;
-        callback( object1, object2 );
+        pair.contact1.type = box1.collisionType;
+        pair.contact2.type = box2.collisionType;
+        pair.hitBox1 = hb1;
+        pair.hitBox2 = hb2;
+        DEBUG_STREAM << "CollisionHandler::detectCollision : Collides-Callback Overlap 1 = " << pair.contact1.overlap <<  " -- Normal 1 = " << pair.contact1.normal;
+        DEBUG_STREAM << "CollisionHandler::detectCollision : Collides-Callback Overlap 2 = " << pair.contact2.overlap <<  " -- Normal 2 = " << pair.contact2.normal;
+        contacts.push_back( pair );
 
 CollidingSeparatingAxisFound:
         // Just loop to the next hit box in the collision. Note the labels refer to a statement, so we need a continue or something
@@ -380,34 +771,45 @@ CollidingSeparatingAxisFound:
   }
 
 
-  void CollisionHandler::contains( CollidableObject* object1, CollidableObject* object2 )
+  void CollisionHandler::detectContainment( CollidableObject* object1, CollidableObject* object2, ContactBuffer& contacts ) const
   {
-    DEBUG_LOG( "CollisionHandler::contains : Starting containment" );
+    DEBUG_LOG( "CollisionHandler::detectContainment : Starting containment" );
 
-    _object_pos1 = object1->position();
-    _object_pos2 = object2->position();
+    // All scratch space is local so that workers can test pairs concurrently.
+    // The world-space hitboxes must already be up to date.
+    Vector point1, point2;
+    Vector normal1;
+    float projection1;
+    float min_projection, max_projection;
+    float largest_overlap;
+    float diff;
 
-    const BoundingBox& boundingBox1 = object1->boundingBox();
-    const BoundingBox& boundingBox2 = object2->boundingBox();
+    ContactPair pair;
+    pair.object1 = object1;
+    pair.object2 = object2;
+
+    const Vector* bounding_points1 = object1->worldBoundingPoints();
+    const Vector* bounding_normals1 = object1->worldBoundingNormals();
+    const Vector* bounding_points2 = object2->worldBoundingPoints();
 
 ////////////////////////////////////////////////////////////////////////////////
     // Bounding box test
     for ( unsigned int b1_i = 0; b1_i < 4; ++b1_i )
     {
       // Absolute _positions of the hit boxes vertices
-      _point1 = _object_pos1 + boundingBox1.points[b1_i].getRotated( object1->rotation() );
-      _normal1 = boundingBox1.normals[b1_i].getRotated( object1->rotation() );
-      _projection1 = _point1 * _normal1;
+      point1 = bounding_points1[b1_i];
+      normal1 = bounding_normals1[b1_i];
+      projection1 = point1 * normal1;
 
-      DEBUG_STREAM << "CollisionHandler::contains : Checking Parent, Side " << b1_i << " P = " << _point1 << ", N = " << _normal1;
+      DEBUG_STREAM << "CollisionHandler::detectContainment : Checking Parent, Side " << b1_i << " P = " << point1 << ", N = " << normal1;
 
       for ( unsigned int b2_i = 0; b2_i < 4; ++b2_i )
       {
-        _point2 = _object_pos2 + boundingBox2.points[b2_i].getRotated( object2->rotation() );
-        _diff = (_point2*_normal1) - _projection1;
-        DEBUG_STREAM << "CollisionHandler::contains : Checking Child " << " P = " << _point2 << " DIFF = " << _diff;
+        point2 = bounding_points2[b2_i];
+        diff = (point2*normal1) - projection1;
+        DEBUG_STREAM << "CollisionHandler::detectContainment : Checking Child " << " P = " << point2 << " DIFF = " << diff;
 
-        if ( _diff > 0.0 ) // Find the max size of the overlap
+        if ( diff > 0.0 ) // Find the max size of the overlap
         {
           goto ContainingHitBoxCollision;
         }
@@ -419,82 +821,126 @@ CollidingSeparatingAxisFound:
 
     // Skipped the continue. Therefore we must check for an overlap
 ContainingHitBoxCollision:
-    DEBUG_LOG( "CollisionHandler::contains : Collision determined" );
-    const Collision& collision2 = object2->getCollision();
+    DEBUG_LOG( "CollisionHandler::detectContainment : Collision determined" );
+    const Collision::HitBoxVector& collision2 = object2->worldHitBoxes();
+    const std::vector< HitBoxSoA >& packed2 = object2->worldPackedHitBoxes();
 
       // Iterate through the hit boxes of the daughter objects
-    for ( Collision::iterator col_it2 = collision2.begin(); col_it2 != collision2.end(); ++col_it2 )
+    for ( size_t hb2 = 0; hb2 < collision2.size(); ++hb2 )
     {
-      const HitBox& box2 = (*col_it2);
-      _contact1.overlap = std::numeric_limits<float>::max();
+      const HitBox& box2 = collision2[hb2];
+      pair.contact1.overlap = std::numeric_limits<float>::max();
 
       for ( unsigned int b1_i = 0; b1_i < 4; ++b1_i )
       {
         // Absolute _positions of the hit box's vertices
-        _point1 = _object_pos1 + boundingBox1.points[b1_i].getRotated( object1->rotation() );
-        _normal1 = -boundingBox1.normals[b1_i].getRotated( object1->rotation() );
-        _projection1 = _point1 * _normal1;
-        _largest_overlap = std::numeric_limits<float>::max();
+        point1 = bounding_points1[b1_i];
+        normal1 = -bounding_normals1[b1_i];
+        projection1 = point1 * normal1;
 
-        DEBUG_STREAM << "CollisionHandler::contains : Checking parent, Side " << b1_i << " P = " << _point1 << ", N = " << _normal1;
+        DEBUG_STREAM << "CollisionHandler::detectContainment : Checking parent, Side " << b1_i << " P = " << point1 << ", N = " << normal1;
 
-        for ( unsigned int box2_i = 0; box2_i < box2.number; ++box2_i )
-        {
-          _point2 = _object_pos2 + box2.points[box2_i].getRotated( object2->rotation() );
-          _diff = (_point2*_normal1) - _projection1;
-
-          DEBUG_STREAM << "CollisionHandler::contains :   Daughter, P = " << _point2 << " - DIFF = " << _diff;
+        // Find the max size of the overlap
+        // Circles and capsules extend by their radius beyond their points
+        projectHitBox( packed2[hb2], normal1, min_projection, max_projection );
+        largest_overlap = min_projection - box2.radius - projection1;
 
-          if ( _diff < _largest_overlap ) // Find the max size of the overlap
-          {
-            _largest_overlap = _diff;
-            _overlapping_point = _point2;
-          }
-        }
-
-        DEBUG_STREAM << "CollisionHandler::contains : Daughter overlap = " << _largest_overlap;
-        if ( _largest_overlap < _contact1.overlap ) // Smallest total overlap is the shortest collision resolution
+        DEBUG_STREAM << "CollisionHandler::detectContainment : Daughter overlap = " << largest_overlap;
+        if ( largest_overlap < pair.contact1.overlap ) // Smallest total overlap is the shortest collision resolution
         {
-          _contact1.overlap = _largest_overlap;
-          _contact1.normal = _normal1;
-          _contact1.point = _overlapping_point;
+          pair.contact1.overlap = largest_overlap;
+          pair.contact1.normal = normal1;
+          pair.contact1.point = supportPoint( box2, normal1 ) - box2.radius*normal1;
         }
       }
 
-      DEBUG_STREAM << "CollisionHandler::contains : Overlap = " << _contact1.overlap << " N = " << _contact1.normal;
+      DEBUG_STREAM << "CollisionHandler::detectContainment : Overlap = " << pair.contact1.overlap << " N = " << pair.contact1.normal;
+
+      if ( pair.contact1.overlap >= 0.0 ) continue;
+
+      pair.contact2.overlap = pair.contact1.overlap;
+      pair.contact2.normal = -pair.contact1.normal;
+      pair.contact2.point = pair.contact1.point;
+
+      pair.hitBox1 = container_hit_box;
+      pair.hitBox2 = hb2;
+      contacts.push_back( pair );
+    }
+  }
+
 
-      if ( _contact1.overlap >= 0.0 ) continue;
+  void CollisionHandler::findIndexedHitBoxes( const CollidableObject* indexed, const CollidableObject* other, std::vector< size_t >& indices ) const
+  {
+    const Vector* points = other->worldBoundingPoints();
+    Vector lower = points[0];
+    Vector upper = points[0];
 
-      _contact2.overlap = _contact1.overlap;
-      _contact2.normal = -_contact1.normal;
-      _contact2.point = _contact1.point;
+    for ( unsigned int i = 1; i < 4; ++i )
+    {
+      lower.x() = std::min( lower.x(), points[i].x() );
+      lower.y() = std::min( lower.y(), points[i].y() );
+      upper.x() = std::max( upper.x(), points[i].x() );
+      upper.y() = std::max( upper.y(), points[i].y() );
+    }
 
-      callback( object1, object2 );
+    indexed->findWorldHitBoxes( lower, upper, indices );
+  }
+
+
+  const Vector& CollisionHandler::supportPoint( const HitBox& box, const Vector& axis ) const
+  {
+    // First vertex with the smallest projection
+    unsigned int support = 0;
+    float min = box.points[0] * axis;
+
+    for ( unsigned int i = 1; i < box.number; ++i )
+    {
+      float projection = box.points[i] * axis;
+      if ( projection < min )
+      {
+        min = projection;
+        support = i;
+      }
     }
+
+    return box.points[support];
   }
 
 
-  void CollisionHandler::callback( CollidableObject* object1, CollidableObject* object2 )
+  void CollisionHandler::resolve( ContactPair& pair )
   {
-    _coef_restitution = 1.0 + 0.5 * ( object1->getElasticity() + object2->getElasticity() );
+    CollidableObject* object1 = pair.object1;
+    CollidableObject* object2 = pair.object2;
 
-    _total_M = object1->getInverseMass() + object2->getInverseMass();
-    _total_L = object1->getInverseInertia() + object2->getInverseInertia();
+    pair.contact1.other = &pair.contact2;
+    pair.contact2.other = &pair.contact1;
 
-    _lever_len_1 = _contact1.normal ^ (_contact1.point - object1->getPosition());
-    _lever_len_2 = _contact2.normal ^ (_contact2.point - object2->getPosition());
+    float coef_restitution = 1.0 + 0.5 * ( object1->getElasticity() + object2->getElasticity() );
 
-    DEBUG_STREAM << "CollisionHandler::callback : Lever Length 1 = " << _lever_len_1;
-    DEBUG_STREAM << "CollisionHandler::callback : Lever Length 2 = " << _lever_len_2;
+    float total_M = object1->getInverseMass() + object2->getInverseMass();
+    float total_L = object1->getInverseInertia() + object2->getInverseInertia();
+
+    float lever_len_1 = pair.contact1.normal ^ (pair.contact1.point - object1->getPosition());
+    float lever_len_2 = pair.contact2.normal ^ (pair.contact2.point - object2->getPosition());
+
+    DEBUG_STREAM << "CollisionHandler::resolve : Lever Length 1 = " << lever_len_1;
+    DEBUG_STREAM << "CollisionHandler::resolve : Lever Length 2 = " << lever_len_2;
 
     // Total impulse based on the relative speed at the point of impact,
-    _total_impulse = _coef_restitution * ( object2->getVelocity()*_contact1.normal +
-                                           object1->getVelocity()*_contact2.normal +
-                                           object1->getAngularVelocity() * _lever_len_1 +
-                                           object2->getAngularVelocity() * _lever_len_2 );
+    float total_impulse = coef_restitution * ( object2->getVelocity()*pair.contact1.normal +
+                                               object1->getVelocity()*pair.contact2.normal +
+                                               object1->getAngularVelocity() * lever_len_1 +
+                                               object2->getAngularVelocity() * lever_len_2 );
 
+    if ( _warmStarting )
+    {
+      // Restitution only applies to objects that are approaching each other
+      if ( total_impulse > 0.0 ) total_impulse /= coef_restitution;
+
+      total_impulse = accumulateImpulse( pair, total_impulse, lever_len_1, lever_len_2 );
+    }
     // If the objects are moving away, don't provide an impulse
-    if ( _total_impulse < 0.0 )
+    else if ( total_impulse < 0.0 )
     {
       float momentum_sink = 0.0;
 
@@ -508,41 +954,243 @@ ContainingHitBoxCollision:
       }
       if ( object1->hasRotation() )
       {
-        momentum_sink += _lever_len_1*_lever_len_1*object1->getInverseInertia();
+        momentum_sink += lever_len_1*lever_len_1*object1->getInverseInertia();
       }
       if ( object2->hasRotation() )
       {
-        momentum_sink += _lever_len_2*_lever_len_2*object2->getInverseInertia();
+        momentum_sink += lever_len_2*lever_len_2*object2->getInverseInertia();
       }
 
       // - weighted by the amount of inertia that can receive the impulse
-      _total_impulse /= momentum_sink;
+      total_impulse /= momentum_sink;
+    }
+    else
+    {
+      total_impulse = 0.0;
+    }
+
+    DEBUG_STREAM << "CollisionHandler::resolve : Total Impulse = " << total_impulse;
+
+    pair.contact1.massRatio = object1->getInverseMass()/total_M;
+    pair.contact2.massRatio = object2->getInverseMass()/total_M;
+    pair.contact1.impulse = object1->getInverseMass() * total_impulse * pair.contact1.normal;
+    pair.contact2.impulse = object2->getInverseMass() * total_impulse * pair.contact2.normal;
+
+
+    pair.contact1.inertiaRatio = object1->getInverseInertia()/total_L;
+    pair.contact2.inertiaRatio = object2->getInverseInertia()/total_L;
+    pair.contact1.angularImpulse = - object1->getInverseInertia() * total_impulse * lever_len_1;
+    pair.contact2.angularImpulse = - object2->getInverseInertia() * total_impulse * lever_len_2;
+
+    DEBUG_STREAM << "CollisionHandler::resolve : Impulse 1 = " << pair.contact1.impulse;
+    DEBUG_STREAM << "CollisionHandler::resolve : Impulse 2 = " << pair.contact2.impulse;
+    DEBUG_STREAM << "CollisionHandler::resolve : Angular Impulse 1 = " << pair.contact1.angularImpulse;
+    DEBUG_STREAM << "CollisionHandler::resolve : Angular Impulse 2 = " << pair.contact2.angularImpulse;
+
+    object1->onCollision( pair.contact1, object2 );
+    object2->onCollision( pair.contact2, object1 );
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Circle and capsule tests
+
+  bool CollisionHandler::collideCircles( const HitBox& box1, const HitBox& box2, Vector& normal, float& overlap, Vector& point ) const
+  {
+    Vector delta = box2.points[0] - box1.points[0];
+    float radii = box1.radius + box2.radius;
+    float distance_square = delta.square();
+
+    if ( distance_square > radii*radii ) return false;
+
+    float distance = std::sqrt( distance_square );
+
+    // Concentric circles can be pushed apart in any direction
+    normal = ( distance > epsilon ) ? delta / distance : unitVector_y;
+    overlap = distance - radii;
+    point = box2.points[0] - box2.radius*normal;
+
+    return true;
+  }
+
+
+  bool CollisionHandler::collideCapsules( const HitBox& box1, const HitBox& box2, Vector& normal, float& overlap, Vector& point ) const
+  {
+    // A circle is a capsule with both ends at the centre
+    Vector closest1, closest2;
+    closestSegmentPoints( box1.points[0], box1.points[box1.number-1], box2.points[0], box2.points[box2.number-1], closest1, closest2 );
+
+    Vector delta = closest2 - closest1;
+    float radii = box1.radius + box2.radius;
+    float distance_square = delta.square();
+
+    if ( distance_square > radii*radii ) return false;
+
+    float distance = std::sqrt( distance_square );
+
+    if ( distance > epsilon )
+    {
+      normal = delta / distance;
     }
     else
     {
-      _total_impulse = 0.0;
+      // The segments cross. Push out along a capsule's normal, facing the other hitbox's centre.
+      normal = ( box1.shape == HitBoxType::Capsule ) ? box1.normals[0] : box2.normals[0];
+      Vector centres = ( box2.points[0] + box2.points[box2.number-1] ) - ( box1.points[0] + box1.points[box1.number-1] );
+      if ( centres * normal < 0.0 ) normal = -normal;
+    }
+
+    overlap = distance - radii;
+    point = closest2 - box2.radius*normal;
+
+    return true;
+  }
+
+
+  bool CollisionHandler::collidePolygonRounded( const HitBox& polygon, const HitBoxSoA& polygon_packed, const HitBox& rounded, const HitBoxSoA& rounded_packed, Vector& normal, float& overlap, Vector& point ) const
+  {
+    float min_projection, max_projection;
+    float polygon_min, polygon_max;
+    float separation;
+
+    overlap = std::numeric_limits<float>::lowest();
+
+    // Polygon edges. The normals face outwards so only one side needs testing.
+    for ( unsigned int i = 0; i < polygon.number; ++i )
+    {
+      const Vector& axis = polygon.normals[i];
+      projectHitBox( rounded_packed, axis, min_projection, max_projection );
+      separation = min_projection - rounded.radius - ( polygon.points[i] * axis );
+
+      if ( separation > 0.0 ) return false;
+
+      if ( separation > overlap )
+      {
+        overlap = separation;
+        normal = axis;
+      }
+    }
+
+    // Remaining candidate axes: the capsule normal and the direction from the nearest polygon vertex to each point
+    // of the rounded hitbox. Together with the polygon edges these are sufficient to separate a convex polygon.
+    Vector axes[3];
+    unsigned int number_axes = 0;
+
+    if ( rounded.shape == HitBoxType::Capsule )
+    {
+      axes[number_axes++] = rounded.normals[0];
     }
 
-    DEBUG_STREAM << "CollisionHandler::callback : Total Impulse = " << _total_impulse;
+    for ( unsigned int r = 0; r < rounded.number; ++r )
+    {
+      const Vector& centre = rounded.points[r];
+      unsigned int nearest = 0;
+      float nearest_square = ( polygon.points[0] - centre ).square();
+      for ( unsigned int i = 1; i < polygon.number; ++i )
+      {
+        float distance_square = ( polygon.points[i] - centre ).square();
+        if ( distance_square < nearest_square )
+        {
+          nearest_square = distance_square;
+          nearest = i;
+        }
+      }
+
+      // A point sitting on the vertex gives no direction. The edges cover it.
+      if ( nearest_square > epsilon )
+      {
+        axes[number_axes++] = ( centre - polygon.points[nearest] ).norm();
+      }
+    }
+
+    for ( unsigned int a = 0; a < number_axes; ++a )
+    {
+      const Vector& axis = axes[a];
+      projectHitBox( polygon_packed, axis, polygon_min, polygon_max );
+      projectHitBox( rounded_packed, axis, min_projection, max_projection );
+
+      // Either direction along the axis may separate them
+      float forward = ( min_projection - rounded.radius ) - polygon_max;
+      float backward = polygon_min - ( max_projection + rounded.radius );
+
+      if ( forward > 0.0 || backward > 0.0 ) return false;
+
+      if ( forward > overlap )
+      {
+        overlap = forward;
+        normal = axis;
+      }
+      if ( backward > overlap )
+      {
+        overlap = backward;
+        normal = -axis;
+      }
+    }
+
+    point = supportPoint( rounded, normal ) - rounded.radius*normal;
+
+    return true;
+  }
 
-    _contact1.massRatio = object1->getInverseMass()/_total_M;
-    _contact2.massRatio = object2->getInverseMass()/_total_M;
-    _contact1.impulse = object1->getInverseMass() * _total_impulse * _contact1.normal;
-    _contact2.impulse = object2->getInverseMass() * _total_impulse * _contact2.normal;
 
+  void closestSegmentPoints( const Vector& start1, const Vector& end1, const Vector& start2, const Vector& end2, Vector& closest1, Vector& closest2 )
+  {
+    Vector direction1 = end1 - start1;
+    Vector direction2 = end2 - start2;
+    Vector offset = start1 - start2;
+
+    float length1 = direction1.square();
+    float length2 = direction2.square();
+    float f = direction2 * offset;
+
+    // Fractions along each segment
+    float s = 0.0;
+    float t = 0.0;
+
+    if ( length1 <= epsilon && length2 <= epsilon )
+    {
+      // Both are points
+    }
+    else if ( length1 <= epsilon )
+    {
+      t = std::min( std::max( f / length2, 0.0f ), 1.0f );
+    }
+    else
+    {
+      float c = direction1 * offset;
+      if ( length2 <= epsilon )
+      {
+        s = std::min( std::max( -c / length1, 0.0f ), 1.0f );
+      }
+      else
+      {
+        float b = direction1 * direction2;
+        float denominator = length1*length2 - b*b;
+
+        // Parallel segments pick any point on the first
+        if ( denominator > epsilon )
+        {
+          s = std::min( std::max( ( b*f - c*length2 ) / denominator, 0.0f ), 1.0f );
+        }
 
-    _contact1.inertiaRatio = object1->getInverseInertia()/_total_L;
-    _contact2.inertiaRatio = object2->getInverseInertia()/_total_L;
-    _contact1.angularImpulse = - object1->getInverseInertia() * _total_impulse * _lever_len_1;
-    _contact2.angularImpulse = - object2->getInverseInertia() * _total_impulse * _lever_len_2;
+        t = ( b*s + f ) / length2;
 
-    DEBUG_STREAM << "CollisionHandler::callback : Impulse 1 = " << _contact1.impulse;
-    DEBUG_STREAM << "CollisionHandler::callback : Impulse 2 = " << _contact2.impulse;
-    DEBUG_STREAM << "CollisionHandler::callback : Angular Impulse 1 = " << _contact1.angularImpulse;
-    DEBUG_STREAM << "CollisionHandler::callback : Angular Impulse 2 = " << _contact2.angularImpulse;
+        // Clamp to the second segment and recalculate the first
+        if ( t < 0.0 )
+        {
+          t = 0.0;
+          s = std::min( std::max( -c / length1, 0.0f ), 1.0f );
+        }
+        else if ( t > 1.0 )
+        {
+          t = 1.0;
+          s = std::min( std::max( ( b - c ) / length1, 0.0f ), 1.0f );
+        }
+      }
+    }
 
-    object1->onCollision( _contact1, object2 );
-    object2->onCollision( _contact2, object1 );
+    closest1 = start1 + s*direction1;
+    closest2 = start2 + t*direction2;
   }
 
 
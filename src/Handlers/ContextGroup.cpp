@@ -10,6 +10,7 @@
 #include "Regolith/Audio/Playlist.h"
 #include "Regolith/GamePlay/Camera.h"
 #include "Regolith/Utilities/JsonValidation.h"
+#include "Regolith/Utilities/JsonCache.h"
 
 
 namespace Regolith
@@ -32,6 +33,7 @@ namespace Regolith
     _loadingState( false ),
     _loadProgress( 0 ),
     _loadTotal( 0 ),
+    _loadAssets( 0 ),
     _loadStatus( "" ),
     _renderPosition( _gameObjects.begin() ),
     _isRendered( false )
@@ -52,6 +54,7 @@ namespace Regolith
   {
     GuardLock lg( _mutexProgress );
     _loadProgress = 0;
+    _loadAssets = 0;
   }
 
 
@@ -79,7 +82,7 @@ namespace Regolith
   float ContextGroup::getLoadProgress() const
   {
     GuardLock lg( _mutexProgress );
-    return (float) _loadProgress / _loadTotal;
+    return (float) _loadProgress / ( _loadTotal + _loadAssets );
   }
 
 
@@ -122,6 +125,9 @@ namespace Regolith
     _fileName = filename;
     _isGlobalGroup = isGlobal;
 
+    // Keep the parsed files for when the group is loaded
+    JsonCache::Scope cache_scope( this );
+
     // Load Json Data
     Json::Value json_data;
     loadJsonData( json_data, _fileName );
@@ -151,6 +157,39 @@ namespace Regolith
 
 
 
+    // Optionally pack the group's small textures into shared atlases when it loads
+    if ( validateJson( json_data, "texture_atlas", JsonType::OBJECT, false ) )
+    {
+      Json::Value& atlas_data = json_data["texture_atlas"];
+      int max_sprite = 256;
+      int atlas_size = 2048;
+      int padding = 1;
+
+      if ( validateJson( atlas_data, "max_sprite_size", JsonType::INTEGER, false ) ) max_sprite = atlas_data["max_sprite_size"].asInt();
+      if ( validateJson( atlas_data, "atlas_size", JsonType::INTEGER, false ) ) atlas_size = atlas_data["atlas_size"].asInt();
+      if ( validateJson( atlas_data, "padding", JsonType::INTEGER, false ) ) padding = atlas_data["padding"].asInt();
+
+      if ( ( max_sprite <= 0 ) || ( atlas_size <= 0 ) || ( padding < 0 ) )
+      {
+        Exception ex( "ContextGroup::configure()", "Invalid texture atlas configuration" );
+        ex.addDetail( "Max sprite size", max_sprite );
+        ex.addDetail( "Atlas size", atlas_size );
+        ex.addDetail( "Padding", padding );
+        throw ex;
+      }
+
+      // A texture can't be larger than the atlas it is packed into
+      if ( max_sprite > atlas_size )
+      {
+        WARN_STREAM << "ContextGroup::configure : Maximum sprite size " << max_sprite << " is larger than the atlas. Using " << atlas_size;
+        max_sprite = atlas_size;
+      }
+
+      _theData.configureAtlases( max_sprite, atlas_size, padding );
+      INFO_STREAM << "ContextGroup::configure : Texture atlases enabled for textures up to " << max_sprite << " pixels";
+    }
+
+
     // If a default playlist is declared, configure it
     if ( validateJson( json_data, "default_playlist", JsonType::STRING, false ) )
     {
@@ -208,21 +247,48 @@ namespace Regolith
 
     DEBUG_LOG( "ContextGroup::load : Loading" );
 
+    // Tag the files so they can be dropped from the cache when the group unloads
+    JsonCache::Scope cache_scope( this );
+
     // Load Json Data
     Json::Value json_data;
     loadJsonData( json_data, _fileName );
     Json::Value& include_files = json_data["include_files"];
 
-
-    DEBUG_LOG( "ContextGroup::load : Loading playlists" );
+    // Each stage reads every include file, so only load them once
+    std::vector< Json::Value > include_data( include_files.size() );
     for ( Json::ArrayIndex i = 0; i != include_files.size(); ++i )
     {
       std::string file_name = include_files[i].asString();
-      Json::Value include_data;
-      INFO_STREAM << "ContextGroup::configure : Loading include file : " << file_name;
+      INFO_STREAM << "ContextGroup::load : Loading include file : " << file_name;
+      loadJsonData( include_data[i], file_name );
+    }
 
-      loadJsonData( include_data, file_name );
-      this->_loadPlaylists( include_data["playlists"] );
+
+    // Find every texture and sound before any objects are built so they can be decoded together
+    DEBUG_LOG( "ContextGroup::load : Planning the assets" );
+    setStatus( "Loading Assets" );
+    for ( Json::ArrayIndex i = 0; i != include_files.size(); ++i )
+    {
+      this->_planAssets( include_data[i]["game_objects"] );
+    }
+    // Plan inline data
+    this->_planAssets( json_data["game_objects"] );
+
+    {
+      GuardLock lg( _mutexProgress );
+      _loadAssets = _theData.getPlanSize();
+    }
+    _theData.loadPlan( [this](){ this->loadElement(); } );
+
+    // Objects must find their textures in the atlases, so pack them before anything is built
+    _theData.packAtlases();
+
+
+    DEBUG_LOG( "ContextGroup::load : Loading playlists" );
+    for ( Json::ArrayIndex i = 0; i != include_files.size(); ++i )
+    {
+      this->_loadPlaylists( include_data[i]["playlists"] );
     }
     // Load inline data
     this->_loadPlaylists( json_data["playlists"] );
@@ -232,12 +298,7 @@ namespace Regolith
     setStatus( "Building Game Objects" );
     for ( Json::ArrayIndex i = 0; i != include_files.size(); ++i )
     {
-      std::string file_name = include_files[i].asString();
-      Json::Value include_data;
-      INFO_STREAM << "ContextGroup::configure : Loading include file : " << file_name;
-
-      loadJsonData( include_data, file_name );
-      this->_loadObjects( include_data["game_objects"] );
+      this->_loadObjects( include_data[i]["game_objects"] );
     }
     // Load inline data
     this->_loadObjects( json_data["game_objects"] );
@@ -247,12 +308,7 @@ namespace Regolith
     setStatus( "Filling Spawn Buffers" );
     for ( Json::ArrayIndex i = 0; i != include_files.size(); ++i )
     {
-      std::string file_name = include_files[i].asString();
-      Json::Value include_data;
-      INFO_STREAM << "ContextGroup::configure : Loading include file : " << file_name;
-
-      loadJsonData( include_data, file_name );
-      this->_loadSpawnBuffers( include_data["spawn_buffers"] );
+      this->_loadSpawnBuffers( include_data[i]["spawn_buffers"] );
     }
     // Load inline data
     this->_loadSpawnBuffers( json_data["spawn_buffers"] );
@@ -262,12 +318,7 @@ namespace Regolith
     setStatus( "Building Levels" );
     for ( Json::ArrayIndex i = 0; i != include_files.size(); ++i )
     {
-      std::string file_name = include_files[i].asString();
-      Json::Value include_data;
-      INFO_STREAM << "ContextGroup::configure : Loading include file : " << file_name;
-
-      loadJsonData( include_data, file_name );
-      this->_loadContexts( include_data["contexts"] );
+      this->_loadContexts( include_data[i]["contexts"] );
     }
     // Load inline data
     this->_loadContexts( json_data["contexts"] );
@@ -323,6 +374,9 @@ namespace Regolith
     INFO_LOG( "ContextGroup::unload : Unloading Data" );
     _theData.clear();
 
+    // The parsed files are only needed again if the group is reloaded
+    JsonCache::getInstance().invalidate( this );
+
     INFO_LOG( "ContextGroup::unload : Unloading Contexts" );
     for ( ContextMap::iterator it = _contexts.begin(); it != _contexts.end(); ++it )
     {
@@ -605,6 +659,50 @@ namespace Regolith
   }
 
 
+  // Search a json object for asset names and add them to the load plan
+  static void planAssetNames( Json::Value& json_data, DataHandler& handler )
+  {
+    for ( Json::Value::iterator it = json_data.begin(); it != json_data.end(); ++it )
+    {
+      if ( it->isObject() || it->isArray() )
+      {
+        planAssetNames( *it, handler );
+      }
+      else if ( json_data.isObject() && it->isString() )
+      {
+        std::string key = it.key().asString();
+        if ( key == "texture_name" )
+        {
+          handler.planRawTexture( it->asString() );
+        }
+        else if ( key == "sound_name" )
+        {
+          handler.planRawSound( it->asString() );
+        }
+      }
+    }
+  }
+
+
+  void ContextGroup::_planAssets( Json::Value& object_data )
+  {
+    for( Json::Value::iterator o_it = object_data.begin(); o_it != object_data.end(); ++o_it )
+    {
+      // Object files are cached, so building the object won't parse them again
+      if ( o_it->isString() )
+      {
+        Json::Value file_data;
+        loadJsonData( file_data, o_it->asString() );
+        planAssetNames( file_data, _theData );
+      }
+      else
+      {
+        planAssetNames( *o_it, _theData );
+      }
+    }
+  }
+
+
   void ContextGroup::_loadPlaylists( Json::Value& json_data )
   {
     _theAudio.load( json_data, _theData );
@@ -2,19 +2,31 @@
 #include "Regolith/Handlers/DataHandler.h"
 #include "Regolith/Managers/Manager.h"
 #include "Regolith/Links/LinkDataManager.h"
+#include "Regolith/Links/LinkThreadManager.h"
+#include "Regolith/Utilities/AtlasPacker.h"
 
 #include <thread>
 #include <chrono>
+#include <vector>
+#include <algorithm>
+#include <exception>
 
 
 namespace Regolith
 {
   DataHandler::DataHandler() :
     _rawTextures(),
+    _privateTextures(),
     _rawSounds(),
     _rawMusic(),
     _rawFonts(),
-    _rawTexts()
+    _rawTexts(),
+    _plannedTextures(),
+    _plannedSounds(),
+    _atlases(),
+    _atlasMaxSprite( 0 ),
+    _atlasSize( 0 ),
+    _atlasPadding( 0 )
   {
   }
 
@@ -24,6 +36,7 @@ namespace Regolith
     INFO_LOG( "Destroying Data Handler" );
 
     _rawTextures.clear();
+    _privateTextures.clear();
     _rawSounds.clear();
     _rawMusic.clear();
     _rawFonts.clear();
@@ -35,18 +48,37 @@ namespace Regolith
   {
     INFO_LOG( "DataHandler::clear : Clearing the Data Handler" );
 
-    RawTextureMap::iterator textures_end = _rawTextures.end();
-    for ( RawTextureMap::iterator it = _rawTextures.begin(); it != textures_end; ++it )
+    _plannedTextures.clear();
+    _plannedSounds.clear();
+
+    // Shared textures are freed by the data manager once no other group uses them
+    RawTexturePointerMap::iterator textures_end = _rawTextures.end();
+    for ( RawTexturePointerMap::iterator it = _rawTextures.begin(); it != textures_end; ++it )
     {
-      std::string name = it->first;
+      if ( _privateTextures.find( it->first ) == _privateTextures.end() )
+      {
+        DEBUG_STREAM << "DataHandler::clear : Released texture: " << it->first;
+        Manager::getInstance()->getDataManager<DataHandler>().releaseRawTexture( it->first );
+      }
+    }
+    _rawTextures.clear();
 
+    for ( RawTextureMap::iterator it = _privateTextures.begin(); it != _privateTextures.end(); ++it )
+    {
       if ( it->second.surface != nullptr )
       {
-        DEBUG_STREAM << "DataHandler::clear : Unloaded texture: " << name << " @ " << it->second.surface;
+        DEBUG_STREAM << "DataHandler::clear : Unloaded texture: " << it->first << " @ " << it->second.surface;
         SDL_FreeSurface( it->second.surface );
-        it->second.surface = nullptr;
       }
     }
+    _privateTextures.clear();
+
+    for ( std::list< RawTexture >::iterator it = _atlases.begin(); it != _atlases.end(); ++it )
+    {
+      DEBUG_STREAM << "DataHandler::clear : Unloaded atlas @ " << it->surface;
+      SDL_FreeSurface( it->surface );
+    }
+    _atlases.clear();
 
     // Nothing to do - font memory is handled by the FontHandler.
     /*
@@ -89,44 +121,39 @@ namespace Regolith
       }
     }
 
-    RawSoundMap::iterator sounds_end = _rawSounds.end();
-    for ( RawSoundMap::iterator it = _rawSounds.begin(); it != sounds_end; ++it )
+    RawSoundPointerMap::iterator sounds_end = _rawSounds.end();
+    for ( RawSoundPointerMap::iterator it = _rawSounds.begin(); it != sounds_end; ++it )
     {
-      std::string name = it->first;
-
-      if ( it->second.sound != nullptr )
-      {
-        DEBUG_STREAM << "DataHandler::clear : Unloaded sound: " << name << " @ " << it->second.sound;
-        Mix_FreeChunk( it->second.sound );
-        it->second.sound = nullptr;
-      }
+      DEBUG_STREAM << "DataHandler::clear : Released sound: " << it->first;
+      Manager::getInstance()->getDataManager<DataHandler>().releaseRawSound( it->first );
     }
+    _rawSounds.clear();
   }
 
 
   RawTexture* DataHandler::getRawTexture( std::string name )
   {
-    RawTextureMap::iterator found = _rawTextures.find( name );
+    RawTexturePointerMap::iterator found = _rawTextures.find( name );
     if ( found == _rawTextures.end() )
     {
-      RawTexture new_texture = Manager::getInstance()->getDataManager<DataHandler>().buildRawTexture( name );
+      RawTexture* new_texture = Manager::getInstance()->getDataManager<DataHandler>().acquireRawTexture( name );
       found = _rawTextures.insert( std::make_pair( name, new_texture ) ).first;
     }
 
-    return &(found->second);
+    return found->second;
   }
 
 
   RawSound* DataHandler::getRawSound( std::string name )
   {
-    RawSoundMap::iterator found = _rawSounds.find( name );
+    RawSoundPointerMap::iterator found = _rawSounds.find( name );
     if ( found == _rawSounds.end() )
     {
-      RawSound new_sound = Manager::getInstance()->getDataManager<DataHandler>().buildRawSound( name );
+      RawSound* new_sound = Manager::getInstance()->getDataManager<DataHandler>().acquireRawSound( name );
       found = _rawSounds.insert( std::make_pair( name, new_sound ) ).first;
     }
 
-    return &(found->second);
+    return found->second;
   }
 
 
@@ -168,5 +195,250 @@ namespace Regolith
     return &(found->second);
   }
 
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Load planning
+
+  void DataHandler::planRawTexture( std::string name )
+  {
+    // Only the atlas needs decoding for images packed into one
+    const Asset& asset = Manager::getInstance()->getDataManager<DataHandler>().getAsset( name );
+    if ( asset.type == ASSET_IMAGE && ! asset.imageDetail.atlas.empty() )
+    {
+      name = asset.imageDetail.atlas;
+    }
+
+    if ( _rawTextures.find( name ) == _rawTextures.end() )
+    {
+      _plannedTextures.insert( name );
+    }
+  }
+
+
+  void DataHandler::planRawSound( std::string name )
+  {
+    if ( _rawSounds.find( name ) == _rawSounds.end() )
+    {
+      _plannedSounds.insert( name );
+    }
+  }
+
+
+  unsigned int DataHandler::getPlanSize() const
+  {
+    return _plannedTextures.size() + _plannedSounds.size();
+  }
+
+
+  void DataHandler::loadPlan( std::function< void() > progress )
+  {
+    std::vector< std::string > texture_names;
+    std::vector< std::string > sound_names;
+
+    // Assets another group has already decoded are shared straight away
+    for ( std::set< std::string >::iterator it = _plannedTextures.begin(); it != _plannedTextures.end(); ++it )
+    {
+      if ( Manager::getInstance()->getDataManager<DataHandler>().hasRawTexture( *it ) )
+      {
+        getRawTexture( *it );
+        progress();
+      }
+      else
+      {
+        texture_names.push_back( *it );
+      }
+    }
+
+    for ( std::set< std::string >::iterator it = _plannedSounds.begin(); it != _plannedSounds.end(); ++it )
+    {
+      if ( Manager::getInstance()->getDataManager<DataHandler>().hasRawSound( *it ) )
+      {
+        getRawSound( *it );
+        progress();
+      }
+      else
+      {
+        sound_names.push_back( *it );
+      }
+    }
+
+    _plannedTextures.clear();
+    _plannedSounds.clear();
+
+    size_t number_textures = texture_names.size();
+    size_t total = number_textures + sound_names.size();
+    if ( total == 0 ) return;
+
+    INFO_STREAM << "DataHandler::loadPlan : Decoding " << number_textures << " textures and " << sound_names.size() << " sounds";
+
+    // Every job writes to its own slot so the maps are only modified by this thread
+    std::vector< RawTexture > textures( number_textures, RawTexture() );
+    std::vector< RawSound > sounds( sound_names.size(), RawSound() );
+
+    std::exception_ptr exception;
+    try
+    {
+      Manager::getInstance()->getThreadManager<DataHandler>().jobScheduler().parallelFor( total, 1, [&]( size_t start, size_t end )
+      {
+        for ( size_t i = start; i < end; ++i )
+        {
+          if ( i < number_textures )
+          {
+            textures[i] = Manager::getInstance()->getDataManager<DataHandler>().buildRawTexture( texture_names[i] );
+          }
+          else
+          {
+            sounds[i - number_textures] = Manager::getInstance()->getDataManager<DataHandler>().buildRawSound( sound_names[i - number_textures] );
+          }
+          progress();
+        }
+      } );
+    }
+    catch ( ... )
+    {
+      exception = std::current_exception();
+    }
+
+    // Share everything that was decoded, even after a failure, so that clear() releases it
+    for ( size_t i = 0; i < number_textures; ++i )
+    {
+      if ( textures[i].surface != nullptr )
+      {
+        RawTexture* shared = Manager::getInstance()->getDataManager<DataHandler>().acquireRawTexture( texture_names[i], textures[i] );
+        _rawTextures.insert( std::make_pair( texture_names[i], shared ) );
+      }
+    }
+
+    for ( size_t i = 0; i < sound_names.size(); ++i )
+    {
+      if ( sounds[i].sound != nullptr )
+      {
+        RawSound* shared = Manager::getInstance()->getDataManager<DataHandler>().acquireRawSound( sound_names[i], sounds[i] );
+        _rawSounds.insert( std::make_pair( sound_names[i], shared ) );
+      }
+    }
+
+    if ( exception ) std::rethrow_exception( exception );
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Runtime atlases
+
+  void DataHandler::configureAtlases( int max_sprite, int atlas_size, int padding )
+  {
+    _atlasMaxSprite = max_sprite;
+    _atlasSize = atlas_size;
+    _atlasPadding = padding;
+  }
+
+
+  void DataHandler::packAtlases()
+  {
+    if ( _atlasMaxSprite <= 0 ) return;
+
+    // Only whole, unrendered textures can be moved into an atlas
+    std::vector< RawTexturePointerMap::iterator > small_textures;
+    for ( RawTexturePointerMap::iterator it = _rawTextures.begin(); it != _rawTextures.end(); ++it )
+    {
+      RawTexture* texture = it->second;
+      if ( texture->surface != nullptr && texture->atlas == nullptr && texture->sdl_texture == nullptr &&
+           texture->surface->w <= _atlasMaxSprite && texture->surface->h <= _atlasMaxSprite )
+      {
+        small_textures.push_back( it );
+      }
+    }
+    if ( small_textures.size() < 2 ) return;
+
+    // Packing changes the texture, so take ownership of those that no other group is using. Cooked atlases are never moved
+    std::vector< RawTexture* > candidates;
+    for ( std::vector< RawTexturePointerMap::iterator >::iterator it = small_textures.begin(); it != small_textures.end(); ++it )
+    {
+      const std::string& name = (*it)->first;
+      if ( _privateTextures.find( name ) == _privateTextures.end() )
+      {
+        RawTexture detached;
+        if ( ! Manager::getInstance()->getDataManager<DataHandler>().detachRawTexture( name, detached ) ) continue;
+
+        (*it)->second = &_privateTextures.insert( std::make_pair( name, detached ) ).first->second;
+      }
+      candidates.push_back( (*it)->second );
+    }
+    if ( candidates.size() < 2 ) return;
+
+    std::sort( candidates.begin(), candidates.end(), []( RawTexture* a, RawTexture* b )
+    {
+      if ( a->surface->h != b->surface->h ) return a->surface->h > b->surface->h;
+      return a->surface->w > b->surface->w;
+    } );
+
+    // Place each texture on the first page with room for it
+    std::vector< AtlasPacker > pages;
+    std::vector< std::vector< std::pair< RawTexture*, SDL_Point > > > contents;
+    for ( std::vector< RawTexture* >::iterator it = candidates.begin(); it != candidates.end(); ++it )
+    {
+      SDL_Point position;
+      size_t page = 0;
+      while ( page < pages.size() && ! pages[page].insert( (*it)->surface->w, (*it)->surface->h, position ) ) ++page;
+
+      if ( page == pages.size() )
+      {
+        pages.push_back( AtlasPacker( _atlasSize, _atlasSize, _atlasPadding ) );
+        contents.push_back( std::vector< std::pair< RawTexture*, SDL_Point > >() );
+        if ( ! pages.back().insert( (*it)->surface->w, (*it)->surface->h, position ) ) continue;
+      }
+
+      contents[page].push_back( std::make_pair( *it, position ) );
+    }
+
+    for ( size_t page = 0; page < pages.size(); ++page )
+    {
+      // A page holding a single texture saves nothing
+      if ( contents[page].size() < 2 ) continue;
+
+      SDL_Surface* surface = SDL_CreateRGBSurface( 0, pages[page].getWidth(), pages[page].getUsedHeight(), REGOLITH_PIXEL_DEPTH, REGOLITH_R_MASK, REGOLITH_G_MASK, REGOLITH_B_MASK, REGOLITH_A_MASK );
+      if ( surface == nullptr )
+      {
+        Exception ex( "DataHandler::packAtlases()", "Could not create atlas surface." );
+        ex.addDetail( "Width", pages[page].getWidth() );
+        ex.addDetail( "Height", pages[page].getUsedHeight() );
+        ex.addDetail( "SDL Error", SDL_GetError() );
+        throw ex;
+      }
+      SDL_FillRect( surface, nullptr, 0 );
+
+      RawTexture atlas;
+      atlas.sdl_texture = nullptr;
+      atlas.surface = surface;
+      atlas.width = surface->w;
+      atlas.height = surface->h;
+      atlas.rows = 1;
+      atlas.columns = 1;
+      atlas.cells = 1;
+      atlas.x = 0;
+      atlas.y = 0;
+      atlas.atlas = nullptr;
+      _atlases.push_back( atlas );
+
+      for ( std::vector< std::pair< RawTexture*, SDL_Point > >::iterator it = contents[page].begin(); it != contents[page].end(); ++it )
+      {
+        RawTexture* texture = it->first;
+        SDL_Rect destination = { it->second.x, it->second.y, texture->surface->w, texture->surface->h };
+
+        // Copy the alpha channel exactly. Colour keyed pixels are skipped, leaving them transparent
+        SDL_SetSurfaceBlendMode( texture->surface, SDL_BLENDMODE_NONE );
+        SDL_BlitSurface( texture->surface, nullptr, surface, &destination );
+
+        SDL_FreeSurface( texture->surface );
+        texture->surface = nullptr;
+        texture->atlas = &_atlases.back();
+        texture->x = it->second.x;
+        texture->y = it->second.y;
+      }
+
+      INFO_STREAM << "DataHandler::packAtlases : Packed " << contents[page].size() << " textures into a " << surface->w << "x" << surface->h << " atlas";
+    }
+  }
+
 }
 
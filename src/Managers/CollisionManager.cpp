@@ -1,13 +1,16 @@
 
 #include "Regolith/Managers/CollisionManager.h"
 
+#include <set>
+
 
 namespace Regolith
 {
 
   CollisionManager::CollisionManager() :
     _teamNames(),
-    _typeNames()
+    _typeNames(),
+    _teamIndices()
   {
   }
 
@@ -22,14 +25,24 @@ namespace Regolith
   {
     INFO_LOG( "CollisionManager::configure : Configuring global collision information" );
 
+    // Teams are numbered in the order of their ids, so that the layers still draw them in that order
     Json::Value& team_data = json_data["collision_teams"];
+    std::set< int > team_ids;
+    for ( Json::Value::const_iterator it = team_data.begin(); it != team_data.end(); ++it )
+    {
+      team_ids.insert( it->asInt() );
+    }
+    for ( std::set< int >::iterator it = team_ids.begin(); it != team_ids.end(); ++it )
+    {
+      findTeamIndex( *it );
+    }
+
     for ( Json::Value::const_iterator it = team_data.begin(); it != team_data.end(); ++it )
     {
       std::string team_name = it.key().asString();
-      CollisionTeam id = (CollisionTeam) it->asInt();
-      _teamNames[ team_name ] = id;
+      _teamNames[ team_name ] = findTeamIndex( it->asInt() );
     }
-    INFO_STREAM << "CollisionManager::configure : Created " << _teamNames.size() << " collision teams.";
+    INFO_STREAM << "CollisionManager::configure : Created " << _teamNames.size() << " collision teams with " << _teamIndices.size() << " unique ids.";
 
     Json::Value& type_data = json_data["collision_types"];
     for ( Json::Value::const_iterator it = type_data.begin(); it != type_data.end(); ++it )
@@ -46,6 +59,20 @@ namespace Regolith
   {
     _teamNames.clear();
     _typeNames.clear();
+    _teamIndices.clear();
+  }
+
+
+  CollisionTeam CollisionManager::findTeamIndex( int id )
+  {
+    std::map< int, CollisionTeam >::iterator found = _teamIndices.find( id );
+    if ( found == _teamIndices.end() )
+    {
+      CollisionTeam index = _teamIndices.size();
+      _teamIndices[ id ] = index;
+      return index;
+    }
+    return found->second;
   }
 
 
@@ -4,6 +4,7 @@
 #include "Regolith/Handlers/ThreadHandler.h"
 #include "Regolith/Links/LinkThreadManager.h"
 #include "Regolith/Links/LinkContextManager.h"
+#include "Regolith/Links/LinkEngineManager.h"
 #include "Regolith/Utilities/JsonValidation.h"
 
 
@@ -289,6 +290,9 @@ namespace Regolith
     // Set the pointer
     _renderContextGroup.data = context_group;
 
+    // The rendering thread sleeps between frames while it has nothing to do
+    Manager::getInstance()->getEngineManager<ContextManager>().wakeRenderingThread();
+
     // Wait for group to be come rendered.
     _renderContextGroup.variable.wait( pointer_lock, [&]()->bool{ return _renderContextGroup.data->isRendered() || ThreadManager::ErrorFlag; } );
 
@@ -300,7 +304,7 @@ namespace Regolith
   }
 
 
-  void ContextManager::renderContextGroup( Camera& camera )
+  bool ContextManager::renderContextGroup( Camera& camera )
   {
     GuardLock lg( _renderContextGroup.mutex );
     if ( _renderContextGroup.data != nullptr )
@@ -308,8 +312,11 @@ namespace Regolith
       if ( _renderContextGroup.data->engineRenderLoadedObjects( camera ) )
       {
         _renderContextGroup.variable.notify_all();
+        return false;
       }
+      return true;
     }
+    return false;
   }
 
 
@@ -20,7 +20,12 @@ namespace Regolith
 
   DataManager::DataManager() :
     _indexFile(),
-    _assets()
+    _assets(),
+    _archive(),
+    _atlasNames(),
+    _sharedTextures(),
+    _sharedSounds(),
+    _cacheMutex()
   {
   }
 
@@ -34,6 +39,43 @@ namespace Regolith
   void DataManager::clear()
   {
     INFO_LOG( "DataManager::clear : Clearing Data Manager." );
+
+    GuardLock lock( _cacheMutex );
+
+    // Anything left is still held by a handler that was never cleared
+    for ( SharedTextureMap::iterator it = _sharedTextures.begin(); it != _sharedTextures.end(); ++it )
+    {
+      WARN_STREAM << "DataManager::clear : Texture still in use: " << it->first << ", references: " << it->second.references;
+      if ( it->second.raw.surface != nullptr )
+      {
+        SDL_FreeSurface( it->second.raw.surface );
+      }
+    }
+    _sharedTextures.clear();
+
+    for ( SharedSoundMap::iterator it = _sharedSounds.begin(); it != _sharedSounds.end(); ++it )
+    {
+      WARN_STREAM << "DataManager::clear : Sound still in use: " << it->first << ", references: " << it->second.references;
+      if ( it->second.raw.sound != nullptr )
+      {
+        Mix_FreeChunk( it->second.raw.sound );
+      }
+    }
+    _sharedSounds.clear();
+  }
+
+
+  SDL_RWops* DataManager::openFile( const std::string& filename ) const
+  {
+    SDL_RWops* file = _archive.openEntry( filename );
+
+    // Loose files are still used for anything that isn't packed, e.g. during development
+    if ( file == nullptr )
+    {
+      file = SDL_RWFromFile( filename.c_str(), "rb" );
+    }
+
+    return file;
   }
 
 
@@ -64,7 +106,12 @@ namespace Regolith
     {
       case ASSET_IMAGE :
         DEBUG_STREAM << "DataManager::buildRawTexture : Building " << name;
-        return loadRawTexture( asset_found->second.imageDetail );
+        // Images packed into an atlas have no file of their own
+        if ( ! asset_found->second.imageDetail.atlas.empty() )
+        {
+          return loadRawTexture( asset_found->second.imageDetail, nullptr );
+        }
+        return loadRawTexture( asset_found->second.imageDetail, openFile( asset_found->second.imageDetail.filename ) );
         break;
 
       default :
@@ -91,7 +138,7 @@ namespace Regolith
     switch ( asset_found->second.type )
     {
       case ASSET_AUDIO :
-        return loadRawMusic( asset_found->second.audioDetail );
+        return loadRawMusic( asset_found->second.audioDetail, openFile( asset_found->second.audioDetail.filename ) );
         break;
 
       default :
@@ -118,7 +165,7 @@ namespace Regolith
     switch ( asset_found->second.type )
     {
       case ASSET_AUDIO :
-        return loadRawSound( asset_found->second.audioDetail );
+        return loadRawSound( asset_found->second.audioDetail, openFile( asset_found->second.audioDetail.filename ) );
         break;
 
       default :
@@ -172,7 +219,7 @@ namespace Regolith
     switch ( asset_found->second.type )
     {
       case ASSET_TEXT :
-        return loadRawText( asset_found->second.textDetail );
+        return loadRawText( asset_found->second.textDetail, openFile( asset_found->second.textDetail.filename ) );
         break;
 
       default :
@@ -186,6 +233,178 @@ namespace Regolith
   }
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Shared cache
+
+  bool DataManager::hasRawTexture( std::string name ) const
+  {
+    GuardLock lock( _cacheMutex );
+    return _sharedTextures.find( name ) != _sharedTextures.end();
+  }
+
+
+  RawTexture* DataManager::acquireRawTexture( std::string name )
+  {
+    {
+      GuardLock lock( _cacheMutex );
+      SharedTextureMap::iterator found = _sharedTextures.find( name );
+      if ( found != _sharedTextures.end() )
+      {
+        ++found->second.references;
+        return &found->second.raw;
+      }
+    }
+
+    // Decode without holding the lock
+    return acquireRawTexture( name, buildRawTexture( name ) );
+  }
+
+
+  RawTexture* DataManager::acquireRawTexture( std::string name, RawTexture texture )
+  {
+    // Images packed into an atlas keep the atlas resident
+    const Asset& asset = getAsset( name );
+    std::string atlas_name = ( asset.type == ASSET_IMAGE ) ? asset.imageDetail.atlas : "";
+    if ( ! atlas_name.empty() )
+    {
+      texture.atlas = acquireRawTexture( atlas_name );
+    }
+
+    RawTexture* shared;
+    bool duplicate;
+    {
+      GuardLock lock( _cacheMutex );
+      std::pair< SharedTextureMap::iterator, bool > result = _sharedTextures.insert( std::make_pair( name, SharedAsset< RawTexture >( { texture, 0 } ) ) );
+      ++result.first->second.references;
+      shared = &result.first->second.raw;
+      duplicate = ! result.second;
+    }
+
+    // Another handler decoded it at the same time
+    if ( duplicate )
+    {
+      if ( texture.surface != nullptr ) SDL_FreeSurface( texture.surface );
+      if ( texture.atlas != nullptr ) releaseRawTexture( atlas_name );
+    }
+    else
+    {
+      DEBUG_STREAM << "DataManager::acquireRawTexture : Cached " << name;
+    }
+
+    return shared;
+  }
+
+
+  void DataManager::releaseRawTexture( std::string name )
+  {
+    std::string atlas;
+    {
+      GuardLock lock( _cacheMutex );
+      SharedTextureMap::iterator found = _sharedTextures.find( name );
+      if ( found == _sharedTextures.end() )
+      {
+        WARN_STREAM << "DataManager::releaseRawTexture : Texture is not cached: " << name;
+        return;
+      }
+
+      if ( --found->second.references > 0 ) return;
+
+      DEBUG_STREAM << "DataManager::releaseRawTexture : Unloaded texture: " << name << " @ " << found->second.raw.surface;
+      if ( found->second.raw.surface != nullptr )
+      {
+        SDL_FreeSurface( found->second.raw.surface );
+      }
+      if ( found->second.raw.atlas != nullptr )
+      {
+        atlas = getAsset( name ).imageDetail.atlas;
+      }
+      _sharedTextures.erase( found );
+    }
+
+    if ( ! atlas.empty() )
+    {
+      releaseRawTexture( atlas );
+    }
+  }
+
+
+  bool DataManager::detachRawTexture( std::string name, RawTexture& texture )
+  {
+    GuardLock lock( _cacheMutex );
+    SharedTextureMap::iterator found = _sharedTextures.find( name );
+
+    if ( found == _sharedTextures.end() || found->second.references != 1 || found->second.raw.atlas != nullptr || _atlasNames.count( name ) != 0 )
+    {
+      return false;
+    }
+
+    texture = found->second.raw;
+    _sharedTextures.erase( found );
+    return true;
+  }
+
+
+  bool DataManager::hasRawSound( std::string name ) const
+  {
+    GuardLock lock( _cacheMutex );
+    return _sharedSounds.find( name ) != _sharedSounds.end();
+  }
+
+
+  RawSound* DataManager::acquireRawSound( std::string name )
+  {
+    {
+      GuardLock lock( _cacheMutex );
+      SharedSoundMap::iterator found = _sharedSounds.find( name );
+      if ( found != _sharedSounds.end() )
+      {
+        ++found->second.references;
+        return &found->second.raw;
+      }
+    }
+
+    // Decode without holding the lock
+    return acquireRawSound( name, buildRawSound( name ) );
+  }
+
+
+  RawSound* DataManager::acquireRawSound( std::string name, RawSound sound )
+  {
+    GuardLock lock( _cacheMutex );
+    std::pair< SharedSoundMap::iterator, bool > result = _sharedSounds.insert( std::make_pair( name, SharedAsset< RawSound >( { sound, 0 } ) ) );
+    ++result.first->second.references;
+
+    // Another handler decoded it at the same time
+    if ( ! result.second && sound.sound != nullptr )
+    {
+      Mix_FreeChunk( sound.sound );
+    }
+
+    return &result.first->second.raw;
+  }
+
+
+  void DataManager::releaseRawSound( std::string name )
+  {
+    GuardLock lock( _cacheMutex );
+    SharedSoundMap::iterator found = _sharedSounds.find( name );
+    if ( found == _sharedSounds.end() )
+    {
+      WARN_STREAM << "DataManager::releaseRawSound : Sound is not cached: " << name;
+      return;
+    }
+
+    if ( --found->second.references > 0 ) return;
+
+    DEBUG_STREAM << "DataManager::releaseRawSound : Unloaded sound: " << name << " @ " << found->second.raw.sound;
+    if ( found->second.raw.sound != nullptr )
+    {
+      Mix_FreeChunk( found->second.raw.sound );
+    }
+    _sharedSounds.erase( found );
+  }
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
   // Configure
 
@@ -199,6 +418,12 @@ namespace Regolith
     // Find the texture index file
     _indexFile = json_data["resource_index_file"].asString();
 
+    // Map the asset archive if one is provided
+    if ( validateJson( json_data, "resource_archive_file", JsonType::STRING, false ) )
+    {
+      _archive.open( json_data["resource_archive_file"].asString() );
+    }
+
     // Load and validate the index file
     Json::Value index_data;
     loadJsonData( index_data, _indexFile );
@@ -244,6 +469,22 @@ namespace Regolith
       {
         detail.colourkey = { 0, 0, 0, 0 };
       }
+
+      // Details written by the asset cooker
+      detail.cooked = data.isMember( "cooked" ) && data["cooked"].asBool();
+      if ( data.isMember( "atlas" ) )
+      {
+        detail.atlas = data["atlas"].asString();
+        detail.x = data["x"].asInt();
+        detail.y = data["y"].asInt();
+        _atlasNames.insert( detail.atlas );
+      }
+      else
+      {
+        detail.atlas = "";
+        detail.x = 0;
+        detail.y = 0;
+      }
       _assets.insert( std::make_pair( name, Asset( detail ) ) );
       DEBUG_STREAM << "DataManager::configure : Asset Texture: " << name;
     }
@@ -4,11 +4,15 @@
 #include "Regolith/Links/LinkWindowManager.h"
 #include "Regolith/Links/LinkInputManager.h"
 #include "Regolith/Links/LinkContextManager.h"
+#include "Regolith/Links/LinkThreadManager.h"
 #include "Regolith/Managers/Manager.h"
 #include "Regolith/Handlers/DataHandler.h"
 #include "Regolith/Handlers/ThreadHandler.h"
 #include "Regolith/Handlers/ContextGroup.h"
 #include "Regolith/Contexts/Context.h"
+#include "Regolith/Utilities/JsonValidation.h"
+
+#include <cmath>
 
 
 namespace Regolith
@@ -28,6 +32,13 @@ namespace Regolith
     _openContextGroup( nullptr ),
     _currentContextGroup( nullptr ),
     _frameTimer(),
+    _fixedTimestep( false ),
+    _timestep( 1000.0 / 120.0 ),
+    _maxSteps( 5 ),
+    _accumulator( 0.0 ),
+    _interpolation( 1.0 ),
+    _renderQueue(),
+    _framePacer(),
     _pause( true )
   {
   }
@@ -37,13 +48,83 @@ namespace Regolith
   {
   }
 
+
+  void EngineManager::configure( Json::Value& json_data )
+  {
+    if ( validateJson( json_data, "fixed_timestep", JsonType::BOOLEAN, false ) )
+    {
+      _fixedTimestep = json_data["fixed_timestep"].asBool();
+    }
+
+    if ( validateJson( json_data, "physics_rate", JsonType::FLOAT, false ) )
+    {
+      float rate = json_data["physics_rate"].asFloat();
+      if ( rate <= 0.0 )
+      {
+        Exception ex( "EngineManager::configure()", "Physics rate must be positive" );
+        ex.addDetail( "Rate", rate );
+        throw ex;
+      }
+      _timestep = 1000.0 / rate;
+    }
+
+    if ( validateJson( json_data, "max_steps_per_frame", JsonType::INTEGER, false ) )
+    {
+      int max_steps = json_data["max_steps_per_frame"].asInt();
+      if ( max_steps <= 0 )
+      {
+        Exception ex( "EngineManager::configure()", "Maximum steps per frame must be positive" );
+        ex.addDetail( "Steps", max_steps );
+        throw ex;
+      }
+      _maxSteps = max_steps;
+    }
+
+    if ( _fixedTimestep )
+    {
+      INFO_STREAM << "EngineManager::configure : Fixed time step of " << _timestep << " ms, at most " << _maxSteps << " steps per frame";
+    }
+
+    float target_fps = 0.0;
+    float spin_time = 1.0;
+
+    if ( validateJson( json_data, "target_fps", JsonType::FLOAT, false ) )
+    {
+      target_fps = json_data["target_fps"].asFloat();
+      if ( target_fps < 0.0 )
+      {
+        Exception ex( "EngineManager::configure()", "Target frame rate cannot be negative" );
+        ex.addDetail( "Rate", target_fps );
+        throw ex;
+      }
+      INFO_STREAM << "EngineManager::configure : Target frame rate of " << target_fps << " fps";
+    }
+
+    if ( validateJson( json_data, "spin_time", JsonType::FLOAT, false ) )
+    {
+      spin_time = json_data["spin_time"].asFloat();
+      if ( spin_time < 0.0 )
+      {
+        Exception ex( "EngineManager::configure()", "Spin time cannot be negative" );
+        ex.addDetail( "Time", spin_time );
+        throw ex;
+      }
+    }
+
+    _framePacer.configure( target_fps, spin_time );
+
+    // Make sure the threads waiting on the pacer see the quit and error flags
+    Manager::getInstance()->getThreadManager<EngineManager>().registerCondition( _framePacer.getCondition() );
+  }
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
   // Running control functions
 
   void EngineManager::run()
   {
-    // Reset the flags
+    // Reset the flags and release the rendering thread from the loading loop
     _pause = false;
+    _framePacer.wake();
 
     // Synchronise access to the contexts
     std::unique_lock<std::mutex> renderLock( _renderMutex );
@@ -61,6 +142,8 @@ namespace Regolith
       // Reset the frame timer before the loop starts
       _frameTimer.lap();
       _frameTimer.resetFPSCount();
+      _framePacer.start();
+      _accumulator = 0.0;
 
       while ( performStackOperations() )
       {
@@ -70,6 +153,9 @@ namespace Regolith
         // Release the context stack
         renderLock.unlock();
 
+        // Sleep until the next frame is due
+        _framePacer.waitForFrame();
+
 
         DEBUG_LOG( "EngineManager::run : ------ EVENTS   ------" );
         // Handle events globally and context-specific actions using the contexts input handler
@@ -78,41 +164,60 @@ namespace Regolith
 
         // Stop updating things while we're paused
         // Doesn't block the rendering thread so we can still load stuff and draw the window.
-        while ( _pause )
+        if ( _pause )
         {
-          // Put it to sleep. No point doing nothing really fast!
-          std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+          while ( _pause && ! ThreadManager::QuitFlag )
+          {
+            // Sleep until there is an event. Still wake periodically to see the quit flag
+            inputManager.waitEvents( 100 );
 
-          // Handler global events without a context. Required to be able to leave the pause state.
-          inputManager.handleEvents( nullptr );
+            // Handler global events without a context. Required to be able to leave the pause state.
+            inputManager.handleEvents( nullptr );
+          }
 
-          // Reset the timer while paused
+          // Reset the timers while paused
           _frameTimer.lap();
+          _framePacer.start();
         }
 
 
-        // Lock access to the context stack for updating
-#ifdef REGOLITH_VALGRIND_BUILD
-        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        // Lock access to the context stack for updating.
+        // The rendering thread only holds it to upload new textures, so block rather than spin.
         renderLock.lock();
-#else
-        while( ! renderLock.try_lock() );
-#endif
 
         DEBUG_LOG( "EngineManager::run : ------ CONTEXTS ------" );
-        float time = _frameTimer.lap(); // Only conversion from int to float happens here.
+        float time = _frameTimer.lap();
 
-        // Iterate through all the visible contexts and update as necessary
-        for ( ContextStack::reverse_iterator context_it = _visibleStackStart; context_it != _visibleStackEnd; ++context_it )
+        if ( _fixedTimestep )
         {
-          Context* this_context = (*context_it);
-          if ( ! this_context->isPaused() )
+          // Simulate in whole steps and leave the remainder for the next frame
+          _accumulator += time;
+
+          unsigned int steps = 0;
+          while ( _accumulator >= _timestep && steps < _maxSteps )
+          {
+            updateContexts( _timestep );
+            _accumulator -= _timestep;
+            ++steps;
+          }
+
+          // Too far behind to catch up. Drop whole steps so a slow frame can't cause a spiral of ever longer frames
+          if ( _accumulator >= _timestep )
           {
-            this_context->update( time );
-//            this_context->step( time );
-//            this_context->resolveCollisions();
+            DEBUG_STREAM << "EngineManager::run : Dropping " << std::floor( _accumulator / _timestep ) << " steps";
+            _accumulator = std::fmod( _accumulator, _timestep );
           }
+
+          _interpolation = _accumulator / _timestep;
+        }
+        else
+        {
+          updateContexts( time );
+          _interpolation = 1.0;
         }
+
+        // Hand the frame to the rendering thread. It draws while the next update runs
+        recordContexts();
       }
 
       // Release the context stack
@@ -141,6 +246,44 @@ namespace Regolith
   }
 
 
+  void EngineManager::updateContexts( float time )
+  {
+    // Iterate through all the visible contexts and update as necessary
+    for ( ContextStack::reverse_iterator context_it = _visibleStackStart; context_it != _visibleStackEnd; ++context_it )
+    {
+      Context* this_context = (*context_it);
+      if ( ! this_context->isPaused() )
+      {
+        this_context->update( time );
+      }
+    }
+  }
+
+
+  void EngineManager::recordContexts()
+  {
+    _renderQueue.startRecording( _interpolation );
+
+    for ( ContextStack::reverse_iterator context_it = _visibleStackStart; context_it != _visibleStackEnd; ++context_it )
+    {
+      (*context_it)->render( _renderQueue );
+    }
+
+    _renderQueue.publish();
+    _framePacer.wake();
+  }
+
+
+  void EngineManager::flushRenderQueue()
+  {
+    // The rendering thread may be waiting for the render mutex to upload the textures of the frame it is replaying,
+    // so it must be released while waiting for the replay to finish
+    _renderMutex.unlock();
+    _renderQueue.flush();
+    _renderMutex.lock();
+  }
+
+
   bool EngineManager::performStackOperations()
   {
     // Flag that we need to update the visible stack pointers
@@ -188,6 +331,8 @@ namespace Regolith
           DEBUG_LOG( "EngineManager::performStackOperations : Exchanging context group pointers" );
           if ( _currentContextGroup != nullptr )
           {
+            // The rendering thread must stop drawing the old group before it is unloaded
+            this->flushRenderQueue();
             _currentContextGroup->close();
             Manager::getInstance()->getContextManager<EngineManager>().unloadContextGroup( _currentContextGroup );
           }
@@ -242,6 +387,7 @@ namespace Regolith
           INFO_STREAM << "EngineManager::performStackOperations : FPS for previous context stack: AVG = " << _frameTimer.getAvgFPS() << " MIN = " << _frameTimer.getMinFPS() << " MAX = " << _frameTimer.getMaxFPS();
           _frameTimer.resetFPSCount();
         }
+        _framePacer.report();
       }
 
       return true;
@@ -249,12 +395,14 @@ namespace Regolith
     else // Stack is empty! Time to abandon ship
     {
       DEBUG_LOG( "EngineManager::perfornStackOperations : Context stack is empty. Closing engine." );
+      this->flushRenderQueue();
       Manager::getInstance()->getContextManager<EngineManager>().unloadContextGroup( _currentContextGroup );
       if ( _frameTimer.hasFPSMeasurement() )
       {
         INFO_STREAM << "EngineManager::performStackOperations : FPS for previous context stack: AVG = " << _frameTimer.getAvgFPS() << " MIN = " << _frameTimer.getMinFPS() << " MAX = " << _frameTimer.getMaxFPS();
         _frameTimer.resetFPSCount();
       }
+      _framePacer.report();
 
       // Reset these anyway so the rendering thread doesnt fall over.
       _visibleStackStart = _contextStack.rbegin();
@@ -372,11 +520,11 @@ namespace Regolith
     auto contextManager = Manager::getInstance()->getContextManager<EngineRenderingThreadType>();
 
     Camera& camera = Manager::getInstance()->getWindowManager<EngineRenderingThreadType>().create();
-    ContextStack::reverse_iterator& visibleStackStart = engine.visibleStackStart();
-    ContextStack::reverse_iterator& visibleStackEnd = engine.visibleStackEnd();
+    RenderQueue& renderQueue = engine.renderQueue();
+    FramePacer& framePacer = engine.framePacer();
     std::atomic<bool>& pause = engine.pause();
 
-    // Control access to the contexts
+    // Control access to the contexts. Only required to upload textures that have changed
     std::unique_lock<std::mutex> renderLock( engine.renderMutex(), std::defer_lock );
 
     // Update the thread status
@@ -384,49 +532,54 @@ namespace Regolith
 
     try
     {
-      // Before the run function has started, prioritise rendering to load first context group faster
+      // Before the run function has started, prioritise rendering to load first context group faster.
+      // Sleep whenever there is nothing to render until a group is requested or the engine starts.
       while ( pause && threadHandler.isGood() )
       {
-        contextManager.renderContextGroup( camera );
-#ifdef REGOLITH_VALGRIND_BUILD
-        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
-#endif
+        if ( ! contextManager.renderContextGroup( camera ) )
+        {
+          framePacer.waitForWork();
+        }
       }
 
 
       while ( threadHandler.isGood() )
       {
-        // Acquire the render lock to stop other threads changing the context stack while it is being rendered.
-#ifdef REGOLITH_VALGRIND_BUILD
-        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
-        renderLock.lock();
-#else
-        while( ! renderLock.try_lock() );
-#endif
-
         DEBUG_LOG( "engineRenderingThread : ------ RENDER ------" );
 
-        // Setup the rendering process
-        camera.resetRender();
+        // Take the most recent frame recorded by the engine thread
+        RenderFrame& frame = renderQueue.acquire();
 
-        // Iterate through all the visible contexts and update as necessary
-        for ( ContextStack::reverse_iterator context_it = visibleStackStart; context_it != visibleStackEnd; ++context_it )
+        // New surfaces are written during the update, so the contexts must be locked while they are uploaded
+        if ( ! frame.uploads.empty() )
         {
-          // Draw everything to the back buffer
-          (*context_it)->render( camera );
+          renderLock.lock();
+          for ( std::vector< Texture* >::iterator it = frame.uploads.begin(); it != frame.uploads.end(); ++it )
+          {
+            camera.renderTexture( **it );
+          }
+          frame.uploads.clear();
+          renderLock.unlock();
         }
 
+        // Draw everything to the back buffer without holding the contexts
+        camera.resetRender();
+        camera.replay( frame.commands );
+
+        renderQueue.release();
+
         // Blits the back buffer to the front buffer synchronised with monitor VSYNC
         camera.draw();
-
-        // Release acces to the context stack
-        renderLock.unlock();
+        framePacer.framePresented();
 
 
         DEBUG_LOG( "engineRenderingThread : ------ FRAME ------" );
 
-        contextManager.renderContextGroup( camera );
-
+        // Keep going while a context group is being rendered, otherwise sleep until the next frame is published
+        if ( ! contextManager.renderContextGroup( camera ) )
+        {
+          framePacer.waitForWork();
+        }
       }
 
     }
@@ -436,6 +589,7 @@ namespace Regolith
       {
         renderLock.unlock();
       }
+      renderQueue.release();
       threadHandler.throwError( ex );
       return;
     }
@@ -445,6 +599,7 @@ namespace Regolith
       {
         renderLock.unlock();
       }
+      renderQueue.release();
       threadHandler.throwError( ex );
       return;
     }
@@ -59,7 +59,7 @@ namespace Regolith
       RawFont raw_font = Manager::getInstance()->getDataManager<FontManager>().buildRawFont( font_name );
 
       // Test that we can load it
-      TTF_Font* ttf_font = TTF_OpenFont( raw_font.filename.c_str(), 10 );
+      TTF_Font* ttf_font = TTF_OpenFontRW( Manager::getInstance()->getDataManager<FontManager>().openFile( raw_font.filename ), 1, 10 );
       if ( ttf_font == nullptr ) // Failed to open
       {
         Exception ex( "FontManager::configure()", "Could not validate font" );
@@ -94,7 +94,7 @@ namespace Regolith
     FontSizeMap::iterator size_found = font_found->second.find( size );
     if ( size_found == font_found->second.end() )
     {
-      TTF_Font* ttf_font = TTF_OpenFont( file_found->second.filename.c_str(), size );
+      TTF_Font* ttf_font = TTF_OpenFontRW( Manager::getInstance()->getDataManager<FontManager>().openFile( file_found->second.filename ), 1, size );
 
       if ( ttf_font == nullptr ) // Failed to open
       {
@@ -253,6 +253,13 @@ namespace Regolith
   }
 
 
+  void InputManager::waitEvents( Uint32 timeout )
+  {
+    // Passing a null event leaves it in the queue for handleEvents
+    SDL_WaitEventTimeout( nullptr, timeout );
+  }
+
+
   void InputManager::registerEventRequest( Component* object, RegolithEvent event )
   {
     DEBUG_STREAM << "InputManager::registerEventRequest : Registered input request for event: " << event << " " << object;
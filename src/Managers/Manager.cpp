@@ -12,6 +12,7 @@
 #include "Regolith/Managers/WindowManager.h"
 #include "Regolith/Managers/EngineManager.h"
 #include "Regolith/Utilities/JsonValidation.h"
+#include "Regolith/Utilities/JsonCache.h"
 
 
 namespace Regolith
@@ -65,6 +66,9 @@ namespace Regolith
     INFO_LOG( "Manager::~Manager : Clearing font data" );
     _theFonts->clear();
 
+    INFO_LOG( "Manager::~Manager : Clearing data manager" );
+    _theData->clear();
+
     INFO_LOG( "Manager::~Manager : Clearing audio manager" );
     _theAudio->clear();
 
@@ -180,6 +184,12 @@ namespace Regolith
   }
 
 
+  size_t Manager::getNumberTeams() const
+  {
+    return _theCollision->getNumberTeams();
+  }
+
+
   CollisionType Manager::getCollisionType( std::string name )
   {
     return _theCollision->getCollisionType( name );
@@ -293,11 +303,31 @@ namespace Regolith
       validateJson( json_data, "game_data", JsonType::OBJECT );
       validateJson( json_data, "contexts", JsonType::OBJECT );
 
+      // Limit the total size of the json files kept parsed in the cache. Given in megabytes of file size on disk
+      if ( validateJson( json_data, "json_cache_size", JsonType::INTEGER, false ) )
+      {
+        JsonCache::getInstance().setFileSizeLimit( json_data["json_cache_size"].asUInt()*1024*1024 );
+      }
+
 
       // Load the input device configuration first so objects can register game-wide behaviours
       this->_loadInput( json_data["input_device"] );
       // Engine gets to register its events first
       _theEngine->registerEvents( *_theInput );
+
+      // Configure the simulation and frame timing. The defaults are used without an engine section
+      Json::Value engine_data( Json::objectValue );
+      if ( validateJson( json_data, "engine", JsonType::OBJECT, false ) )
+      {
+        engine_data = json_data["engine"];
+      }
+      _theEngine->configure( engine_data );
+
+      // Configure the job workers
+      if ( validateJson( json_data, "threads", JsonType::OBJECT, false ) )
+      {
+        _theThreads->configure( json_data["threads"] );
+      }
       _theHardware->registerEvents( *_theInput );
 
 
@@ -307,6 +337,7 @@ namespace Regolith
 
       // Configure the window
       this->_loadWindow( json_data["window"] );
+      _theEngine->setVSync( _theWindow->isVSync() );
 
 
       //Load all the collision data
@@ -1,6 +1,9 @@
 
 #include "Regolith/Managers/ThreadManager.h"
 #include "Regolith/Handlers/ThreadHandler.h"
+#include "Regolith/Utilities/JsonValidation.h"
+
+#include <algorithm>
 
 
 namespace Regolith
@@ -19,13 +22,19 @@ namespace Regolith
   ThreadManager::ThreadManager() :
     _contextManagerThread(),
     _engineRenderingThread(),
-    _threadStatus()
+    _threadStatus(),
+    _conditionVariables(),
+    _jobScheduler(),
+    _numberWorkers( std::max( 1u, std::thread::hardware_concurrency() ) - 1 )
   {
     GuardLock lk( _threadStatus.mutex );
     for ( char n = 0; n < REGOLITH_THREAD_TOTAL; ++n )
     {
       _threadStatus.data[ (ThreadName) n ] = THREAD_NULL;
     }
+
+    // Idle workers and threads waiting on jobs must see the error flag
+    registerCondition( _jobScheduler.getCondition() );
   }
 
 
@@ -36,6 +45,17 @@ namespace Regolith
   }
 
 
+  void ThreadManager::configure( Json::Value& json_data )
+  {
+    if ( validateJson( json_data, "job_workers", JsonType::INTEGER, false ) )
+    {
+      _numberWorkers = json_data["job_workers"].asUInt();
+    }
+
+    INFO_STREAM << "ThreadManager::configure : Using " << _numberWorkers << " job workers";
+  }
+
+
   void ThreadManager::setThreadStatus( ThreadName name, ThreadStatus status )
   {
     UniqueLock lk( _threadStatus.mutex );
@@ -117,6 +137,9 @@ namespace Regolith
 
   void ThreadManager::startAll()
   {
+    // Start the workers first so that every thread can submit jobs
+    _jobScheduler.start( _numberWorkers );
+
     _contextManagerThread = std::thread( contextManagerLoadingThread );
     _engineRenderingThread = std::thread( engineRenderingThread );
 
@@ -189,6 +212,10 @@ namespace Regolith
     _contextManagerThread.join();
     INFO_LOG( "ThreadManager::~ThreadManager : Joining engine rendering thread" );
     _engineRenderingThread.join();
+
+    // Nothing is left to submit jobs
+    INFO_LOG( "ThreadManager::~ThreadManager : Stopping job workers" );
+    _jobScheduler.stop();
   }
 
 }
@@ -0,0 +1,113 @@
+#include "Regolith/ObjectInterfaces/CollidableObject.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+
+namespace Regolith
+{
+
+  CollidableObject::CollidableObject() :
+    _worldBoundingPoints(),
+    _worldBoundingNormals(),
+    _worldHitBoxes(),
+    _worldPackedHitBoxes(),
+    _cacheValid( false ),
+    _cachePosition( 0.0 ),
+    _cacheRotation( 0.0 ),
+    _cacheFrame( nullptr ),
+    _cacheCollision( nullptr )
+  {
+  }
+
+
+  void CollidableObject::updateWorldHitBoxes()
+  {
+    const Collision& collision = this->getCollision();
+    const HitBox* frame = ( collision.size() == 0 ) ? nullptr : &(*collision.begin());
+    const Vector& pos = this->position();
+    const float rot = this->rotation();
+
+    _cacheCollision = &collision;
+
+    // Exact comparisons - any change at all must trigger a rebuild
+    if ( _cacheValid && ( frame == _cacheFrame ) && ( rot == _cacheRotation ) && ( pos.x() == _cachePosition.x() ) && ( pos.y() == _cachePosition.y() ) )
+    {
+      return;
+    }
+
+    // One set of trig calls per object per update
+    const float cos = std::cos( rot );
+    const float sin = std::sin( rot );
+
+    const BoundingBox& box = this->boundingBox();
+    for ( unsigned int i = 0; i < 4; ++i )
+    {
+      const Vector& point = box.points[i];
+      const Vector& normal = box.normals[i];
+
+      _worldBoundingPoints[i].set( pos.x() + point.x()*cos - point.y()*sin, pos.y() + point.x()*sin + point.y()*cos );
+      _worldBoundingNormals[i].set( normal.x()*cos - normal.y()*sin, normal.x()*sin + normal.y()*cos );
+    }
+
+    // Only reallocate if the active frame has changed
+    if ( frame != _cacheFrame || ! _cacheValid )
+    {
+      _worldHitBoxes.assign( collision.begin(), collision.end() );
+      _worldPackedHitBoxes.resize( _worldHitBoxes.size() );
+    }
+
+    Collision::HitBoxVector::iterator world_it = _worldHitBoxes.begin();
+    std::vector< HitBoxSoA >::iterator packed_it = _worldPackedHitBoxes.begin();
+    for ( Collision::iterator it = collision.begin(); it != collision.end(); ++it, ++world_it, ++packed_it )
+    {
+      for ( unsigned int i = 0; i < it->number; ++i )
+      {
+        const Vector& point = it->points[i];
+        world_it->points[i].set( pos.x() + point.x()*cos - point.y()*sin, pos.y() + point.x()*sin + point.y()*cos );
+      }
+
+      // Circles and capsules have fewer normals than points
+      for ( unsigned int i = 0; i < it->normals.size(); ++i )
+      {
+        const Vector& normal = it->normals[i];
+        world_it->normals[i].set( normal.x()*cos - normal.y()*sin, normal.x()*sin + normal.y()*cos );
+      }
+
+      packed_it->set( *world_it );
+    }
+
+    _cacheValid = true;
+    _cachePosition = pos;
+    _cacheRotation = rot;
+    _cacheFrame = frame;
+  }
+
+
+  void CollidableObject::findWorldHitBoxes( const Vector& lower, const Vector& upper, std::vector< size_t >& indices ) const
+  {
+    // Rotate the corners of the region back into the object's frame and take their bounds
+    const float cos = std::cos( _cacheRotation );
+    const float sin = std::sin( _cacheRotation );
+
+    const Vector corners[4] = { lower, Vector( upper.x(), lower.y() ), upper, Vector( lower.x(), upper.y() ) };
+
+    Vector local_lower( std::numeric_limits<float>::max() );
+    Vector local_upper( std::numeric_limits<float>::lowest() );
+
+    for ( unsigned int i = 0; i < 4; ++i )
+    {
+      Vector offset = corners[i] - _cachePosition;
+      Vector local( offset.x()*cos + offset.y()*sin, - offset.x()*sin + offset.y()*cos );
+
+      local_lower.x() = std::min( local_lower.x(), local.x() );
+      local_lower.y() = std::min( local_lower.y(), local.y() );
+      local_upper.x() = std::max( local_upper.x(), local.x() );
+      local_upper.y() = std::max( local_upper.y(), local.y() );
+    }
+
+    _cacheCollision->findHitBoxes( local_lower, local_upper, indices );
+  }
+
+}
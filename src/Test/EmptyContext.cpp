@@ -1,6 +1,6 @@
 
 #include "Regolith/Test/EmptyContext.h"
-#include "Regolith/GamePlay/Camera.h"
+#include "Regolith/GamePlay/RenderQueue.h"
 
 #include <cmath>
 
@@ -58,11 +58,11 @@ namespace Regolith
   }
 
 
-  void EmptyContext::renderContext( Camera& camera )
+  void EmptyContext::renderContext( RenderQueue& queue )
   {
     if ( _fading )
     {
-      camera.fillWindow( _fadeColour );
+      queue.fillWindow( _fadeColour );
     }
   }
 
@@ -46,21 +46,9 @@ namespace Regolith
       SDL_DestroyTexture( _theTexture );
     }
 
+    // The modulations are applied by the camera each time the texture is drawn
     _theTexture = t;
 
-    if ( _blendMod != SDL_BLENDMODE_NONE )
-    {
-      SDL_SetTextureBlendMode( _theTexture, _blendMod );
-    }
-    if ( _alphaMod != 255 )
-    {
-      SDL_SetTextureAlphaMod( _theTexture, _alphaMod );
-    }
-    if ( _colourMod.a != 0 )
-    {
-      SDL_SetTextureColorMod( _theTexture, _colourMod.r, _colourMod.g, _colourMod.b );
-    }
-
     _update = false;
   }
 
@@ -78,7 +66,17 @@ namespace Regolith
   void Primitive::setAlpha( Uint8 alpha )
   {
     _alphaMod = alpha;
-    SDL_SetTextureAlphaMod( _theTexture, _alphaMod );
+  }
+
+
+  SDL_Color Primitive::getColourMod()
+  {
+    // A zero alpha marks the colour modulation as unused
+    if ( _colourMod.a != 0 )
+    {
+      return { _colourMod.r, _colourMod.g, _colourMod.b, _alphaMod };
+    }
+    return { 255, 255, 255, _alphaMod };
   }
 
 
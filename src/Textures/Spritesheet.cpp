@@ -15,6 +15,7 @@ namespace Regolith
   Spritesheet::Spritesheet() :
     Texture(),
     _rawTexture( nullptr ),
+    _sourceTexture( nullptr ),
     _flipFlag( SDL_FLIP_NONE ),
     _clip( { 0, 0, 0, 0 } ),
     _rotation( 0.0 ),
@@ -31,21 +32,21 @@ namespace Regolith
   void Spritesheet::setRenderedTexture( SDL_Texture* t )
   {
     // Check and destroy if one already exists
-    if ( _rawTexture->sdl_texture != nullptr )
+    if ( _sourceTexture->sdl_texture != nullptr )
     {
-      SDL_DestroyTexture( _rawTexture->sdl_texture );
+      SDL_DestroyTexture( _sourceTexture->sdl_texture );
     }
 
-    _rawTexture->sdl_texture = t;
+    _sourceTexture->sdl_texture = t;
   }
 
 
   void Spritesheet::clearSDLTexture()
   {
-    if ( _rawTexture->sdl_texture != nullptr )
+    if ( _sourceTexture->sdl_texture != nullptr )
     {
-      SDL_DestroyTexture( _rawTexture->sdl_texture );
-      _rawTexture->sdl_texture = nullptr;
+      SDL_DestroyTexture( _sourceTexture->sdl_texture );
+      _sourceTexture->sdl_texture = nullptr;
     }
   }
 
@@ -53,8 +54,8 @@ namespace Regolith
   void Spritesheet::setFrameNumber( unsigned int num )
   {
     _currentSprite = num;
-    _clip.x = (_currentSprite % _rawTexture->columns) * _clip.w;
-    _clip.y = (_currentSprite / _rawTexture->columns) * _clip.h;
+    _clip.x = _rawTexture->x + (_currentSprite % _rawTexture->columns) * _clip.w;
+    _clip.y = _rawTexture->y + (_currentSprite / _rawTexture->columns) * _clip.h;
 
     DEBUG_STREAM << "Spritesheet::setFrameNumber : " << _currentSprite << " : " << _clip.x << ", " << _clip.y << ", " << _clip.w << ", " << _clip.h;
   }
@@ -68,6 +69,8 @@ namespace Regolith
     _rawTexture = handler.getRawTexture( texture_name );
     DEBUG_STREAM << "Spritesheet::configure : Found texture: " << texture_name << " : " << _rawTexture;
 
+    _sourceTexture = ( _rawTexture->atlas != nullptr ) ? _rawTexture->atlas : _rawTexture;
+
     _clip.x = 0;
     _clip.y = 0;
     _clip.w = _rawTexture->width / _rawTexture->columns;
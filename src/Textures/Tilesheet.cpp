@@ -77,6 +77,9 @@ namespace Regolith
 
     SDL_Rect src_rect = { 0, 0, (_rawTexture->width / _rawTexture->columns), (_rawTexture->height / _rawTexture->rows) };
 
+    // Tiles packed into an atlas are read from the atlas surface
+    SDL_Surface* source_surface = ( _rawTexture->atlas != nullptr ) ? _rawTexture->atlas->surface : _rawTexture->surface;
+
     SDL_Rect dst_rect = { 0, 0, width, height };
 
     _tiledSurface = SDL_CreateRGBSurface( 0, the_tiles.getWidth(), the_tiles.getHeight(), REGOLITH_PIXEL_DEPTH, REGOLITH_R_MASK, REGOLITH_G_MASK, REGOLITH_B_MASK, REGOLITH_A_MASK );
@@ -101,15 +104,15 @@ namespace Regolith
         {
           num -= 1; // Now the index for the texture cell
 
-          src_rect.x = (num % _rawTexture->columns) * src_rect.w;
-          src_rect.y = (num / _rawTexture->columns) * src_rect.h;
+          src_rect.x = _rawTexture->x + (num % _rawTexture->columns) * src_rect.w;
+          src_rect.y = _rawTexture->y + (num / _rawTexture->columns) * src_rect.h;
 
           dst_rect.x = width*col;
           dst_rect.y = height*row;
 
           DEBUG_STREAM << "Tilesheet::configure : Blitting: " << src_rect.x << ", " << src_rect.y << ", " << src_rect.w << ", " << src_rect.h << "  ==>  " << dst_rect.x << ", " << dst_rect.y << ", " << dst_rect.w << ", " << dst_rect.h;
           
-          SDL_BlitSurface( _rawTexture->surface, &src_rect, _tiledSurface, &dst_rect );
+          SDL_BlitSurface( source_surface, &src_rect, _tiledSurface, &dst_rect );
         }
       }
     }
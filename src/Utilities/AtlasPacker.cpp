@@ -0,0 +1,155 @@
+
+#include "Regolith/Utilities/AtlasPacker.h"
+
+#include <algorithm>
+
+
+namespace Regolith
+{
+
+  AtlasPacker::AtlasPacker( int width, int height, int padding ) :
+    _width( width ),
+    _height( height ),
+    _padding( padding ),
+    _skyline(),
+    _usedArea( 0 )
+  {
+    reset();
+  }
+
+
+  AtlasPacker::~AtlasPacker()
+  {
+  }
+
+
+  void AtlasPacker::reset()
+  {
+    _skyline.clear();
+    _skyline.push_back( { 0, 0, _width } );
+    _usedArea = 0;
+  }
+
+
+  int AtlasPacker::_fit( size_t index, int width, int height ) const
+  {
+    int x = _skyline[index].x;
+    if ( x + width > _width ) return -1;
+
+    // The rectangle rests on the highest segment it spans
+    int y = 0;
+    int remaining = width;
+    while ( remaining > 0 )
+    {
+      if ( index >= _skyline.size() ) return -1;
+
+      if ( _skyline[index].y > y ) y = _skyline[index].y;
+      remaining -= _skyline[index].width;
+      ++index;
+    }
+
+    if ( y + height > _height ) return -1;
+
+    return y;
+  }
+
+
+  void AtlasPacker::_place( size_t index, int y, int width, int height )
+  {
+    Segment new_segment = { _skyline[index].x, y + height, width };
+    int right = new_segment.x + width;
+
+    _skyline.insert( _skyline.begin() + index, new_segment );
+
+    // Trim or remove the segments that are now underneath
+    size_t next = index + 1;
+    while ( next < _skyline.size() && _skyline[next].x < right )
+    {
+      int overlap = right - _skyline[next].x;
+      if ( overlap >= _skyline[next].width )
+      {
+        _skyline.erase( _skyline.begin() + next );
+      }
+      else
+      {
+        _skyline[next].x += overlap;
+        _skyline[next].width -= overlap;
+        break;
+      }
+    }
+
+    // Merge neighbours at the same height
+    for ( size_t i = 0; i + 1 < _skyline.size(); )
+    {
+      if ( _skyline[i].y == _skyline[i+1].y )
+      {
+        _skyline[i].width += _skyline[i+1].width;
+        _skyline.erase( _skyline.begin() + i + 1 );
+      }
+      else
+      {
+        ++i;
+      }
+    }
+  }
+
+
+  bool AtlasPacker::insert( int width, int height, SDL_Point& position )
+  {
+    if ( width <= 0 || height <= 0 ) return false;
+
+    // Reserve the padding on the right and bottom edges, where it fits inside the atlas
+    int padded_width = width + _padding;
+    int padded_height = height + _padding;
+
+    int best_index = -1;
+    int best_y = _height;
+    int best_width = _width + 1;
+
+    for ( size_t i = 0; i < _skyline.size(); ++i )
+    {
+      if ( _skyline[i].x + width > _width ) break;
+
+      int y = _fit( i, std::min( padded_width, _width - _skyline[i].x ), height );
+      if ( y < 0 ) continue;
+
+      if ( y < best_y || ( y == best_y && _skyline[i].width < best_width ) )
+      {
+        best_index = i;
+        best_y = y;
+        best_width = _skyline[i].width;
+      }
+    }
+
+    if ( best_index < 0 ) return false;
+
+    position.x = _skyline[best_index].x;
+    position.y = best_y;
+
+    int placed_width = std::min( padded_width, _width - position.x );
+    int placed_height = std::min( padded_height, _height - position.y );
+    _place( best_index, best_y, placed_width, placed_height );
+
+    _usedArea += (long)width * height;
+    return true;
+  }
+
+
+  int AtlasPacker::getUsedHeight() const
+  {
+    int height = 0;
+    for ( Skyline::const_iterator it = _skyline.begin(); it != _skyline.end(); ++it )
+    {
+      if ( it->y > height ) height = it->y;
+    }
+    return ( height > _height ) ? _height : height;
+  }
+
+
+  float AtlasPacker::getOccupancy() const
+  {
+    return (float)_usedArea / ( (float)_width * _height );
+  }
+
+}
+
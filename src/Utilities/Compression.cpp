@@ -0,0 +1,184 @@
+
+#include "Regolith/Utilities/Compression.h"
+
+#include <cstring>
+
+
+namespace Regolith
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Format constants
+
+  // Shortest match that can be encoded
+  static const size_t lz4_min_match = 4;
+
+  // The last bytes of a block are always literals
+  static const size_t lz4_last_literals = 5;
+
+  // The last match must start this far before the end of the block
+  static const size_t lz4_match_limit = 12;
+
+  // Largest distance a match can refer back to
+  static const size_t lz4_max_offset = 65535;
+
+  // Number of bits in the hash of the next four bytes
+  static const unsigned int lz4_hash_bits = 16;
+
+
+  static uint32_t readSequence( const unsigned char* data )
+  {
+    uint32_t value;
+    std::memcpy( &value, data, sizeof( value ) );
+    return value;
+  }
+
+
+  static void writeLength( std::vector< unsigned char >& output, size_t length )
+  {
+    while ( length >= 255 )
+    {
+      output.push_back( 255 );
+      length -= 255;
+    }
+    output.push_back( (unsigned char) length );
+  }
+
+
+  static bool readLength( const unsigned char* source, size_t size, size_t& position, size_t& length )
+  {
+    unsigned char byte;
+    do
+    {
+      if ( position >= size ) return false;
+      byte = source[ position++ ];
+      length += byte;
+    }
+    while ( byte == 255 );
+
+    return true;
+  }
+
+
+  // Write the literals since the last match, followed by a match. A match length of zero ends the block
+  static void writeSequence( std::vector< unsigned char >& output, const unsigned char* literals, size_t literal_length, size_t offset, size_t match_length )
+  {
+    size_t token_position = output.size();
+    output.push_back( 0 );
+
+    unsigned char literal_token = ( literal_length >= 15 ) ? 15 : literal_length;
+    if ( literal_length >= 15 ) writeLength( output, literal_length - 15 );
+    output.insert( output.end(), literals, literals + literal_length );
+
+    unsigned char match_token = 0;
+    if ( match_length > 0 )
+    {
+      output.push_back( offset & 0xff );
+      output.push_back( ( offset >> 8 ) & 0xff );
+
+      size_t extra = match_length - lz4_min_match;
+      match_token = ( extra >= 15 ) ? 15 : extra;
+      if ( extra >= 15 ) writeLength( output, extra - 15 );
+    }
+
+    output[ token_position ] = ( literal_token << 4 ) | match_token;
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Compression
+
+  size_t compressLZ4( const unsigned char* source, size_t size, std::vector< unsigned char >& output )
+  {
+    output.clear();
+    output.reserve( size + ( size / 255 ) + 16 );
+
+    size_t anchor = 0;
+
+    if ( size > lz4_match_limit )
+    {
+      // Most recent position of each hashed sequence, offset by one so that zero is empty
+      std::vector< size_t > table( 1 << lz4_hash_bits, 0 );
+
+      size_t last_start = size - lz4_match_limit;
+      size_t last_end = size - lz4_last_literals;
+      size_t position = 0;
+
+      while ( position <= last_start )
+      {
+        uint32_t sequence = readSequence( source + position );
+        uint32_t hash = ( sequence * 2654435761u ) >> ( 32 - lz4_hash_bits );
+        size_t candidate = table[ hash ];
+        table[ hash ] = position + 1;
+
+        if ( candidate == 0 || ( position - ( candidate - 1 ) ) > lz4_max_offset || readSequence( source + candidate - 1 ) != sequence )
+        {
+          ++position;
+          continue;
+        }
+        --candidate;
+
+        size_t length = lz4_min_match;
+        while ( ( position + length < last_end ) && ( source[ candidate + length ] == source[ position + length ] ) )
+        {
+          ++length;
+        }
+
+        writeSequence( output, source + anchor, position - anchor, position - candidate, length );
+        position += length;
+        anchor = position;
+      }
+    }
+
+    writeSequence( output, source + anchor, size - anchor, 0, 0 );
+    return output.size();
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Decompression
+
+  bool decompressLZ4( const unsigned char* source, size_t size, unsigned char* destination, size_t destination_size )
+  {
+    size_t input = 0;
+    size_t output = 0;
+
+    while ( input < size )
+    {
+      unsigned char token = source[ input++ ];
+
+      size_t literal_length = token >> 4;
+      if ( literal_length == 15 && ! readLength( source, size, input, literal_length ) ) return false;
+
+      if ( ( literal_length > size - input ) || ( literal_length > destination_size - output ) ) return false;
+      if ( literal_length > 0 ) std::memcpy( destination + output, source + input, literal_length );
+      input += literal_length;
+      output += literal_length;
+
+      // The last sequence has no match
+      if ( input == size ) break;
+
+      if ( size - input < 2 ) return false;
+      size_t offset = source[ input ] | ( source[ input + 1 ] << 8 );
+      input += 2;
+      if ( offset == 0 || offset > output ) return false;
+
+      size_t match_length = token & 0x0f;
+      if ( match_length == 15 && ! readLength( source, size, input, match_length ) ) return false;
+      match_length += lz4_min_match;
+      if ( match_length > destination_size - output ) return false;
+
+      // Matches may overlap the bytes they produce, so copy one at a time
+      const unsigned char* match = destination + output - offset;
+      for ( size_t i = 0; i < match_length; ++i )
+      {
+        destination[ output + i ] = match[ i ];
+      }
+      output += match_length;
+    }
+
+    return output == destination_size;
+  }
+
+}
+
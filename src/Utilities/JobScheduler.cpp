@@ -0,0 +1,339 @@
+
+#include "Regolith/Utilities/JobScheduler.h"
+#include "Regolith/Managers/ThreadManager.h"
+
+#include <algorithm>
+
+
+namespace Regolith
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Job definition
+
+  struct JobScheduler::Job
+  {
+    Task task;
+
+    // Job that must wait for this one to finish
+    Job* parent;
+
+    // One for the job's own task plus one for each unfinished child
+    std::atomic< unsigned int > unfinished;
+
+    // First exception thrown anywhere in the tree. Only used by root jobs
+    std::exception_ptr exception;
+
+    Job( Task t, Job* p ) : task( t ), parent( p ), unfinished( 1 ), exception() {}
+  };
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Identify the worker threads
+
+  static thread_local const JobScheduler* current_scheduler = nullptr;
+  static thread_local unsigned int current_worker = 0;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Job scheduler member functions
+
+  JobScheduler::JobScheduler() :
+    _threads(),
+    _queues(),
+    _shared(),
+    _queued( 0 ),
+    _sleepMutex(),
+    _sleepCondition(),
+    _exceptionMutex(),
+    _quit( false )
+  {
+  }
+
+
+  JobScheduler::~JobScheduler()
+  {
+    stop();
+  }
+
+
+  void JobScheduler::start( unsigned int number )
+  {
+    if ( ! _threads.empty() )
+    {
+      Exception ex( "JobScheduler::start()", "Job scheduler is already running" );
+      ex.addDetail( "Workers", _threads.size() );
+      throw ex;
+    }
+
+    _quit = false;
+
+    for ( unsigned int i = 0; i < number; ++i )
+    {
+      _queues.push_back( new WorkerQueue() );
+    }
+
+    for ( unsigned int i = 0; i < number; ++i )
+    {
+      _threads.push_back( std::thread( &JobScheduler::work, this, i ) );
+    }
+
+    INFO_STREAM << "JobScheduler::start : Started " << number << " workers";
+  }
+
+
+  void JobScheduler::stop()
+  {
+    if ( _threads.empty() ) return;
+
+    _quit = true;
+    notify( true );
+
+    for ( std::vector< std::thread >::iterator it = _threads.begin(); it != _threads.end(); ++it )
+    {
+      it->join();
+    }
+    _threads.clear();
+
+    // Anything left in the worker queues is moved to the shared queue so a later wait can still execute it
+    for ( std::vector< WorkerQueue* >::iterator it = _queues.begin(); it != _queues.end(); ++it )
+    {
+      _shared.jobs.insert( _shared.jobs.end(), (*it)->jobs.begin(), (*it)->jobs.end() );
+      delete (*it);
+    }
+    _queues.clear();
+
+    INFO_LOG( "JobScheduler::stop : Workers stopped" );
+  }
+
+
+  void JobScheduler::work( unsigned int index )
+  {
+    current_scheduler = this;
+    current_worker = index;
+
+    while ( true )
+    {
+      Job* job = ( ThreadManager::ErrorFlag ? nullptr : findJob( index ) );
+
+      if ( job != nullptr )
+      {
+        execute( job );
+        continue;
+      }
+
+      UniqueLock lock( _sleepMutex );
+      _sleepCondition.wait( lock, [&]()->bool{ return _quit || ( _queued > 0 && ! ThreadManager::ErrorFlag ); } );
+
+      if ( _quit ) return;
+    }
+  }
+
+
+  JobScheduler::Job* JobScheduler::findJob( unsigned int index )
+  {
+    if ( _queued == 0 ) return nullptr;
+
+    Job* job = nullptr;
+    unsigned int number = _queues.size();
+
+    // Newest job from our own queue first
+    if ( index < number )
+    {
+      WorkerQueue& queue = *_queues[index];
+      GuardLock lock( queue.mutex );
+      if ( ! queue.jobs.empty() )
+      {
+        job = queue.jobs.back();
+        queue.jobs.pop_back();
+      }
+    }
+
+    // Then the oldest job from the shared queue
+    if ( job == nullptr )
+    {
+      GuardLock lock( _shared.mutex );
+      if ( ! _shared.jobs.empty() )
+      {
+        job = _shared.jobs.front();
+        _shared.jobs.pop_front();
+      }
+    }
+
+    // Then steal the oldest job from another worker
+    for ( unsigned int i = 1; ( job == nullptr ) && ( i <= number ); ++i )
+    {
+      unsigned int victim = ( index + i ) % number;
+      if ( victim == index ) continue;
+
+      WorkerQueue& queue = *_queues[victim];
+      GuardLock lock( queue.mutex );
+      if ( ! queue.jobs.empty() )
+      {
+        job = queue.jobs.front();
+        queue.jobs.pop_front();
+      }
+    }
+
+    if ( job != nullptr ) --_queued;
+    return job;
+  }
+
+
+  void JobScheduler::execute( Job* job )
+  {
+    try
+    {
+      job->task();
+    }
+    catch ( ... )
+    {
+      // The root can't finish until this job has, so it is still safe to use
+      Job* root = job;
+      while ( root->parent != nullptr ) root = root->parent;
+
+      GuardLock lock( _exceptionMutex );
+      if ( ! root->exception ) root->exception = std::current_exception();
+    }
+
+    finish( job );
+  }
+
+
+  void JobScheduler::finish( Job* job )
+  {
+    while ( job != nullptr )
+    {
+      Job* parent = job->parent;
+
+      if ( --job->unfinished > 0 ) return;
+
+      // Finished roots belong to the waiting thread. Don't touch it again.
+      if ( parent == nullptr )
+      {
+        notify( true );
+        return;
+      }
+
+      delete job;
+      job = parent;
+    }
+  }
+
+
+  unsigned int JobScheduler::workerIndex() const
+  {
+    return ( current_scheduler == this ) ? current_worker : _queues.size();
+  }
+
+
+  void JobScheduler::notify( bool all )
+  {
+    // Take the lock so a thread can't miss the notification between checking its condition and sleeping
+    {
+      GuardLock lock( _sleepMutex );
+    }
+
+    if ( all )
+    {
+      _sleepCondition.notify_all();
+    }
+    else
+    {
+      _sleepCondition.notify_one();
+    }
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Job interface
+
+  JobScheduler::Job* JobScheduler::create( Task task, Job* parent )
+  {
+    if ( parent != nullptr )
+    {
+      ++parent->unfinished;
+    }
+
+    return new Job( task, parent );
+  }
+
+
+  void JobScheduler::submit( Job* job )
+  {
+    unsigned int index = workerIndex();
+    WorkerQueue& queue = ( index < _queues.size() ) ? *_queues[index] : _shared;
+
+    // Count the job before publishing it, so a thread that takes it straight away can't decrement the count below zero
+    ++_queued;
+    {
+      GuardLock lock( queue.mutex );
+      queue.jobs.push_back( job );
+    }
+
+    // After an error only the waiting threads take jobs, so make sure one of them sees it
+    notify( ThreadManager::ErrorFlag );
+  }
+
+
+  void JobScheduler::wait( Job* root )
+  {
+    if ( root->parent != nullptr )
+    {
+      Exception ex( "JobScheduler::wait()", "Only root jobs can be waited on" );
+      throw ex;
+    }
+
+    unsigned int index = workerIndex();
+
+    while ( root->unfinished > 0 )
+    {
+      // Help rather than block
+      Job* job = findJob( index );
+      if ( job != nullptr )
+      {
+        // The workers have stopped taking jobs, so the queued ones are discarded. Jobs that are already executing
+        // may be using the caller's data and must still be waited for.
+        if ( ThreadManager::ErrorFlag )
+        {
+          finish( job );
+        }
+        else
+        {
+          execute( job );
+        }
+        continue;
+      }
+
+      UniqueLock lock( _sleepMutex );
+      _sleepCondition.wait( lock, [&]()->bool{ return ( root->unfinished == 0 ) || ( _queued > 0 ); } );
+    }
+
+    std::exception_ptr exception = root->exception;
+    delete root;
+
+    if ( exception ) std::rethrow_exception( exception );
+  }
+
+
+  void JobScheduler::parallelFor( size_t number, size_t grain, RangeTask task )
+  {
+    if ( number == 0 ) return;
+    if ( grain == 0 ) grain = 1;
+
+    // The root has no work of its own. It only collects the blocks
+    Job* root = create( [](){} );
+    const RangeTask* range = &task;
+
+    for ( size_t start = 0; start < number; start += grain )
+    {
+      size_t end = std::min( number, start + grain );
+      submit( create( [range, start, end](){ (*range)( start, end ); }, root ) );
+    }
+
+    finish( root );
+    wait( root );
+  }
+
+}
+
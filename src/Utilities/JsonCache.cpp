@@ -0,0 +1,222 @@
+
+#include "Regolith/Utilities/JsonCache.h"
+
+#include <fstream>
+
+
+namespace Regolith
+{
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Owner of the documents loaded by each thread
+
+  static thread_local const void* current_owner = nullptr;
+
+
+  JsonCache::Scope::Scope( const void* owner ) :
+    _previous( current_owner )
+  {
+    current_owner = owner;
+  }
+
+
+  JsonCache::Scope::~Scope()
+  {
+    current_owner = _previous;
+  }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Json cache member functions
+
+  JsonCache::JsonCache() :
+    _mutex(),
+    _documents(),
+    _recent(),
+    _fileSizeLimit( 32*1024*1024 ),
+    _fileSizeUsed( 0 ),
+    _hits( 0 ),
+    _misses( 0 )
+  {
+  }
+
+
+  JsonCache::~JsonCache()
+  {
+  }
+
+
+  JsonCache& JsonCache::getInstance()
+  {
+    static JsonCache instance;
+    return instance;
+  }
+
+
+  long long JsonCache::modificationTime( const struct stat& file_status )
+  {
+#ifdef __linux__
+    return (long long)file_status.st_mtim.tv_sec * 1000000000 + file_status.st_mtim.tv_nsec;
+#else
+    return (long long)file_status.st_mtime * 1000000000;
+#endif
+  }
+
+
+  bool JsonCache::parse( Json::Value& json_data, const std::string& filename )
+  {
+    std::ifstream input( filename );
+    Json::CharReaderBuilder reader_builder;
+    std::string errors;
+    bool result = Json::parseFromStream( reader_builder, input, &json_data, &errors );
+    if ( ! result )
+    {
+      ERROR_STREAM << "JsonCache::parse : Found errors parsing json file: " << filename;
+      ERROR_STREAM << errors;
+    }
+    return result;
+  }
+
+
+  void JsonCache::erase( DocumentMap::iterator it )
+  {
+    _fileSizeUsed -= it->second.size;
+    _recent.erase( it->second.recent );
+    _documents.erase( it );
+  }
+
+
+  void JsonCache::load( Json::Value& json_data, const std::string& filename )
+  {
+    struct stat file_status;
+    bool cacheable = ( stat( filename.c_str(), &file_status ) == 0 );
+
+    {
+      GuardLock lock( _mutex );
+
+      DocumentMap::iterator found = _documents.find( filename );
+      if ( found != _documents.end() )
+      {
+        Document& document = found->second;
+        if ( cacheable && ( document.modified == modificationTime( file_status ) ) && ( document.size == (size_t)file_status.st_size ) )
+        {
+          DEBUG_STREAM << "JsonCache::load : Using cached Json File: " << filename;
+          ++_hits;
+
+          json_data = document.data;
+          if ( current_owner != nullptr ) document.owners.insert( current_owner );
+          _recent.splice( _recent.begin(), _recent, document.recent );
+          return;
+        }
+
+        // The file has changed since it was cached
+        erase( found );
+      }
+
+      ++_misses;
+    }
+
+    // Parse without holding the lock so other threads can still use the cache
+    INFO_STREAM << "JsonCache::load : Loading Json File: " << filename;
+    if ( ( ! parse( json_data, filename ) ) || ( ! cacheable ) ) return;
+
+    size_t size = file_status.st_size;
+
+    GuardLock lock( _mutex );
+    if ( size > _fileSizeLimit ) return;
+
+    // Another thread may have loaded the same file in the mean time
+    DocumentMap::iterator found = _documents.find( filename );
+    if ( found != _documents.end() ) erase( found );
+
+    // Make room by discarding the least recently used documents
+    while ( _fileSizeUsed + size > _fileSizeLimit )
+    {
+      DEBUG_STREAM << "JsonCache::load : Discarding Json File: " << _recent.back();
+      erase( _documents.find( _recent.back() ) );
+    }
+
+    _recent.push_front( filename );
+
+    Document& document = _documents[ filename ];
+    document.data = json_data;
+    document.modified = modificationTime( file_status );
+    document.size = size;
+    document.recent = _recent.begin();
+    if ( current_owner != nullptr ) document.owners.insert( current_owner );
+
+    _fileSizeUsed += size;
+  }
+
+
+  void JsonCache::invalidate( const void* owner )
+  {
+    GuardLock lock( _mutex );
+
+    unsigned int count = 0;
+    DocumentMap::iterator it = _documents.begin();
+    while ( it != _documents.end() )
+    {
+      DocumentMap::iterator current = it++;
+
+      if ( current->second.owners.erase( owner ) > 0 && current->second.owners.empty() )
+      {
+        erase( current );
+        ++count;
+      }
+    }
+
+    DEBUG_STREAM << "JsonCache::invalidate : Dropped " << count << " documents. " << _documents.size() << " remaining, " << _fileSizeUsed << " bytes";
+  }
+
+
+  void JsonCache::clear()
+  {
+    GuardLock lock( _mutex );
+    _documents.clear();
+    _recent.clear();
+    _fileSizeUsed = 0;
+  }
+
+
+  void JsonCache::setFileSizeLimit( size_t limit )
+  {
+    GuardLock lock( _mutex );
+    _fileSizeLimit = limit;
+
+    while ( _fileSizeUsed > _fileSizeLimit )
+    {
+      erase( _documents.find( _recent.back() ) );
+    }
+  }
+
+
+  size_t JsonCache::getFileSizeUsed() const
+  {
+    GuardLock lock( _mutex );
+    return _fileSizeUsed;
+  }
+
+
+  size_t JsonCache::size() const
+  {
+    GuardLock lock( _mutex );
+    return _documents.size();
+  }
+
+
+  unsigned long JsonCache::getHits() const
+  {
+    GuardLock lock( _mutex );
+    return _hits;
+  }
+
+
+  unsigned long JsonCache::getMisses() const
+  {
+    GuardLock lock( _mutex );
+    return _misses;
+  }
+
+}
+
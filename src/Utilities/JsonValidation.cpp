@@ -1,5 +1,6 @@
 
 #include "Regolith/Utilities/JsonValidation.h"
+#include "Regolith/Utilities/JsonCache.h"
 
 
 namespace Regolith
@@ -202,18 +203,8 @@ namespace Regolith
 
   void loadJsonData( Json::Value& json_data, std::string filename )
   {
-    INFO_STREAM << "Utilities::loadJsonData : Loading Json File: " << filename;
-    std::ifstream input( filename );
-    Json::CharReaderBuilder reader_builder;
-    Json::CharReader* reader = reader_builder.newCharReader();
-    std::string errors;
-    bool result = Json::parseFromStream( reader_builder, input, &json_data, &errors );
-    if ( ! result )
-    {
-      ERROR_STREAM << "Utilties::loadJsonData() : Found errors parsing json file: " << filename;
-      ERROR_STREAM << errors;
-    }
-    delete reader;
+    // Unchanged files are only parsed once
+    JsonCache::getInstance().load( json_data, filename );
   }
 
 }
@@ -42,6 +42,11 @@ namespace Regolith
     _tileWidth = json_data["tile_width"].asInt();
     _tileHeight = json_data["tile_height"].asInt();
 
+    if ( validateJson( json_data, "optimize_hitboxes", JsonType::BOOLEAN, false ) )
+    {
+      _optimize = json_data["optimize_hitboxes"].asBool();
+    }
+
     Json::Value& matrix_data = json_data["tile_matrix"];
     _numRows = matrix_data.size();
     _numCols = matrix_data[0].size();